@@ -52,7 +52,7 @@
 #define configMINIMAL_STACK_SIZE                     90
 #define configTOTAL_HEAP_SIZE                        ( ( size_t ) ( 8 * 1024 ) )    /* 85 Kbytes. */
 #define configMAX_TASK_NAME_LEN                      ( 16 )
-#define configUSE_TRACE_FACILITY                     0
+#define configUSE_TRACE_FACILITY                     1
 #define configUSE_16_BIT_TICKS                       0
 #define configIDLE_SHOULD_YIELD                      1
 #define configUSE_MUTEXES                            0
@@ -96,7 +96,7 @@
 #define INCLUDE_vTaskDelete                          0
 #define INCLUDE_vTaskCleanUpResources                0
 #define INCLUDE_vTaskSuspend                         0
-#define INCLUDE_vTaskDelayUntil                      0
+#define INCLUDE_vTaskDelayUntil                      1
 #define INCLUDE_vTaskDelay                           0
 #define INCLUDE_xTaskGetSchedulerState               0
 #define INCLUDE_xTimerPendFunctionCall               0
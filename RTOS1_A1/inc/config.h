@@ -11,8 +11,6 @@
 #define PRINTF_CONFIGURE
 #define PRINTF(...)             printf(__VA_ARGS__)
 
-#define CUENTAS_1MS             9251
-
 #define HACER_FALLAR            0
 
 #endif
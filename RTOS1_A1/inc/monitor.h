@@ -0,0 +1,79 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef MONITOR_H_
+#define MONITOR_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/*==================[definiciones y macros]==================================*/
+#define MONITOR_MAX_TASKS           8                           // tareas que se siguen
+#define MONITOR_MAX_QUEUES          configQUEUE_REGISTRY_SIZE   // colas registradas con monitor_register_queue
+#define MONITOR_PERIOD_MS           100                         // muestreo de stacks, heap y colas
+#define MONITOR_REPORT_PERIODS      50                          // informe cada MONITOR_REPORT_PERIODS muestreos (5 s)
+
+// umbrales de alarma
+#define MONITOR_STACK_ALARM_WORDS   16                          // stack libre minimo de una tarea
+#define MONITOR_HEAP_ALARM_BYTES    512                         // heap libre minimo
+#define MONITOR_QUEUE_ALARM_PCT     90                          // ocupacion maxima de una cola
+
+// dimensionamiento: stack usado + margen, redondeado a multiplos de 8 words
+#define MONITOR_STACK_MARGIN_PCT    25
+
+/*==================[tipos de datos]=========================================*/
+typedef struct
+{
+    TaskHandle_t handle;
+    const char*  name;
+    uint32_t     depth;         // stack con que se creo la tarea (words), 0 si no se registro
+    uint32_t     min_free;      // minimo de stack libre visto (words)
+    bool_t       alarm;         // la alarma de stack ya se informo
+} t_monitor_task;
+
+typedef struct
+{
+    QueueHandle_t queue;
+    const char*   name;
+    UBaseType_t   length;
+    UBaseType_t   max_used;     // maximo de mensajes visto en un muestreo
+    bool_t        alarm;
+} t_monitor_queue;
+
+/*==================[prototipos de funciones]================================*/
+void monitor_Init( void );
+void monitor_register_task( TaskHandle_t task, uint32_t depth );
+void monitor_register_queue( QueueHandle_t queue, const char* name );
+void monitor_report( void );
+
+#endif /* MONITOR_H_ */
@@ -36,6 +36,8 @@
 #include "FreeRTOSConfig.h"
 #include "config.h"
 #include "task.h"
+#include "monitor.h"
+#include "cpu_load.h"
 #include <stdio.h>
 /*==================[definiciones y macros]==================================*/
 
@@ -48,12 +50,11 @@ print_t debugPrint;
 /*==================[declaraciones de funciones internas]====================*/
 
 /*==================[declaraciones de funciones externas]====================*/
-TaskHandle_t task_handles[3]; //variable para trabajar con las tareas
+TaskHandle_t task_handles[2]; //variable para trabajar con las tareas
 
 // Prototipo de funcion de la tarea
 void Tarea1_Code( void*  );
 void Tarea2_Code( void*  );
-void Tarea_Monitor_Code( void*  );
 
 /*==================[funcion principal]======================================*/
 
@@ -64,6 +65,8 @@ int main( void )
     PRINTF_CONFIGURE;
     PRINTF( EXAMPLE_WELCOME_TEXT );
 
+    cpu_load_Init();                    // calibra la carga de CPU de las tareas
+
     // Crear tarea en freeRTOS
     BaseType_t res1 =
         xTaskCreate(
@@ -87,20 +90,13 @@ int main( void )
             &task_handles[1]            // Puntero a la tarea creada en el sistema
         );
 
-    BaseType_t res3=
-        xTaskCreate(
-            Tarea_Monitor_Code,         // Funcion de la tarea a ejecutar
-            ( const char * )"monitor",  // Nombre de la tarea como String amigable para el usuario
-            configMINIMAL_STACK_SIZE*4, /* tamaño del stack de cada tarea (words) */
-            NULL,                       // Parametros de tarea
-            tskIDLE_PRIORITY+1,         // Prioridad de la tarea
-            &task_handles[2]            // Puntero a la tarea creada en el sistema
-        );
-
-
-
     configASSERT( res1 == pdPASS && res2 == pdPASS ); //entra si no se pudieron crear las tareas, para debug
 
+    /* el monitor recorre todas las tareas: solo necesita saber con que stack se crearon */
+    monitor_register_task( task_handles[0], configMINIMAL_STACK_SIZE*2 );
+    monitor_register_task( task_handles[1], configMINIMAL_STACK_SIZE*2 );
+    monitor_Init();
+
 
     // Iniciar scheduler
     vTaskStartScheduler(); //acá arranca el SO
@@ -119,26 +115,6 @@ int main( void )
 
 /*==================[definiciones de funciones internas]=====================*/
 
-/**
-   @brief   Implementacion de un delay utilizando ciclos for.
-            Se implementa solo para generar utilizacion de CPU sin bloquear a la tarea.
-            NO DEBE UTILIZARSE BAJO NINGUN PUNTO DE VISTA EN UN APLICACION REAL SOBRE UN RTOS.
-   @param cuentas
- */
-void delay_con_for( uint32_t ms )
-{
-    volatile uint32_t i;
-    volatile uint32_t j;
-
-    for( i=0 ; i<ms ; i++ )
-    {
-        /* delay de aprox 1 ms */
-        for( j=0 ; j<CUENTAS_1MS ; j++ )
-        {
-        }
-    }
-}
-
 /*==================[definiciones de funciones externas]=====================*/
 
 void Tarea1_Code( void* taskParmPtr ) //taskParmPtr es el parametro que se pasa en la creación de la tarea
@@ -147,7 +123,7 @@ void Tarea1_Code( void* taskParmPtr ) //taskParmPtr es el parametro que se pasa
 
     while( 1 )
     {
-        delay_con_for( 200 );
+        cpu_load_busy_ms( 200 );
         //PRINTF( "Blink %u at %u ms!\r\n", 1 , xTaskGetTickCount() );
         gpioToggle( LEDR );
     }
@@ -163,7 +139,7 @@ void Tarea2_Code( void* taskParmPtr )
 
     while( 1 )
     {
-        delay_con_for( 500 );
+        cpu_load_busy_ms( 500 );
         PRINTF( "Prende led 2\r\n" );
         //PRINTF( "Blink %u at %u ms!\r\n", 2 , xTaskGetTickCount() );
         gpioToggle( LEDB );
@@ -174,19 +150,5 @@ void Tarea2_Code( void* taskParmPtr )
     }
 }
 
-void Tarea_Monitor_Code( void* taskParmPtr )
-{
-    PRINTF( "Tarea 3\r\n" );
-
-    while( 1 )
-    {
-        delay_con_for( 1000 );
-
-        PRINTF( "Task %u min %u words\r\n", 1,  uxTaskGetStackHighWaterMark( task_handles[0] ) );
-        PRINTF( " Task %u min %u words\r\n", 2,  uxTaskGetStackHighWaterMark( task_handles[1] ) );
-        PRINTF( " Task %u min %u words\r\n", 3,  uxTaskGetStackHighWaterMark( task_handles[2] ) );
-    }
-}
-
 
 /*==================[fin del archivo]========================================*/
@@ -0,0 +1,185 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[inlcusiones]============================================*/
+#include "FreeRTOS.h"
+#include "cpu_load.h"
+#include "sapi.h"
+
+/*==================[definiciones y macros]==================================*/
+#define MEM_WORDS       256     // 1 KB: entra en la SRAM local, sin esperas de bus
+#define MEM_STRIDE      17      // recorrido no secuencial para que no se colapse en un memset
+
+/*==================[definiciones de datos internos]=========================*/
+typedef void ( *t_kernel )( uint32_t iters );
+
+static void kernel_alu( uint32_t iters );
+static void kernel_mem( uint32_t iters );
+static void kernel_fpu( uint32_t iters );
+
+static const t_kernel kernels[CPU_LOAD_PROFILES] =
+{
+    kernel_alu,
+    kernel_mem,
+    kernel_fpu,
+};
+
+/* ciclos por iteracion de cada perfil, en punto fijo x256 */
+static uint32_t iter_cycles_x256[CPU_LOAD_PROFILES];
+static uint32_t cycles_per_us;
+
+static volatile uint32_t mem_buf[MEM_WORDS];
+
+/* los resultados se guardan aca para que el compilador no elimine los lazos */
+static volatile uint32_t sink_u32;
+static volatile float    sink_f32;
+
+/*==================[definiciones de funciones internas]=====================*/
+
+static void __attribute__( ( noinline ) ) kernel_alu( uint32_t iters )
+{
+    uint32_t x = sink_u32;
+
+    while( iters-- )
+    {
+        x = x * 1664525u + 1013904223u;
+        x ^= x >> 13;
+    }
+
+    sink_u32 = x;
+}
+
+static void __attribute__( ( noinline ) ) kernel_mem( uint32_t iters )
+{
+    uint32_t idx = 0;
+    uint32_t acc = sink_u32;
+
+    while( iters-- )
+    {
+        acc += mem_buf[idx];
+        mem_buf[idx] = acc;
+        idx = ( idx + MEM_STRIDE ) & ( MEM_WORDS - 1 );
+    }
+
+    sink_u32 = acc;
+}
+
+static void __attribute__( ( noinline ) ) kernel_fpu( uint32_t iters )
+{
+    float f = sink_f32;
+
+    while( iters-- )
+    {
+        f = f * 0.999f + 0.5f;
+        f = f / 1.0001f;
+    }
+
+    sink_f32 = f;
+}
+
+/* Ciclos que tarda kernel( iters ), el menor de CPU_LOAD_CAL_RUNS intentos */
+static uint32_t measure( t_kernel kernel, uint32_t iters )
+{
+    uint32_t best = UINT32_MAX;
+
+    for( uint32_t run = 0 ; run < CPU_LOAD_CAL_RUNS ; run++ )
+    {
+        uint32_t t0 = DWT->CYCCNT;
+        kernel( iters );
+        uint32_t dt = DWT->CYCCNT - t0;
+
+        if( dt < best )
+        {
+            best = dt;
+        }
+    }
+
+    return best;
+}
+
+/*==================[definiciones de funciones externas]=====================*/
+
+/**
+   @brief   Habilita el contador de ciclos y calibra los perfiles. Llamar desde main,
+            antes de vTaskStartScheduler, para que la medicion no sea interrumpida por el tick.
+ */
+void cpu_load_Init( void )
+{
+    cyclesCounterInit( SystemCoreClock );
+
+    cycles_per_us = SystemCoreClock / 1000000;
+
+    for( uint32_t p = 0 ; p < CPU_LOAD_PROFILES ; p++ )
+    {
+        /* la diferencia entre 2N y N iteraciones descuenta el costo de la llamada */
+        uint32_t t1 = measure( kernels[p], CPU_LOAD_CAL_ITERS );
+        uint32_t t2 = measure( kernels[p], 2 * CPU_LOAD_CAL_ITERS );
+
+        iter_cycles_x256[p] = ( t2 > t1 ) ? ( ( t2 - t1 ) << 8 ) / CPU_LOAD_CAL_ITERS : 256;
+    }
+}
+
+/**
+   @brief   Consume aproximadamente cycles ciclos de CPU con el perfil ALU
+ */
+void cpu_load_busy_cycles( uint32_t cycles )
+{
+    kernels[CPU_LOAD_ALU]( ( uint32_t )( ( ( uint64_t ) cycles << 8 ) / iter_cycles_x256[CPU_LOAD_ALU] ) );
+}
+
+/**
+   @brief   Consume aproximadamente us microsegundos de CPU con el perfil ALU
+ */
+void cpu_load_busy_us( uint32_t us )
+{
+    cpu_load_run( CPU_LOAD_ALU, us );
+}
+
+/**
+   @brief   Consume aproximadamente us microsegundos de CPU con la mezcla de instrucciones del perfil
+ */
+void cpu_load_run( t_cpu_load_profile profile, uint32_t us )
+{
+    configASSERT( profile < CPU_LOAD_PROFILES );
+
+    uint64_t cycles = ( uint64_t ) us * cycles_per_us;
+
+    kernels[profile]( ( uint32_t )( ( cycles << 8 ) / iter_cycles_x256[profile] ) );
+}
+
+/**
+   @brief   Resultado de la calibracion: ciclos por iteracion del perfil, x256
+ */
+uint32_t cpu_load_iter_cycles_x256( t_cpu_load_profile profile )
+{
+    return iter_cycles_x256[profile];
+}
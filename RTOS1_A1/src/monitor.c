@@ -0,0 +1,287 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[inlcusiones]============================================*/
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "FreeRTOSConfig.h"
+#include "config.h"
+#include "task.h"
+#include "queue.h"
+#include "monitor.h"
+
+/*==================[definiciones de datos internos]=========================*/
+static t_monitor_task  monitor_tasks[MONITOR_MAX_TASKS];
+static uint32_t        monitor_n_tasks;
+
+static t_monitor_queue monitor_queues[MONITOR_MAX_QUEUES];
+static uint32_t        monitor_n_queues;
+
+static TaskStatus_t    monitor_status[MONITOR_MAX_TASKS];
+static bool_t          monitor_heap_alarm;
+static bool_t          monitor_tasks_alarm;
+
+/*==================[declaraciones de funciones internas]====================*/
+static t_monitor_task* monitor_find( TaskHandle_t task );
+static void monitor_sample( void );
+static uint32_t monitor_recommend( const t_monitor_task* t );
+static void Tarea_Monitor_Code( void* taskParmPtr );
+
+/*==================[definiciones de funciones externas]=====================*/
+
+void monitor_Init( void )
+{
+    TaskHandle_t handle;
+
+    BaseType_t res =
+        xTaskCreate(
+            Tarea_Monitor_Code,         // Funcion de la tarea a ejecutar
+            ( const char * )"monitor",  // Nombre de la tarea como String amigable para el usuario
+            configMINIMAL_STACK_SIZE*4, /* tamaño del stack de cada tarea (words) */
+            NULL,                       // Parametros de tarea
+            tskIDLE_PRIORITY+2,         // Prioridad de la tarea: muestrea aun con las demas tareas ocupando el CPU
+            &handle                     // Puntero a la tarea creada en el sistema
+        );
+
+    configASSERT( res == pdPASS );
+
+    monitor_register_task( handle, configMINIMAL_STACK_SIZE*4 );
+}
+
+/**
+   @brief   Informa al monitor con que stack se creo una tarea. FreeRTOS no expone ese
+            dato, y sin el solo se puede informar el minimo libre, no recomendar un tamaño.
+   @param task
+   @param depth     el mismo valor pasado a xTaskCreate (words)
+ */
+void monitor_register_task( TaskHandle_t task, uint32_t depth )
+{
+    t_monitor_task* t = monitor_find( task );
+
+    if( t != NULL )
+    {
+        t->depth = depth;
+    }
+}
+
+/**
+   @brief   Agrega una cola al seguimiento de ocupacion maxima y al registro de colas
+            de FreeRTOS (el mismo nombre se ve desde el debugger).
+   @param queue
+   @param name
+ */
+void monitor_register_queue( QueueHandle_t queue, const char* name )
+{
+    taskENTER_CRITICAL();
+    if( monitor_n_queues < MONITOR_MAX_QUEUES )
+    {
+        monitor_queues[monitor_n_queues].queue    = queue;
+        monitor_queues[monitor_n_queues].name     = name;
+        monitor_queues[monitor_n_queues].length   = uxQueueMessagesWaiting( queue ) + uxQueueSpacesAvailable( queue );
+        monitor_queues[monitor_n_queues].max_used = 0;
+        monitor_queues[monitor_n_queues].alarm    = FALSE;
+        monitor_n_queues++;
+    }
+    taskEXIT_CRITICAL();
+
+    vQueueAddToRegistry( queue, name );
+}
+
+/**
+   @brief   Informe de dimensionamiento: por tarea el stack asignado, el maximo usado y el
+            recomendado; el heap minimo libre y la ocupacion maxima de cada cola.
+ */
+void monitor_report( void )
+{
+    uint32_t reclaim = 0;
+    uint32_t rec;
+
+    PRINTF( "\r\n%-16s %6s %6s %6s\r\n", "tarea", "stack", "usado", "recom" );
+
+    for( uint32_t i = 0; i < monitor_n_tasks; i++ )
+    {
+        t_monitor_task* t = &monitor_tasks[i];
+
+        if( t->depth == 0 )
+        {
+            PRINTF( "%-16s %6s %6s %6s (libre min %u)\r\n", t->name, "?", "?", "?", t->min_free );
+            continue;
+        }
+
+        rec = monitor_recommend( t );
+        if( rec < t->depth )
+        {
+            reclaim += t->depth - rec;
+        }
+
+        PRINTF( "%-16s %6u %6u %6u\r\n", t->name, t->depth, t->depth - t->min_free, rec );
+    }
+
+    PRINTF( "recuperable: %u words\r\n", reclaim );
+    PRINTF( "heap: libre %u, minimo %u de %u bytes\r\n",
+            xPortGetFreeHeapSize(), xPortGetMinimumEverFreeHeapSize(), configTOTAL_HEAP_SIZE );
+
+    for( uint32_t i = 0; i < monitor_n_queues; i++ )
+    {
+        PRINTF( "cola %s: max %u de %u\r\n", monitor_queues[i].name, monitor_queues[i].max_used, monitor_queues[i].length );
+    }
+}
+
+/*==================[definiciones de funciones internas]=====================*/
+
+/* busca la tarea en la tabla; si no esta la agrega (NULL si la tabla esta llena) */
+static t_monitor_task* monitor_find( TaskHandle_t task )
+{
+    t_monitor_task* t = NULL;
+
+    taskENTER_CRITICAL();
+    for( uint32_t i = 0; i < monitor_n_tasks; i++ )
+    {
+        if( monitor_tasks[i].handle == task )
+        {
+            t = &monitor_tasks[i];
+            break;
+        }
+    }
+
+    if( t == NULL && monitor_n_tasks < MONITOR_MAX_TASKS )
+    {
+        t = &monitor_tasks[monitor_n_tasks++];
+        t->handle   = task;
+        t->name     = "";
+        t->depth    = 0;
+        t->min_free = UINT32_MAX;
+        t->alarm    = FALSE;
+    }
+    taskEXIT_CRITICAL();
+
+    return t;
+}
+
+/* stack usado + MONITOR_STACK_MARGIN_PCT, en multiplos de 8 words */
+static uint32_t monitor_recommend( const t_monitor_task* t )
+{
+    uint32_t used = t->depth - t->min_free;
+    uint32_t rec  = used + ( used * MONITOR_STACK_MARGIN_PCT + 99 ) / 100;
+
+    return ( rec + 7 ) & ~7UL;
+}
+
+/* recorre todas las tareas, el heap y las colas registradas, y actualiza maximos y alarmas */
+static void monitor_sample( void )
+{
+    UBaseType_t n = uxTaskGetSystemState( monitor_status, MONITOR_MAX_TASKS, NULL );
+    size_t heap_min;
+
+    /* con mas tareas que MONITOR_MAX_TASKS uxTaskGetSystemState no copia nada y devuelve 0:
+       lo informo en vez de dejar de vigilar los stacks en silencio */
+    if( n == 0 && !monitor_tasks_alarm )
+    {
+        monitor_tasks_alarm = TRUE;
+        PRINTF( "ALARMA monitor: %u tareas, MONITOR_MAX_TASKS %u\r\n", ( unsigned ) uxTaskGetNumberOfTasks(), MONITOR_MAX_TASKS );
+    }
+
+    for( UBaseType_t i = 0; i < n; i++ )
+    {
+        t_monitor_task* t = monitor_find( monitor_status[i].xHandle );
+
+        if( t == NULL )
+        {
+            continue;
+        }
+
+        t->name = monitor_status[i].pcTaskName;
+
+        /* la tarea idle se crea con configMINIMAL_STACK_SIZE */
+        if( t->depth == 0 && strcmp( t->name, "IDLE" ) == 0 )
+        {
+            t->depth = configMINIMAL_STACK_SIZE;
+        }
+
+        if( monitor_status[i].usStackHighWaterMark < t->min_free )
+        {
+            t->min_free = monitor_status[i].usStackHighWaterMark;
+        }
+
+        if( !t->alarm && t->min_free < MONITOR_STACK_ALARM_WORDS )
+        {
+            t->alarm = TRUE;
+            PRINTF( "ALARMA stack %s: libre %u words\r\n", t->name, t->min_free );
+        }
+    }
+
+    heap_min = xPortGetMinimumEverFreeHeapSize();
+    if( !monitor_heap_alarm && heap_min < MONITOR_HEAP_ALARM_BYTES )
+    {
+        monitor_heap_alarm = TRUE;
+        PRINTF( "ALARMA heap: minimo libre %u bytes\r\n", heap_min );
+    }
+
+    for( uint32_t i = 0; i < monitor_n_queues; i++ )
+    {
+        t_monitor_queue* q = &monitor_queues[i];
+        UBaseType_t used = uxQueueMessagesWaiting( q->queue );
+
+        if( used > q->max_used )
+        {
+            q->max_used = used;
+        }
+
+        if( !q->alarm && q->max_used * 100 >= q->length * MONITOR_QUEUE_ALARM_PCT )
+        {
+            q->alarm = TRUE;
+            PRINTF( "ALARMA cola %s: %u de %u\r\n", q->name, q->max_used, q->length );
+        }
+    }
+}
+
+static void Tarea_Monitor_Code( void* taskParmPtr )
+{
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+    uint32_t periods = 0;
+
+    while( 1 )
+    {
+        vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( MONITOR_PERIOD_MS ) );
+
+        monitor_sample();
+
+        if( ++periods == MONITOR_REPORT_PERIODS )
+        {
+            periods = 0;
+            monitor_report();
+        }
+    }
+}
+
+/*==================[fin del archivo]========================================*/
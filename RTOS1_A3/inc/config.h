@@ -12,9 +12,6 @@
 #define PRINTF(...)              printf(__VA_ARGS__)
 
 
-#define CUENTAS_1MS             9251
-
-
 #define HACER_FALLAR            1
 
 #endif
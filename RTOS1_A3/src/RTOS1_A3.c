@@ -36,6 +36,7 @@
 #include "FreeRTOSConfig.h"
 #include "config.h"
 #include "task.h"
+#include "cpu_load.h"
 #include <stdio.h>
 /*==================[definiciones y macros]==================================*/
 
@@ -68,6 +69,8 @@ int main( void )
 	PRINTF_CONFIGURE;
 	PRINTF( EXAMPLE_WELCOME_TEXT );
 
+	cpu_load_Init();					// calibra la carga de CPU de las tareas
+
 	/* solo creo la tarea A */
 	res = xTaskCreate(
 			  tarea_A_code,               // Funcion de la tarea a ejecutar
@@ -98,26 +101,6 @@ int main( void )
 
 /*==================[definiciones de funciones internas]=====================*/
 
-/**
-   @brief   Implementacion de un delay utilizando ciclos for.
-			Se implementa solo para generar utilizacion de CPU sin bloquear a la tarea.
-			NO DEBE UTILIZARSE BAJO NINGUN PUNTO DE VISTA EN UN APLICACION REAL SOBRE UN RTOS.
-   @param cuentas
- */
-void delay_con_for( uint32_t ms )
-{
-	volatile uint32_t i;
-	volatile uint32_t j;
-
-	for( i=0 ; i<ms ; i++ )
-	{
-		/* delay de aprox 1 ms */
-		for( j=0 ; j<CUENTAS_1MS ; j++ )
-		{
-		}
-	}
-}
-
 void blink_n_500( uint32_t n, uint32_t led )
 {
 	/* genero 2 blinks*/
@@ -127,7 +110,7 @@ void blink_n_500( uint32_t n, uint32_t led )
 	for( ; cycles>0 ; cycles-- )
 	{
 		gpioToggle( led );
-		delay_con_for( 500 );
+		cpu_load_busy_ms( 500 );
 	}
 }
 
@@ -218,7 +201,7 @@ void tarea_D_code( void* taskParmPtr )
 	while( 1 )
 	{
 		gpioToggle( LED3 );
-		delay_con_for( 500 );
+		cpu_load_busy_ms( 500 );
 	}
 }
 
@@ -36,6 +36,7 @@
 #include "FreeRTOSConfig.h"
 #include "config.h"
 #include "task.h"
+#include "cpu_load.h"
 #include <stdio.h>
 /*==================[definiciones y macros]==================================*/
 
@@ -68,6 +69,8 @@ int main( void )
 	PRINTF_CONFIGURE;
 	PRINTF( EXAMPLE_WELCOME_TEXT );
 
+	cpu_load_Init();					// calibra la carga de CPU de las tareas
+
 	/* solo creo la tarea A */
 	res = xTaskCreate(
 			  tarea_A_code,               // Funcion de la tarea a ejecutar
@@ -98,28 +101,14 @@ int main( void )
 
 /*==================[definiciones de funciones internas]=====================*/
 
-/**
-   @brief   Implementacion de un delay utilizando ciclos for.
-			Se implementa solo para generar utilizacion de CPU sin bloquear a la tarea.
-			NO DEBE UTILIZARSE BAJO NINGUN PUNTO DE VISTA EN UN APLICACION REAL SOBRE UN RTOS.
-   @param cuentas
- */
-void delay_con_for( uint32_t ms )
+/* carga de CPU que cede el procesador cada 1 ms, como el viejo delay_con_for: con
+   configUSE_TIME_SLICING en 0 es lo unico que alterna las tareas de igual prioridad */
+static void busy_ms_yield( uint32_t ms )
 {
-	volatile uint32_t i;
-	volatile uint32_t j;
-
-	for( i=0 ; i<ms ; i++ )
+	for( ; ms>0 ; ms-- )
 	{
-		/* delay de aprox 1 ms */
-		for( j=0 ; j<CUENTAS_1MS ; j++ )
-		{
-		}
-		taskYIELD(); /* Solicita un cambio de contexto a otra tarea. Como configUSE_PREEMPTION está en 1,
-		 	 	 	 	siempre se ejecutará la tarea de mayor prioridad que se pueda ejecutar
-		 	 	 	 	por lo que llamar a taskYIELD () solo dará como resultado un cambio a una tarea
-		 	 	 	 	de la misma prioridad.
-					 */
+		cpu_load_busy_us( 1000 );
+		taskYIELD();
 	}
 }
 
@@ -132,7 +121,7 @@ void blink_n_500( uint32_t n, uint32_t led )
 	for( ; cycles>0 ; cycles-- )
 	{
 		gpioToggle( led );
-		delay_con_for( 500 );
+		busy_ms_yield( 500 );
 	}
 }
 
@@ -223,7 +212,7 @@ void tarea_D_code( void* taskParmPtr )
 	while( 1 )
 	{
 		gpioToggle( LED3 );
-		delay_con_for( 500 );
+		busy_ms_yield( 500 );
 	}
 }
 
@@ -54,7 +54,7 @@ extern int DbgConsole_Printf( const char *fmt_s, ... );
 #define configUSE_PREEMPTION                         1
 #define configUSE_IDLE_HOOK                          0
 #define configUSE_TICK_HOOK                          0
-#define configUSE_TICKLESS_IDLE                      0
+#define configUSE_TICKLESS_IDLE                      2       // vPortSuppressTicksAndSleep propio en tickless.c (RIT)
 #define configUSE_DAEMON_TASK_STARTUP_HOOK           0
 #define configCPU_CLOCK_HZ                           ( SystemCoreClock )
 #define configTICK_RATE_HZ                           ( ( TickType_t ) 1000 ) // 1000 ticks per second => 1ms tick rate
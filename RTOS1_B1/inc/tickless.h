@@ -0,0 +1,40 @@
+/*=============================================================================
+ * Copyright (c) 2020, Martin N. Menendez <menendezmartin81@gmail.com>
+ * All rights reserved.
+ * License: Free
+ * Date: 2020/09/03
+ * Version: v1.1
+ *===========================================================================*/
+#ifndef _TICKLESS_H_
+#define _TICKLESS_H_
+
+/*==================[inclusiones]============================================*/
+#include "FreeRTOSConfig.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "sapi.h"
+
+/*==================[definiciones y macros]==================================*/
+
+/* Ciclos de CPU que se pierden entre que se detiene el SysTick y arranca el RIT (y
+   al reves al despertar). Se suman a lo dormido en cada despertar; ajustar con la
+   deriva que informa ticklessGetStats si el reloj del kernel atrasa o adelanta */
+#define TICKLESS_MISSED_CYCLES      40
+
+/*==================[definiciones de datos]=========================*/
+typedef struct
+{
+    uint32_t sleeps;            // veces que se entro a dormir con el tick suprimido
+    uint32_t aborted;           // veces que se cancelo (tick pendiente o tarea lista)
+    uint32_t timer_wakeups;     // despertares por el RIT (se durmio todo lo esperado)
+    uint32_t early_wakeups;     // despertares por otra interrupcion
+    uint32_t ticks_suppressed;  // ticks que no interrumpieron a la CPU
+    uint32_t max_sleep_ticks;   // sueño mas largo
+} tTicklessStats;
+
+/*==================[prototipos de funciones]====================*/
+void ticklessInit( void );
+void ticklessGetStats( tTicklessStats* stats );
+int32_t ticklessDriftUs( void );
+
+#endif /* _TICKLESS_H_ */
@@ -13,12 +13,16 @@
 #include "FreeRTOSConfig.h"
 
 #include "sapi.h"
+#include "tickless.h"
 
 /*==================[definiciones y macros]==================================*/
 
 #define LED_RATE pdMS_TO_TICKS(500)   // 500 ms
 #define LOADING_RATE pdMS_TO_TICKS(250)
 
+#define STATS_PERIODS   10          // cada cuantos periodos de heart_beat se informa el modo tickless
+#define AWAKE_LED       LED3        // encendido mientras la CPU esta despierta (para medir con osciloscopio)
+
 /*==================[definiciones de datos internos]=========================*/
 
 /*==================[definiciones de datos externos]=========================*/
@@ -43,6 +47,8 @@ int main( void )
     debugPrintConfigUart( UART_USB, 115200 );		// UART for debug messages
     printf( "Ejercicio B_1.\r\n" );
 
+    ticklessInit();
+
     //gpioWrite( LED3, ON );							// Led para dar señal de vida
 
     // Crear tarea en freeRTOS
@@ -50,7 +56,7 @@ int main( void )
     xTaskCreate(
     	heart_beat,                     	// Funcion de la tarea a ejecutar
         ( const char * )"heart_beat",   	// Nombre de la tarea como String amigable para el usuario
-        configMINIMAL_STACK_SIZE*2, 		// Cantidad de stack de la tarea
+        configMINIMAL_STACK_SIZE*4, 		// Cantidad de stack de la tarea (printf de las estadisticas)
         0,                          		// Parametros de tarea
         tskIDLE_PRIORITY+1,         		// Prioridad de la tarea -> Queremos que este un nivel encima de IDLE
         0                          			// Puntero a la tarea creada en el sistema
@@ -100,6 +106,9 @@ void heart_beat( void* taskParmPtr )
 
     TickType_t xLastWakeTime = xTaskGetTickCount();
 
+    uint32_t periods = 0;
+    tTicklessStats last = { 0 };
+
     // ---------- REPETIR POR SIEMPRE --------------------------
     while( TRUE )
     {
@@ -111,7 +120,39 @@ void heart_beat( void* taskParmPtr )
 
         // Envia la tarea al estado bloqueado durante xPeriodicity (delay periodico)
         vTaskDelayUntil( &xLastWakeTime , xPeriodicity );
+
+        // Despertares por segundo y deriva del tick respecto del timer de referencia
+        if( ++periods == STATS_PERIODS )
+        {
+            tTicklessStats now;
+            int32_t drift = ticklessDriftUs();
+            uint32_t seconds = STATS_PERIODS * xPeriodicity / configTICK_RATE_HZ;
+
+            ticklessGetStats( &now );
+
+            printf( "tickless: %u despertares/s, %u ticks suprimidos, sueno max %u ms, %u abortos, deriva %d us\r\n",
+                    ( now.sleeps - last.sleeps ) / seconds,
+                    now.ticks_suppressed - last.ticks_suppressed,
+                    now.max_sleep_ticks * portTICK_RATE_MS,
+                    now.aborted - last.aborted,
+                    drift );
+
+            last = now;
+            periods = 0;
+        }
     }
 }
 
+// Ganchos del modo tickless (configPRE_STOP_PROCESSING / configPOST_STOP_PROCESSING):
+// se ejecutan con las interrupciones deshabilitadas, inmediatamente antes y despues del WFI
+void vMainPreStopProcessing( void )
+{
+    gpioWrite( AWAKE_LED, OFF );
+}
+
+void vMainPostStopProcessing( void )
+{
+    gpioWrite( AWAKE_LED, ON );
+}
+
 /*==================[fin del archivo]========================================*/
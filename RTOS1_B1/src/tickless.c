@@ -0,0 +1,231 @@
+/*=============================================================================
+ * Copyright (c) 2020, Martin N. Menendez <menendezmartin81@gmail.com>
+ * All rights reserved.
+ * License: Free
+ * Date: 2020/09/03
+ * Version: v1.1
+ *===========================================================================*/
+
+/*==================[inclusiones]============================================*/
+#include "tickless.h"
+
+/*
+ * Modo tickless propio del LPC4337 (configUSE_TICKLESS_IDLE 2).
+ *
+ * El SysTick es de 24 bits: a 204 MHz no puede dormir mas de 82 ms seguidos. Mientras
+ * el tick esta suprimido se usa el RIT (Repetitive Interrupt Timer), de 32 bits y con el
+ * mismo reloj que la CPU, lo que permite sueños de hasta 21 s. Al despertar se lee cuanto
+ * conto el RIT, se adelanta el tick del kernel con vTaskStepTick y el SysTick se rearranca
+ * con el resto del tick en curso, de modo que la fase del tick no se pierde.
+ *
+ * Como referencia independiente del tick se deja corriendo el TIMER3 a 1 MHz: comparando
+ * ambos se obtiene la deriva acumulada del reloj del kernel (ticklessDriftUs).
+ */
+
+/*==================[definiciones y macros]==================================*/
+#define TICKLESS_REF_TIMER      LPC_TIMER3
+#define TICKLESS_REF_CLOCK      CLK_MX_TIMER3
+
+/*==================[definiciones de datos internos]=========================*/
+#if configUSE_TICKLESS_IDLE == 2
+static uint32_t cycles_per_tick;
+static TickType_t max_idle_ticks;
+#endif
+
+static tTicklessStats tickless_stats;
+
+static TickType_t ref_tick_start;
+static uint32_t ref_us_start;
+
+/*==================[definiciones de funciones internas]=====================*/
+
+/*==================[definiciones de funciones externas]=====================*/
+
+/**
+   @brief   Configura el RIT para el modo tickless y arranca el timer de referencia.
+            Llamar desde main, antes de vTaskStartScheduler.
+ */
+void ticklessInit( void )
+{
+#if configUSE_TICKLESS_IDLE == 2
+    cycles_per_tick = configCPU_CLOCK_HZ / configTICK_RATE_HZ;
+
+    /* el RIT cuenta con el reloj de la CPU, igual que el SysTick: los ciclos son intercambiables */
+    configASSERT( Chip_Clock_GetRate( CLK_MX_RITIMER ) == configCPU_CLOCK_HZ );
+
+    /* se deja un tick de margen para que el contador no desborde mientras se despierta */
+    max_idle_ticks = ( 0xFFFFFFFFUL / cycles_per_tick ) - 1;
+
+    Chip_RIT_Init( LPC_RITIMER );
+    Chip_RIT_Disable( LPC_RITIMER );
+    Chip_RIT_DisableCTRL( LPC_RITIMER, RIT_CTRL_ENCLR );      // el contador sigue luego del match: se lee lo dormido
+    Chip_RIT_ClearInt( LPC_RITIMER );
+
+    /* solo hace falta que la interrupcion este habilitada en el NVIC para que despierte al WFI.
+       Se atiende y limpia con las interrupciones deshabilitadas dentro de vPortSuppressTicksAndSleep */
+    NVIC_SetPriority( RITIMER_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY );
+    NVIC_ClearPendingIRQ( RITIMER_IRQn );
+    NVIC_EnableIRQ( RITIMER_IRQn );
+#endif
+
+    Chip_TIMER_Init( TICKLESS_REF_TIMER );
+    Chip_TIMER_Reset( TICKLESS_REF_TIMER );
+    Chip_TIMER_PrescaleSet( TICKLESS_REF_TIMER, Chip_Clock_GetRate( TICKLESS_REF_CLOCK ) / 1000000 - 1 );
+    Chip_TIMER_Enable( TICKLESS_REF_TIMER );
+
+    ref_tick_start = 0;     // el scheduler aun no arranco: el tick vale 0
+    ref_us_start = Chip_TIMER_ReadCount( TICKLESS_REF_TIMER );
+}
+
+/**
+   @brief   Copia las estadisticas del modo tickless
+ */
+void ticklessGetStats( tTicklessStats* stats )
+{
+    taskENTER_CRITICAL();
+    *stats = tickless_stats;
+    taskEXIT_CRITICAL();
+}
+
+/**
+   @brief   Deriva acumulada del reloj del kernel respecto del timer de referencia, en us.
+            Positivo: el tick adelanta. Conviene llamarla justo despues de despertar por
+            tiempo (vTaskDelayUntil), cuando el tick recien cambio. El timer de referencia
+            da la vuelta cada 71 minutos.
+ */
+int32_t ticklessDriftUs( void )
+{
+    TickType_t ticks;
+    uint32_t us;
+
+    taskENTER_CRITICAL();
+    ticks = xTaskGetTickCount();
+    us = Chip_TIMER_ReadCount( TICKLESS_REF_TIMER );
+    taskEXIT_CRITICAL();
+
+    uint32_t tick_us = ( uint32_t )( ticks - ref_tick_start ) * ( 1000000 / configTICK_RATE_HZ );
+
+    return ( int32_t )( tick_us - ( us - ref_us_start ) );
+}
+
+#if configUSE_TICKLESS_IDLE == 2
+/**
+   @brief   La llama la tarea IDLE, con el scheduler suspendido, cuando ninguna tarea
+            necesita la CPU por al menos configEXPECTED_IDLE_TIME_BEFORE_SLEEP ticks.
+ */
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+{
+    uint32_t partial;           // ciclos que faltaban para el proximo tick al detener el SysTick
+    uint32_t slept;
+    uint32_t next;
+    TickType_t ticks;
+
+    if( xExpectedIdleTime > max_idle_ticks )
+    {
+        xExpectedIdleTime = max_idle_ticks;
+    }
+
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    partial = SysTick->VAL;
+
+    /* si el tick ya esta pendiente (o a punto de estarlo) o una interrupcion puso lista
+       una tarea desde que IDLE decidio dormir, no se duerme: el SysTick sigue donde estaba */
+    if( partial == 0 || ( SCB->ICSR & SCB_ICSR_PENDSTSET_Msk ) || eTaskConfirmSleepModeStatus() == eAbortSleep )
+    {
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        tickless_stats.aborted++;
+        __enable_irq();
+        return;
+    }
+
+    Chip_RIT_SetCounter( LPC_RITIMER, 0 );
+    Chip_RIT_SetCOMPVAL( LPC_RITIMER, partial + ( xExpectedIdleTime - 1 ) * cycles_per_tick );
+    Chip_RIT_Enable( LPC_RITIMER );
+
+    TickType_t xModifiableIdleTime = xExpectedIdleTime;
+    configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+    if( xModifiableIdleTime > 0 )
+    {
+        configPRE_STOP_PROCESSING();
+        __DSB();
+        __WFI();
+        __ISB();
+        configPOST_STOP_PROCESSING();
+    }
+    configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+    Chip_RIT_Disable( LPC_RITIMER );
+    slept = Chip_RIT_GetCounter( LPC_RITIMER ) + TICKLESS_MISSED_CYCLES;
+
+    if( Chip_RIT_GetIntStatus( LPC_RITIMER ) )
+    {
+        Chip_RIT_ClearInt( LPC_RITIMER );
+        NVIC_ClearPendingIRQ( RITIMER_IRQn );
+        tickless_stats.timer_wakeups++;
+    }
+    else
+    {
+        tickless_stats.early_wakeups++;
+    }
+
+    /* ticks completos que pasaron y ciclos que faltan para el siguiente */
+    if( slept < partial )
+    {
+        ticks = 0;
+        next = partial - slept;
+    }
+    else
+    {
+        slept -= partial;
+        ticks = 1 + slept / cycles_per_tick;
+        next = cycles_per_tick - ( slept % cycles_per_tick );
+    }
+
+    /* con el tick justo encima, el SysTick no puede cargarse con 0: se cuenta ese tick */
+    if( next < 2 )
+    {
+        next += cycles_per_tick;
+        ticks++;
+    }
+
+    if( ticks > xExpectedIdleTime )
+    {
+        ticks = xExpectedIdleTime;
+    }
+
+    /* el SysTick rearranca con lo que resta del tick en curso y luego vuelve al periodo normal */
+    SysTick->LOAD = next - 1;
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = cycles_per_tick - 1;
+
+    /* el ultimo tick se entrega por el handler del SysTick para que desbloquee
+       a las tareas que vencen en el y haga el cambio de contexto */
+    if( ticks > 0 )
+    {
+        vTaskStepTick( ticks - 1 );
+        SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+    }
+
+    tickless_stats.sleeps++;
+    tickless_stats.ticks_suppressed += ( ticks > 0 ) ? ticks - 1 : 0;
+    if( ticks > tickless_stats.max_sleep_ticks )
+    {
+        tickless_stats.max_sleep_ticks = ticks;
+    }
+
+    __enable_irq();
+}
+
+/* Nunca deberia ejecutarse: la interrupcion se limpia con las interrupciones deshabilitadas */
+void RIT_IRQHandler( void )
+{
+    Chip_RIT_ClearInt( LPC_RITIMER );
+}
+#endif
+
+/*==================[fin del archivo]========================================*/
@@ -64,20 +64,12 @@ void task_tecla( void* taskParmPtr );
 /*=====[Implementations of public functions]=================================*/
 TickType_t get_diff()
 {
-	TickType_t tiempo;
-
-	taskENTER_CRITICAL();
-	tiempo = keys_data[0].time_diff;
-	taskEXIT_CRITICAL();
-
-	return tiempo;
+	return keys_data[0].time_diff;
 }
 
 void clear_diff()
 {
-	taskENTER_CRITICAL();
 	keys_data[0].time_diff = 0;
-	taskEXIT_CRITICAL();
 }
 
 void keys_Init( void )
@@ -176,9 +168,8 @@ static void buttonPressed( uint32_t index )
 {
 	TickType_t current_tick_count = xTaskGetTickCount();
 
-	taskENTER_CRITICAL();
+	/* solo esta tarea escribe time_down */
 	keys_data[index].time_down = current_tick_count;
-	taskEXIT_CRITICAL();
 }
 
 /* accion de el evento de tecla liberada */
@@ -186,10 +177,8 @@ static void buttonReleased( uint32_t index )
 {
 	TickType_t current_tick_count = xTaskGetTickCount();
 
-	taskENTER_CRITICAL();
 	keys_data[index].time_up    = current_tick_count;
 	keys_data[index].time_diff  = keys_data[index].time_up - keys_data[index].time_down;
-	taskEXIT_CRITICAL();
 }
 
 static void keys_ButtonError( uint32_t index )
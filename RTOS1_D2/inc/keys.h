@@ -59,7 +59,7 @@ typedef struct
 
 	TickType_t time_down;		//timestamp of the last High to Low transition of the key
 	TickType_t time_up;		    //timestamp of the last Low to High transition of the key
-	TickType_t time_diff;	    //variables
+	volatile TickType_t time_diff;	//palabra alineada de 32 bits: se lee y escribe sin seccion critica
 } t_key_data;
 
 /* methods ================================================================= */
@@ -0,0 +1,79 @@
+/* Copyright 2020,  Martin Menendez / Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LOCK_PROF_H_
+#define LOCK_PROF_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/*==================[definiciones y macros]==================================*/
+#define LOCK_PROF_MAX_LOCKS     4
+#define LOCK_PROF_MAX_TASKS     6       // tareas distintas que se siguen por lock
+#define LOCK_PROF_BINS          16      // histogramas en escala log2 de us: 0, 1, 2-3, 4-7, ... >= 16 ms
+
+/*==================[tipos de datos]=========================================*/
+typedef struct
+{
+    uint32_t acquisitions;
+    uint32_t contended;                 // tomas que encontraron el lock ocupado
+    uint32_t timeouts;
+    uint32_t wait_max;                  // us
+    uint32_t hold_max;                  // us
+    uint32_t wait_hist[LOCK_PROF_BINS];
+    uint32_t hold_hist[LOCK_PROF_BINS];
+} t_lock_prof_stats;
+
+typedef struct
+{
+    TaskHandle_t        task;
+    t_lock_prof_stats   stats;
+} t_lock_prof_task;
+
+typedef struct
+{
+    const char*         name;
+    SemaphoreHandle_t   sem;
+    uint32_t            hold_start;     // ciclos del DWT al obtener el lock
+    t_lock_prof_task*   holder;
+    t_lock_prof_stats   stats;          // de todas las tareas
+    t_lock_prof_task    tasks[LOCK_PROF_MAX_TASKS];
+} t_lock_prof;
+
+/*==================[prototipos de funciones]================================*/
+void       lock_prof_Init( void );
+void       lock_prof_register( t_lock_prof* lock, const char* name, SemaphoreHandle_t sem );
+BaseType_t lock_prof_take( t_lock_prof* lock, TickType_t timeout );
+void       lock_prof_give( t_lock_prof* lock );
+void       lock_prof_report( void );
+
+#endif /* LOCK_PROF_H_ */
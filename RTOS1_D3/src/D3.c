@@ -50,11 +50,25 @@
 #define CRITICAL_END
 #else
 #include "semphr.h"
+#include "lock_prof.h"
+
+/* en 1 el mutex del printf pasa por el profiler de locks, que informa cada
+   LOCK_PROF_REPORT_MS cuanto esperan y cuanto lo retienen las tareas */
+#define LOCK_PROF               1
+#define LOCK_PROF_REPORT_MS     10000
+
 #define CRITICAL_DECLARE    SemaphoreHandle_t mutex
+
+#if LOCK_PROF==1
+#define CRITICAL_CONFIG     mutex = xSemaphoreCreateMutex(); lock_prof_Init(); lock_prof_register( &print_lock, "printf", mutex )
+#define CRITICAL_START      lock_prof_take( &print_lock , portMAX_DELAY )
+#define CRITICAL_END        lock_prof_give( &print_lock )
+#else
 #define CRITICAL_CONFIG     mutex = xSemaphoreCreateMutex()
 #define CRITICAL_START      xSemaphoreTake( mutex , portMAX_DELAY )
 #define CRITICAL_END        xSemaphoreGive( mutex )
 #endif
+#endif
 
 /*==================[definiciones de datos internos]=========================*/
 
@@ -64,6 +78,11 @@ DEBUG_PRINT_ENABLE;
 
 /*==================[declaraciones de funciones internas]====================*/
 CRITICAL_DECLARE;
+
+#if EVIDENCIAR_PROBLEMA==0 && LOCK_PROF==1
+t_lock_prof print_lock;
+void lock_report( void* taskParmPtr );
+#endif
 /*==================[declaraciones de funciones externas]====================*/
 
 // Prototipo de funcion de la tarea
@@ -91,7 +110,7 @@ int main( void )
     // Crear tarea en freeRTOS
     res = xTaskCreate(
               sacerdote_a,                     // Funcion de la tarea a ejecutar
-              ( const char * )"myTask",   	// Nombre de la tarea como String amigable para el usuario
+              ( const char * )"sacerdote_a",	// Nombre de la tarea como String amigable para el usuario
               configMINIMAL_STACK_SIZE*2, 	// Cantidad de stack de la tarea
               0,                          	// Parametros de tarea
               tskIDLE_PRIORITY+1,         	// Prioridad de la tarea -> Queremos que este un nivel encima de IDLE
@@ -102,7 +121,7 @@ int main( void )
 
     res = xTaskCreate(
               sacerdote_b,                     // Funcion de la tarea a ejecutar
-              ( const char * )"myTask",   	// Nombre de la tarea como String amigable para el usuario
+              ( const char * )"sacerdote_b",	// Nombre de la tarea como String amigable para el usuario
               configMINIMAL_STACK_SIZE*2, 	// Cantidad de stack de la tarea
               0,                          	// Parametros de tarea
               tskIDLE_PRIORITY+1,         	// Prioridad de la tarea -> Queremos que este un nivel encima de IDLE
@@ -114,7 +133,7 @@ int main( void )
 
     res = xTaskCreate(
               sacerdote_c,                     // Funcion de la tarea a ejecutar
-              ( const char * )"myTask",   	// Nombre de la tarea como String amigable para el usuario
+              ( const char * )"sacerdote_c",	// Nombre de la tarea como String amigable para el usuario
               configMINIMAL_STACK_SIZE*2, 	// Cantidad de stack de la tarea
               0,                          	// Parametros de tarea
               tskIDLE_PRIORITY+1,         	// Prioridad de la tarea -> Queremos que este un nivel encima de IDLE
@@ -125,7 +144,7 @@ int main( void )
 
     res = xTaskCreate(
               sacerdote_d,                     // Funcion de la tarea a ejecutar
-              ( const char * )"myTask",   	// Nombre de la tarea como String amigable para el usuario
+              ( const char * )"sacerdote_d",	// Nombre de la tarea como String amigable para el usuario
               configMINIMAL_STACK_SIZE*2, 	// Cantidad de stack de la tarea
               0,                          	// Parametros de tarea
               tskIDLE_PRIORITY+1,         	// Prioridad de la tarea -> Queremos que este un nivel encima de IDLE
@@ -136,6 +155,19 @@ int main( void )
 
     CRITICAL_CONFIG;
 
+#if EVIDENCIAR_PROBLEMA==0 && LOCK_PROF==1
+    res = xTaskCreate(
+              lock_report,                     // Funcion de la tarea a ejecutar
+              ( const char * )"lock_report",	// Nombre de la tarea como String amigable para el usuario
+              configMINIMAL_STACK_SIZE*3, 	// Cantidad de stack de la tarea
+              0,                          	// Parametros de tarea
+              tskIDLE_PRIORITY+1,         	// Prioridad de la tarea
+              0                          		// Puntero a la tarea creada en el sistema
+          );
+
+    configASSERT( res == pdPASS ); // gestion de errores
+#endif
+
     // Iniciar scheduler
     vTaskStartScheduler(); // Enciende tick | Crea idle y pone en ready | Evalua las tareas creadas | Prioridad mas alta pasa a running
 
@@ -199,4 +231,15 @@ void sacerdote_d( void* taskParmPtr )
     }
 }
 
+#if EVIDENCIAR_PROBLEMA==0 && LOCK_PROF==1
+void lock_report( void* taskParmPtr )
+{
+    while( TRUE )
+    {
+        vTaskDelay( LOCK_PROF_REPORT_MS / portTICK_RATE_MS );
+        lock_prof_report();
+    }
+}
+#endif
+
 /*==================[fin del archivo]========================================*/
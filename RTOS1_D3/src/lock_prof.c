@@ -0,0 +1,270 @@
+/* Copyright 2020,  Martin Menendez / Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*==================[inlcusiones]============================================*/
+#include <string.h>
+#include "sapi.h"
+#include "lock_prof.h"
+
+/*==================[definiciones y macros]==================================*/
+
+/*==================[definiciones de datos internos]=========================*/
+static t_lock_prof* locks[LOCK_PROF_MAX_LOCKS];
+static uint32_t     n_locks;
+static uint32_t     cycles_per_us;
+
+/* impar mientras lock_prof_report tiene tomados los locks: las esperas que se
+   superponen con el informe no se cuentan, porque las causa el propio informe */
+static volatile uint32_t report_epoch;
+static uint32_t     excluded;
+
+/*==================[declaraciones de funciones internas]====================*/
+static t_lock_prof_task* task_slot( t_lock_prof* lock, TaskHandle_t task );
+static void stats_wait( t_lock_prof_stats* stats, uint32_t us, bool_t contended );
+static void stats_hold( t_lock_prof_stats* stats, uint32_t us );
+static uint32_t bin_of( uint32_t us );
+static void print_hist( const char* title, const uint32_t* hist );
+
+/*==================[definiciones de funciones externas]=====================*/
+
+/**
+   @brief   Arranca el contador de ciclos con el que se miden las esperas
+ */
+void lock_prof_Init( void )
+{
+    cyclesCounterInit( SystemCoreClock );
+    cycles_per_us = SystemCoreClock / 1000000;
+}
+
+/**
+   @brief   Agrega un lock (mutex o semaforo binario ya creado) al profiler
+ */
+void lock_prof_register( t_lock_prof* lock, const char* name, SemaphoreHandle_t sem )
+{
+    memset( lock, 0, sizeof( *lock ) );
+    lock->name = name;
+    lock->sem = sem;
+
+    taskENTER_CRITICAL();
+    configASSERT( n_locks < LOCK_PROF_MAX_LOCKS );
+    locks[n_locks++] = lock;
+    taskEXIT_CRITICAL();
+}
+
+/**
+   @brief   xSemaphoreTake instrumentado: mide la espera y arranca la medicion de tenencia
+ */
+BaseType_t lock_prof_take( t_lock_prof* lock, TickType_t timeout )
+{
+    uint32_t epoch = report_epoch;
+    uint32_t t0 = DWT->CYCCNT;
+    bool_t contended = FALSE;
+
+    BaseType_t res = xSemaphoreTake( lock->sem, 0 );
+
+    if( res != pdTRUE && timeout > 0 )
+    {
+        contended = TRUE;
+        res = xSemaphoreTake( lock->sem, timeout );
+    }
+
+    uint32_t t1 = DWT->CYCCNT;
+    uint32_t wait_us = ( t1 - t0 ) / cycles_per_us;
+
+    taskENTER_CRITICAL();
+    t_lock_prof_task* slot = task_slot( lock, xTaskGetCurrentTaskHandle() );
+
+    if( res != pdTRUE )
+    {
+        lock->stats.timeouts++;
+        if( slot != NULL )
+        {
+            slot->stats.timeouts++;
+        }
+    }
+    else
+    {
+        if( epoch == report_epoch && ( epoch & 1 ) == 0 )
+        {
+            stats_wait( &lock->stats, wait_us, contended );
+            if( slot != NULL )
+            {
+                stats_wait( &slot->stats, wait_us, contended );
+            }
+        }
+        else
+        {
+            excluded++;
+        }
+
+        lock->holder = slot;
+        lock->hold_start = t1;
+    }
+    taskEXIT_CRITICAL();
+
+    return res;
+}
+
+/**
+   @brief   xSemaphoreGive instrumentado: cierra la medicion de tenencia
+ */
+void lock_prof_give( t_lock_prof* lock )
+{
+    uint32_t hold_us = ( DWT->CYCCNT - lock->hold_start ) / cycles_per_us;
+
+    taskENTER_CRITICAL();
+    stats_hold( &lock->stats, hold_us );
+    if( lock->holder != NULL )
+    {
+        stats_hold( &lock->holder->stats, hold_us );
+    }
+    lock->holder = NULL;
+    taskEXIT_CRITICAL();
+
+    xSemaphoreGive( lock->sem );
+}
+
+/**
+   @brief   Imprime por la UART de printf el informe de cada lock y de cada tarea que lo
+            uso. Toma los locks sin instrumentar mientras imprime, para que la salida no
+            se mezcle con la de las tareas (en D3 el lock protege justamente al printf).
+ */
+void lock_prof_report( void )
+{
+    static t_lock_prof copy;
+
+    report_epoch++;
+
+    for( uint32_t i = 0; i < n_locks; i++ )
+    {
+        xSemaphoreTake( locks[i]->sem, portMAX_DELAY );
+
+        taskENTER_CRITICAL();
+        copy = *locks[i];
+        taskEXIT_CRITICAL();
+
+        printf( "lock %s: %u tomas, %u con espera (%u%%), %u timeouts, espera max %u us, tenencia max %u us\n",
+                copy.name, copy.stats.acquisitions, copy.stats.contended,
+                copy.stats.acquisitions ? 100 * copy.stats.contended / copy.stats.acquisitions : 0,
+                copy.stats.timeouts, copy.stats.wait_max, copy.stats.hold_max );
+        print_hist( "  espera   ", copy.stats.wait_hist );
+        print_hist( "  tenencia ", copy.stats.hold_hist );
+
+        for( uint32_t t = 0; t < LOCK_PROF_MAX_TASKS && copy.tasks[t].task != NULL; t++ )
+        {
+            t_lock_prof_stats* s = &copy.tasks[t].stats;
+
+            printf( "  %s: %u tomas, %u con espera, espera max %u us, tenencia max %u us\n",
+                    pcTaskGetName( copy.tasks[t].task ), s->acquisitions, s->contended, s->wait_max, s->hold_max );
+            print_hist( "    espera   ", s->wait_hist );
+            print_hist( "    tenencia ", s->hold_hist );
+        }
+
+        xSemaphoreGive( locks[i]->sem );
+    }
+
+    printf( "lock_prof: %u esperas descartadas por superponerse con el informe\n", excluded );
+
+    report_epoch++;
+}
+
+/*==================[definiciones de funciones internas]=====================*/
+
+/* lugar de la tarea en la tabla del lock; la agrega si es nueva. NULL si no hay lugar */
+static t_lock_prof_task* task_slot( t_lock_prof* lock, TaskHandle_t task )
+{
+    for( uint32_t t = 0; t < LOCK_PROF_MAX_TASKS; t++ )
+    {
+        if( lock->tasks[t].task == task )
+        {
+            return &lock->tasks[t];
+        }
+        if( lock->tasks[t].task == NULL )
+        {
+            lock->tasks[t].task = task;
+            return &lock->tasks[t];
+        }
+    }
+
+    return NULL;
+}
+
+static void stats_wait( t_lock_prof_stats* stats, uint32_t us, bool_t contended )
+{
+    stats->acquisitions++;
+    if( contended )
+    {
+        stats->contended++;
+    }
+    if( us > stats->wait_max )
+    {
+        stats->wait_max = us;
+    }
+    stats->wait_hist[bin_of( us )]++;
+}
+
+static void stats_hold( t_lock_prof_stats* stats, uint32_t us )
+{
+    if( us > stats->hold_max )
+    {
+        stats->hold_max = us;
+    }
+    stats->hold_hist[bin_of( us )]++;
+}
+
+/* 0 -> 0, 1 -> 1, 2..3 -> 2, 4..7 -> 3, ... saturado en el ultimo */
+static uint32_t bin_of( uint32_t us )
+{
+    uint32_t bin = ( us == 0 ) ? 0 : 32 - __builtin_clz( us );
+
+    return ( bin < LOCK_PROF_BINS ) ? bin : LOCK_PROF_BINS - 1;
+}
+
+/* solo se imprimen los bins con cuentas, como "<limite superior en us>:<cuenta>" */
+static void print_hist( const char* title, const uint32_t* hist )
+{
+    printf( "%s", title );
+    for( uint32_t b = 0; b < LOCK_PROF_BINS; b++ )
+    {
+        if( hist[b] != 0 )
+        {
+            if( b == LOCK_PROF_BINS - 1 )
+            {
+                printf( " >=%u:%u", 1u << ( b - 1 ), hist[b] );
+            }
+            else
+            {
+                printf( " <%u:%u", 1u << b, hist[b] );
+            }
+        }
+    }
+    printf( "\n" );
+}
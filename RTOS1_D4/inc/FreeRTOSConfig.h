@@ -78,7 +78,7 @@
 #define configMAX_CO_ROUTINE_PRIORITIES              ( 2 )
 
 /* Software timer definitions. */
-#define configUSE_TIMERS                             0
+#define configUSE_TIMERS                             1
 #define configTIMER_TASK_PRIORITY                    ( configMAX_PRIORITIES - 3 )
 #define configTIMER_QUEUE_LENGTH                     10
 #define configTIMER_TASK_STACK_DEPTH                 ( configMINIMAL_STACK_SIZE * 4 )
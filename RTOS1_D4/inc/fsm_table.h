@@ -0,0 +1,79 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FSM_TABLE_H_
+#define FSM_TABLE_H_
+
+#include <stdint.h>
+
+/* public macros ================================================================= */
+
+/* Una FSM se describe con un X-macro de transiciones, una fila por (estado, evento):
+
+   #define MI_FSM( T ) \
+	   T( ESTADO_A, EVENTO_1, ESTADO_B, ACCION_X ) \
+	   ...
+
+   y la tabla se genera con FSM_ROW / FSM_COUNT (ver keys.c). La tabla queda en flash
+   como un arreglo const de n_states * n_events celdas de 2 bytes. */
+
+/* celda de la tabla: designated initializer, el orden de las filas no importa */
+#define FSM_ROW( n_events, state, event, next, action )     [ ( state ) * ( n_events ) + ( event ) ] = { ( next ), ( action ) },
+
+/* cuenta filas y marca celdas: con count == n_states * n_events y todas las celdas marcadas
+   no puede haber un par (estado, evento) repetido ni faltante. La mascara admite hasta 64 celdas */
+#define FSM_COUNT( state, event, next, action )             + 1
+#define FSM_CELLS( n_events, state, event )                 | ( 1ULL << ( ( state ) * ( n_events ) + ( event ) ) )
+#define FSM_ALL_CELLS( n_states, n_events )                 ( ( ( n_states ) * ( n_events ) == 64 ) ? ~0ULL : ( 1ULL << ( ( n_states ) * ( n_events ) ) ) - 1 )
+
+/* types ================================================================= */
+typedef void ( *t_fsm_action )( uint32_t ctx );
+
+typedef struct
+{
+	uint8_t next;       //estado siguiente
+	uint8_t action;     //indice en t_fsm.actions; la accion 0 debe ser una funcion vacia
+} t_fsm_transition;
+
+typedef struct
+{
+	const t_fsm_transition* table;
+	const t_fsm_action*     actions;
+	uint8_t                 n_states;
+	uint8_t                 n_events;
+} t_fsm;
+
+/* methods ================================================================= */
+uint8_t fsm_run( const t_fsm* fsm, uint8_t state, uint8_t event, uint32_t ctx );
+
+#endif /* FSM_TABLE_H_ */
@@ -0,0 +1,66 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef KEYS_REPEAT_H_
+#define KEYS_REPEAT_H_
+
+#include "FreeRTOS.h"
+#include "sapi.h"
+
+/* public macros ================================================================= */
+
+/* repeticion automatica de una tecla sostenida: la primera repeticion llega luego de
+   KEYS_REPEAT_DELAY_MS y el intervalo se reduce un KEYS_REPEAT_ACCEL_DIV-avo en cada
+   repeticion, desde KEYS_REPEAT_START_MS hasta KEYS_REPEAT_MIN_MS */
+#define KEYS_REPEAT_DELAY_MS    500
+#define KEYS_REPEAT_START_MS    300
+#define KEYS_REPEAT_MIN_MS      40
+#define KEYS_REPEAT_ACCEL_DIV   4
+
+/* types ================================================================= */
+typedef struct
+{
+	bool_t on;					//la tecla esta sostenida: el timer de repeticion la atiende
+	TickType_t next;			//tick de la proxima repeticion
+	TickType_t interval;		//intervalo actual entre repeticiones
+	uint32_t count;				//repeticiones emitidas desde la pulsacion
+} t_key_repeat;
+
+/* methods ================================================================= */
+/* calendario de la repeticion, independiente del RTOS (keys_repeat.c) */
+void keys_repeat_start( t_key_repeat* rep, TickType_t now );
+void keys_repeat_stop( t_key_repeat* rep );
+bool_t keys_repeat_fire( t_key_repeat* rep, TickType_t now );
+TickType_t keys_repeat_left( const t_key_repeat* rep, TickType_t now );
+
+#endif /* KEYS_REPEAT_H_ */
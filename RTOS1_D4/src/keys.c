@@ -33,8 +33,11 @@
 /*==================[ Inclusions ]============================================*/
 #include "FreeRTOS.h"
 #include "task.h"
+#include "timers.h"
 #include "sapi.h"
 #include "keys.h"
+#include "keys_repeat.h"
+#include "fsm_table.h"
 
 /*=====[ Definitions of private data types ]===================================*/
 
@@ -42,15 +45,57 @@
 /*=====[Definition macros of private constants]==============================*/
 //#define BUTTON_RATE     1
 #define DEBOUNCE_TIME   40
+#define KEYS_TIMER_CMD_WAIT_MS  10	//espera de task_tecla por lugar en la cola de la tarea de timers
 
 /*=====[Prototypes (declarations) of private functions]======================*/
 
 static void keys_ButtonError( uint32_t index );
+static void keys_fsm_nop( uint32_t index );
 static void buttonPressed( uint32_t index );
 static void buttonReleased( uint32_t index );
+static void buttonRepeat( uint32_t index );
+static void keys_step_c1( uint32_t index );
+static void keys_repeat_schedule( TickType_t now, TickType_t block );
+static void keys_repeat_callback( TimerHandle_t timer );
 
 /*=====[Definitions of private global variables]=============================*/
 
+/* FSM antirrebote: el unico evento es el nivel de la tecla en cada muestreo */
+#define KEY_EV_LOW          0
+#define KEY_EV_HIGH         1
+#define KEY_EV_COUNT        2
+
+#define KEY_ACT_NONE        0
+#define KEY_ACT_PRESSED     1
+#define KEY_ACT_RELEASED    2
+
+#define KEYS_FSM_STATES     4	//STATE_BUTTON_UP .. STATE_BUTTON_RISING
+
+/* T( estado, evento, estado siguiente, accion ) */
+#define KEYS_FSM( T ) \
+	T( STATE_BUTTON_UP,      KEY_EV_LOW,  STATE_BUTTON_FALLING, KEY_ACT_NONE     ) \
+	T( STATE_BUTTON_UP,      KEY_EV_HIGH, STATE_BUTTON_UP,      KEY_ACT_NONE     ) \
+	T( STATE_BUTTON_FALLING, KEY_EV_LOW,  STATE_BUTTON_DOWN,    KEY_ACT_PRESSED  ) \
+	T( STATE_BUTTON_FALLING, KEY_EV_HIGH, STATE_BUTTON_UP,      KEY_ACT_NONE     ) \
+	T( STATE_BUTTON_DOWN,    KEY_EV_LOW,  STATE_BUTTON_DOWN,    KEY_ACT_NONE     ) \
+	T( STATE_BUTTON_DOWN,    KEY_EV_HIGH, STATE_BUTTON_RISING,  KEY_ACT_NONE     ) \
+	T( STATE_BUTTON_RISING,  KEY_EV_LOW,  STATE_BUTTON_DOWN,    KEY_ACT_NONE     ) \
+	T( STATE_BUTTON_RISING,  KEY_EV_HIGH, STATE_BUTTON_UP,      KEY_ACT_RELEASED )
+
+#define KEYS_FSM_ROW( state, event, next, action )  FSM_ROW( KEY_EV_COUNT, state, event, next, action )
+#define KEYS_FSM_CELL( state, event, next, action ) FSM_CELLS( KEY_EV_COUNT, state, event )
+
+_Static_assert( ( 0 KEYS_FSM( FSM_COUNT ) ) == KEYS_FSM_STATES * KEY_EV_COUNT, "KEYS_FSM: sobran o faltan transiciones" );
+_Static_assert( ( 0 KEYS_FSM( KEYS_FSM_CELL ) ) == FSM_ALL_CELLS( KEYS_FSM_STATES, KEY_EV_COUNT ), "KEYS_FSM: par (estado, evento) repetido o faltante" );
+
+static const t_fsm_transition keys_fsm_table[KEYS_FSM_STATES * KEY_EV_COUNT] = { KEYS_FSM( KEYS_FSM_ROW ) };
+
+static const t_fsm_action keys_fsm_actions[] = { [KEY_ACT_NONE] = keys_fsm_nop, [KEY_ACT_PRESSED] = buttonPressed, [KEY_ACT_RELEASED] = buttonReleased };
+
+static const t_fsm keys_fsm = { keys_fsm_table, keys_fsm_actions, KEYS_FSM_STATES, KEY_EV_COUNT };
+
+static TimerHandle_t repeat_timer;	//un solo timer atiende la repeticion de todas las teclas
+
 /*=====[Definitions of public global variables]==============================*/
 const t_key_config  keys_config[] = { TEC1, TEC2 } ;
 
@@ -66,13 +111,7 @@ void task_tecla( void* taskParmPtr );
 /*=====[Implementations of public functions]=================================*/
 TickType_t get_diff()
 {
-	TickType_t tiempo;
-
-	taskENTER_CRITICAL();
-	tiempo = keys_data[0].time_diff;
-	taskEXIT_CRITICAL();
-
-	return tiempo;
+	return keys_data[0].time_diff;
 }
 
 TickType_t get_c1()
@@ -93,22 +132,28 @@ void inc_c1()
 
 void clear_diff()
 {
-	taskENTER_CRITICAL();
 	keys_data[0].time_diff = 0;
-	taskEXIT_CRITICAL();
 }
 
 void keys_Init( void )
 {
 	BaseType_t res;
 
-	for(int i=0; i <sizeof(keys_data);i++)
+	for(int i=0; i <key_count;i++)
 	{
 		keys_data[i].state          = BUTTON_UP;  // Set initial state
 		keys_data[i].time_down      = KEYS_INVALID_TIME;
 		keys_data[i].time_up        = KEYS_INVALID_TIME;
 		keys_data[i].time_diff      = KEYS_INVALID_TIME;
+		keys_repeat_stop( &keys_data[i].repeat );
+		keys_data[i].repeat.count   = 0;
 	}
+
+	/* one-shot: se reprograma siempre para la proxima repeticion pendiente de cualquier tecla */
+	repeat_timer = xTimerCreate( "keys_repeat", 1, pdFALSE, 0, keys_repeat_callback );
+
+	configASSERT( repeat_timer != NULL );
+
 	// Crear tareas en freeRTOS
 	res = xTaskCreate (
 			  task_tecla,					// Funcion de la tarea a ejecutar
@@ -126,67 +171,15 @@ void keys_Init( void )
 // keys_ Update State Function
 void keys_Update( uint32_t index )
 {
-	switch( keys_data[index].state )
+	uint8_t event = gpioRead( keys_config[index].tecla ) ? KEY_EV_HIGH : KEY_EV_LOW;
+
+	if( keys_data[index].state >= KEYS_FSM_STATES )
 	{
-		case STATE_BUTTON_UP:
-			/* CHECK TRANSITION CONDITIONS */
-			if( !gpioRead( keys_config[index].tecla ) )
-			{
-				keys_data[index].state = STATE_BUTTON_FALLING;
-			}
-			break;
-
-		case STATE_BUTTON_FALLING:
-			/* ENTRY */
-
-			/* CHECK TRANSITION CONDITIONS */
-			if( !gpioRead( keys_config[index].tecla ) )
-			{
-				keys_data[index].state = STATE_BUTTON_DOWN;
-
-				/* ACCION DEL EVENTO !*/
-				buttonPressed( index );
-			}
-			else
-			{
-				keys_data[index].state = STATE_BUTTON_UP;
-			}
-
-			/* LEAVE */
-			break;
-
-		case STATE_BUTTON_DOWN:
-			/* CHECK TRANSITION CONDITIONS */
-			if( gpioRead( keys_config[index].tecla ) )
-			{
-				keys_data[index].state = STATE_BUTTON_RISING;
-			}
-			break;
-
-		case STATE_BUTTON_RISING:
-			/* ENTRY */
-
-			/* CHECK TRANSITION CONDITIONS */
-
-			if( gpioRead( keys_config[index].tecla ) )
-			{
-				keys_data[index].state = STATE_BUTTON_UP;
-
-				/* ACCION DEL EVENTO ! */
-				buttonReleased( index );
-			}
-			else
-			{
-				keys_data[index].state = STATE_BUTTON_DOWN;
-			}
-
-			/* LEAVE */
-			break;
-
-		default:
-			keys_ButtonError( index );
-			break;
+		keys_ButtonError( index );
+		return;
 	}
+
+	keys_data[index].state = fsm_run( &keys_fsm, keys_data[index].state, event, index );
 }
 
 /*=====[Implementations of private functions]================================*/
@@ -196,9 +189,14 @@ static void buttonPressed( uint32_t index )
 {
 	TickType_t current_tick_count = xTaskGetTickCount();
 
-	taskENTER_CRITICAL();
+	/* solo esta tarea escribe time_down */
 	keys_data[index].time_down = current_tick_count;
+
+	taskENTER_CRITICAL();
+	keys_repeat_start( &keys_data[index].repeat, current_tick_count );
 	taskEXIT_CRITICAL();
+
+	keys_repeat_schedule( current_tick_count, pdMS_TO_TICKS( KEYS_TIMER_CMD_WAIT_MS ) );
 }
 
 /* accion de el evento de tecla liberada */
@@ -206,10 +204,31 @@ static void buttonReleased( uint32_t index )
 {
 	TickType_t current_tick_count = xTaskGetTickCount();
 
-	taskENTER_CRITICAL();
 	keys_data[index].time_up    = current_tick_count;
 	keys_data[index].time_diff  = keys_data[index].time_up - keys_data[index].time_down;
+
+	taskENTER_CRITICAL();
+	keys_repeat_stop( &keys_data[index].repeat );
 	taskEXIT_CRITICAL();
+
+	keys_repeat_schedule( current_tick_count, pdMS_TO_TICKS( KEYS_TIMER_CMD_WAIT_MS ) );
+
+	/* si la tecla se repitio, el barrido ya se hizo mientras estaba sostenida */
+	if( keys_data[index].repeat.count == 0 )
+	{
+		keys_step_c1( index );
+	}
+}
+
+/* repeticion de una tecla sostenida: mismo efecto que una pulsacion corta */
+static void buttonRepeat( uint32_t index )
+{
+	keys_step_c1( index );
+}
+
+/* TEC1 incrementa c1 y TEC2 lo decrementa, de a 100 ms, entre 100 y 1900 */
+static void keys_step_c1( uint32_t index )
+{
 	if(index == 1)
 	{
 		taskENTER_CRITICAL();
@@ -228,6 +247,67 @@ static void buttonReleased( uint32_t index )
 	}
 }
 
+/* reprograma el timer de repeticion para la tecla sostenida con el vencimiento mas proximo,
+   o lo detiene si no queda ninguna. Se llama desde task_tecla y desde el callback del timer.
+   block: espera por lugar en la cola de comandos de la tarea de timers */
+static void keys_repeat_schedule( TickType_t now, TickType_t block )
+{
+	TickType_t wait = portMAX_DELAY;
+	TickType_t left;
+	BaseType_t res;
+
+	taskENTER_CRITICAL();
+	for( int i = 0; i < key_count; i++ )
+	{
+		left = keys_repeat_left( &keys_data[i].repeat, now );
+		if( left < wait )
+		{
+			wait = left;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if( wait == portMAX_DELAY )
+	{
+		res = xTimerStop( repeat_timer, block );
+	}
+	else
+	{
+		/* xTimerChangePeriod tambien arranca el timer; el periodo minimo es 1 tick */
+		res = xTimerChangePeriod( repeat_timer, wait ? wait : 1, block );
+	}
+
+	/* si el comando se pierde la repeticion se corta, o no se detiene nunca: la cola de
+	   comandos (configTIMER_QUEUE_LENGTH) es chica o la tarea de timers no llega a atenderla */
+	configASSERT( res == pdPASS );
+}
+
+/* corre en la tarea de timers: emite las repeticiones vencidas y acelera el intervalo */
+static void keys_repeat_callback( TimerHandle_t timer )
+{
+	TickType_t now = xTaskGetTickCount();
+	bool_t fire;
+
+	for( int i = 0; i < key_count; i++ )
+	{
+		taskENTER_CRITICAL();
+		fire = keys_repeat_fire( &keys_data[i].repeat, now );
+		taskEXIT_CRITICAL();
+
+		if( fire )
+		{
+			buttonRepeat( i );
+		}
+	}
+
+	keys_repeat_schedule( now, 0 );		// un callback de timer no debe bloquear
+}
+
+/* accion de las transiciones sin evento */
+static void keys_fsm_nop( uint32_t index )
+{
+}
+
 static void keys_ButtonError( uint32_t index )
 {
 	taskENTER_CRITICAL();
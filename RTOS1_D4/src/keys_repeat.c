@@ -0,0 +1,100 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[ Inclusions ]============================================*/
+#include "keys_repeat.h"
+
+/* Calendario de la repeticion automatica de keys.c, sin dependencias del RTOS: keys.c lo
+   consulta desde task_tecla y desde el callback del timer, y RTOS1_F3/test/test_repeat.c
+   verifica en la PC los instantes que emite. */
+
+/* comparacion de ticks que tolera el desborde del contador */
+#define TIME_REACHED( now, deadline )   ( ( TickType_t )( ( now ) - ( deadline ) ) < ( portMAX_DELAY / 2 ) )
+
+/*=====[Implementations of public functions]=================================*/
+void keys_repeat_start( t_key_repeat* rep, TickType_t now )
+{
+	rep->on       = TRUE;
+	rep->count    = 0;
+	rep->interval = pdMS_TO_TICKS( KEYS_REPEAT_START_MS );
+	rep->next     = now + pdMS_TO_TICKS( KEYS_REPEAT_DELAY_MS );
+}
+
+void keys_repeat_stop( t_key_repeat* rep )
+{
+	rep->on = FALSE;
+}
+
+/**
+   @brief si la repeticion vencio, la cuenta, programa la siguiente y acelera el intervalo.
+          La siguiente se calcula desde el vencimiento y no desde now: un callback demorado
+          no corre el calendario.
+
+   @param rep
+   @param now
+   @return TRUE si hay que emitir una repeticion
+ */
+bool_t keys_repeat_fire( t_key_repeat* rep, TickType_t now )
+{
+	if( !rep->on || !TIME_REACHED( now, rep->next ) )
+	{
+		return FALSE;
+	}
+
+	rep->count++;
+	rep->next     += rep->interval;
+	rep->interval -= rep->interval / KEYS_REPEAT_ACCEL_DIV;
+	if( rep->interval < pdMS_TO_TICKS( KEYS_REPEAT_MIN_MS ) )
+	{
+		rep->interval = pdMS_TO_TICKS( KEYS_REPEAT_MIN_MS );
+	}
+
+	return TRUE;
+}
+
+/**
+   @brief ticks que faltan para la proxima repeticion: 0 si ya vencio, portMAX_DELAY si la
+          tecla no esta sostenida.
+
+   @param rep
+   @param now
+ */
+TickType_t keys_repeat_left( const t_key_repeat* rep, TickType_t now )
+{
+	if( !rep->on )
+	{
+		return portMAX_DELAY;
+	}
+
+	return TIME_REACHED( now, rep->next ) ? 0 : rep->next - now;
+}
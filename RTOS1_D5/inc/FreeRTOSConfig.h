@@ -54,7 +54,7 @@
 #define configMINIMAL_STACK_SIZE                     90
 #define configTOTAL_HEAP_SIZE                        ( ( size_t ) ( 8 * 1024 ) )    /* 85 Kbytes. */
 #define configMAX_TASK_NAME_LEN                      ( 16 )
-#define configUSE_TRACE_FACILITY                     0
+#define configUSE_TRACE_FACILITY                     1
 #define configUSE_16_BIT_TICKS                       0
 #define configIDLE_SHOULD_YIELD                      1
 #define configUSE_MUTEXES                            1
@@ -217,4 +217,33 @@ extern uint32_t SystemCoreClock;
 extern int DbgConsole_Printf( const char *fmt_s, ... );
 #endif
 
+/* Trace recorder: los hooks trace* del kernel escriben en un buffer circular en RAM
+ * (ver trace_rec.h). Requiere configUSE_TRACE_FACILITY 1. */
+#define TRACE_REC                                    1
+
+/* Monitor de semaforos/mutex: registra quien tiene cada recurso y detecta inversiones
+ * de prioridad (ver lock_mon.h). */
+#define LOCK_MON                                     1
+
+#if TRACE_REC==1
+#include "trace_rec.h"
+#else
+#define TRACE_REC_SWITCHED_IN()
+#define TRACE_REC_PRIORITY_INHERIT( pxTCB, uxPrio )
+#define TRACE_REC_PRIORITY_DISINHERIT( pxTCB, uxPrio )
+#endif
+
+#if LOCK_MON==1
+#include "lock_mon.h"
+#else
+#define LOCK_MON_SWITCHED_IN()
+#define LOCK_MON_PRIORITY_INHERIT( pxTCB, uxPrio )
+#define LOCK_MON_PRIORITY_DISINHERIT( pxTCB, uxPrio )
+#endif
+
+/* hooks que usan los dos */
+#define traceTASK_SWITCHED_IN()                         do { TRACE_REC_SWITCHED_IN(); LOCK_MON_SWITCHED_IN(); } while( 0 )
+#define traceTASK_PRIORITY_INHERIT( pxTCB, uxPrio )     do { TRACE_REC_PRIORITY_INHERIT( pxTCB, uxPrio ); LOCK_MON_PRIORITY_INHERIT( pxTCB, uxPrio ); } while( 0 )
+#define traceTASK_PRIORITY_DISINHERIT( pxTCB, uxPrio )  do { TRACE_REC_PRIORITY_DISINHERIT( pxTCB, uxPrio ); LOCK_MON_PRIORITY_DISINHERIT( pxTCB, uxPrio ); } while( 0 )
+
 #endif /* FREERTOS_CONFIG_H */
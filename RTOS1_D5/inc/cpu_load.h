@@ -0,0 +1,70 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CPU_LOAD_H_
+#define CPU_LOAD_H_
+
+#include <stdint.h>
+
+/*==================[definiciones y macros]==================================*/
+/* Generador de carga de CPU calibrado. Reemplaza a delay_con_for/CUENTAS_1MS, cuya cuenta
+   dependia del nivel de optimizacion (OPT en config.mk) y del clock.
+
+   Al arrancar se mide con el contador de ciclos del DWT cuanto tarda una iteracion de cada
+   perfil, y luego las funciones ejecutan la cantidad de iteraciones equivalente al tiempo
+   pedido. Es TRABAJO de CPU, no tiempo transcurrido: si la tarea es desalojada, el tiempo
+   total se alarga en lo que ejecutaron las otras, igual que con el viejo delay con for.
+
+   NO DEBE UTILIZARSE BAJO NINGUN PUNTO DE VISTA EN UN APLICACION REAL SOBRE UN RTOS. */
+
+#define CPU_LOAD_CAL_ITERS      256     // iteraciones de cada medicion de calibracion
+#define CPU_LOAD_CAL_RUNS       5       // se queda con la menor de las mediciones (sin interrupciones)
+
+#define cpu_load_busy_ms( ms )  cpu_load_busy_us( ( uint32_t )( ms ) * 1000 )
+
+/*==================[tipos de datos]=========================================*/
+typedef enum
+{
+    CPU_LOAD_ALU,               // cadena de multiplicaciones/sumas/desplazamientos enteros
+    CPU_LOAD_MEM,               // lectura-modificacion-escritura recorriendo un buffer en RAM
+    CPU_LOAD_FPU,               // cadena de operaciones float (USE_FPU=y en config.mk)
+    CPU_LOAD_PROFILES
+} t_cpu_load_profile;
+
+/*==================[prototipos de funciones]================================*/
+void     cpu_load_Init( void );
+void     cpu_load_busy_cycles( uint32_t cycles );
+void     cpu_load_busy_us( uint32_t us );
+void     cpu_load_run( t_cpu_load_profile profile, uint32_t us );
+uint32_t cpu_load_iter_cycles_x256( t_cpu_load_profile profile );
+
+#endif /* CPU_LOAD_H_ */
@@ -0,0 +1,90 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+#ifndef LOCK_MON_H_
+#define LOCK_MON_H_
+
+/* Este header lo incluye FreeRTOSConfig.h: no puede incluir FreeRTOS.h. Por eso los
+   handles de tareas y semaforos se pasan como void* */
+#include <stdint.h>
+
+/*==================[definiciones y macros]==================================*/
+#define LOCK_MON_MAX_LOCKS      4       // semaforos/mutex que se pueden seguir
+
+/*==================[tipos de datos]=========================================*/
+typedef struct
+{
+    const char*         name;
+    void*               sem;            // SemaphoreHandle_t (binario o mutex)
+
+    /* estado: lo escriben lock_mon_take/give en zona critica y lo lee el hook del scheduler */
+    void* volatile      holder;         // tarea que tiene tomado el recurso, NULL si esta libre
+    volatile uint32_t   holder_prio;    // prioridad efectiva del holder (sube si hereda)
+    volatile uint32_t   waiters;        // tareas bloqueadas esperandolo
+    volatile uint32_t   waiter_prio;    // maxima prioridad entre las que esperan
+    volatile uint32_t   inverted;       // hay una inversion en curso
+    uint32_t            inversion_start;
+
+    /* estadisticas, en ciclos del DWT */
+    uint32_t            takes;
+    uint32_t            contended;      // tomas que tuvieron que esperar
+    uint32_t            block_max;
+    uint64_t            block_total;
+    uint32_t            inversions;     // episodios de inversion detectados
+    uint32_t            inversion_max;
+    uint64_t            inversion_total;
+} t_lock_mon;
+
+/*==================[prototipos de funciones]================================*/
+void     lock_mon_register( t_lock_mon* lock, const char* name, void* sem );
+int32_t  lock_mon_take( t_lock_mon* lock, uint32_t timeout );
+void     lock_mon_give( t_lock_mon* lock );
+uint32_t lock_mon_inversions( void );
+void     lock_mon_report( void );
+
+void     lock_mon_switched_in( void* task, uint32_t prio );
+void     lock_mon_priority_changed( void* task, uint32_t prio );
+
+/*==================[hooks de FreeRTOS]======================================*/
+/* Se expanden dentro de tasks.c. Los compone FreeRTOSConfig.h con los de trace_rec.
+   Una inversion es que, mientras una tarea espera el recurso, corra otra de prioridad
+   menor que la que espera pero mayor que la del holder: lo esta desalojando. Con un
+   mutex el holder hereda la prioridad de la que espera y eso no puede ocurrir.
+   Con LOCK_MON 0 FreeRTOSConfig.h los deja vacios. */
+#if LOCK_MON==1
+#define LOCK_MON_SWITCHED_IN()                          lock_mon_switched_in( ( void* ) pxCurrentTCB, pxCurrentTCB->uxPriority )
+#define LOCK_MON_PRIORITY_INHERIT( pxTCB, uxPrio )      lock_mon_priority_changed( ( void* ) ( pxTCB ), ( uxPrio ) )
+#define LOCK_MON_PRIORITY_DISINHERIT( pxTCB, uxPrio )   lock_mon_priority_changed( ( void* ) ( pxTCB ), ( uxPrio ) )
+#endif
+
+#endif /* LOCK_MON_H_ */
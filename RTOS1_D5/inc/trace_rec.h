@@ -0,0 +1,111 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef TRACE_REC_H_
+#define TRACE_REC_H_
+
+/* Este header lo incluye FreeRTOSConfig.h: no puede incluir FreeRTOS.h */
+#include <stdint.h>
+
+/*==================[definiciones y macros]==================================*/
+#define TRACE_REC_LEN           512     // registros en RAM (8 bytes c/u), potencia de 2
+#define TRACE_REC_MAX_TASKS     16      // nombres de tareas guardados para el volcado
+#define TRACE_REC_MAX_QUEUES    16
+#define TRACE_REC_TICKS         0       // en 1 registra cada tick (llena el buffer en 0.5 s)
+
+// tipos de registro
+#define TRACE_EV_SWITCH_IN      1       // a = tarea que pasa a running
+#define TRACE_EV_TASK_CREATE    2       // a = tarea, b = prioridad
+#define TRACE_EV_TASK_DELETE    3       // a = tarea
+#define TRACE_EV_DELAY          4       // la tarea actual se bloquea por tiempo
+#define TRACE_EV_PRIO_INHERIT   5       // a = tarea que hereda, b = prioridad heredada
+#define TRACE_EV_PRIO_DISINHERIT 6      // a = tarea, b = prioridad original
+#define TRACE_EV_QUEUE_CREATE   7       // a = cola, b = tipo (queueQUEUE_TYPE_xxx)
+#define TRACE_EV_QUEUE_SEND     8       // a = cola
+#define TRACE_EV_QUEUE_RECEIVE  9
+#define TRACE_EV_QUEUE_BLOCK_SEND 10
+#define TRACE_EV_QUEUE_BLOCK_RECEIVE 11
+#define TRACE_EV_QUEUE_FAILED   12      // envio o recepcion sin exito (timeout)
+#define TRACE_EV_ISR_ENTER      13      // a = numero de ISR elegido por la aplicacion
+#define TRACE_EV_ISR_EXIT       14
+#define TRACE_EV_TICK           15
+
+/*==================[tipos de datos]=========================================*/
+typedef struct
+{
+    uint32_t time;      // ciclos del CPU (DWT)
+    uint8_t  type;      // TRACE_EV_xxx
+    uint8_t  a;
+    uint16_t b;
+} t_trace_rec;
+
+/*==================[prototipos de funciones]================================*/
+void trace_rec_Init( void );
+void trace_rec_event( uint8_t type, uint8_t a, uint16_t b );
+void trace_rec_task_create( uint32_t number, const char* name, uint32_t priority );
+uint32_t trace_rec_queue_create( uint8_t type );
+void trace_rec_dump( void );
+
+/*==================[hooks de FreeRTOS]======================================*/
+/* Se expanden dentro de tasks.c y queue.c, donde pxCurrentTCB y los campos de TCB y
+   Queue_t son visibles. uxTCBNumber y uxQueueNumber existen con configUSE_TRACE_FACILITY.
+   Los TRACE_REC_xxx los compone FreeRTOSConfig.h con los de lock_mon; con TRACE_REC 0
+   los deja vacios y no hay que redefinirlos aca. */
+#if TRACE_REC==1
+#define TRACE_REC_SWITCHED_IN()                         trace_rec_event( TRACE_EV_SWITCH_IN, pxCurrentTCB->uxTCBNumber, 0 )
+#define traceTASK_CREATE( pxNewTCB )                    trace_rec_task_create( ( pxNewTCB )->uxTCBNumber, ( pxNewTCB )->pcTaskName, ( pxNewTCB )->uxPriority )
+#define traceTASK_DELETE( pxTCB )                       trace_rec_event( TRACE_EV_TASK_DELETE, ( pxTCB )->uxTCBNumber, 0 )
+#define traceTASK_DELAY()                               trace_rec_event( TRACE_EV_DELAY, 0, 0 )
+#define traceTASK_DELAY_UNTIL( xTimeToWake )            trace_rec_event( TRACE_EV_DELAY, 0, 0 )
+#define TRACE_REC_PRIORITY_INHERIT( pxTCB, uxPrio )     trace_rec_event( TRACE_EV_PRIO_INHERIT, ( pxTCB )->uxTCBNumber, ( uxPrio ) )
+#define TRACE_REC_PRIORITY_DISINHERIT( pxTCB, uxPrio )  trace_rec_event( TRACE_EV_PRIO_DISINHERIT, ( pxTCB )->uxTCBNumber, ( uxPrio ) )
+
+#define traceQUEUE_CREATE( pxNewQueue )                 ( pxNewQueue )->uxQueueNumber = trace_rec_queue_create( ( pxNewQueue )->ucQueueType )
+#define traceQUEUE_SEND( pxQueue )                      trace_rec_event( TRACE_EV_QUEUE_SEND, ( pxQueue )->uxQueueNumber, 0 )
+#define traceQUEUE_SEND_FROM_ISR( pxQueue )             trace_rec_event( TRACE_EV_QUEUE_SEND, ( pxQueue )->uxQueueNumber, 1 )
+#define traceQUEUE_RECEIVE( pxQueue )                   trace_rec_event( TRACE_EV_QUEUE_RECEIVE, ( pxQueue )->uxQueueNumber, 0 )
+#define traceQUEUE_RECEIVE_FROM_ISR( pxQueue )          trace_rec_event( TRACE_EV_QUEUE_RECEIVE, ( pxQueue )->uxQueueNumber, 1 )
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )          trace_rec_event( TRACE_EV_QUEUE_BLOCK_SEND, ( pxQueue )->uxQueueNumber, 0 )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )       trace_rec_event( TRACE_EV_QUEUE_BLOCK_RECEIVE, ( pxQueue )->uxQueueNumber, 0 )
+#define traceQUEUE_SEND_FAILED( pxQueue )               trace_rec_event( TRACE_EV_QUEUE_FAILED, ( pxQueue )->uxQueueNumber, 0 )
+#define traceQUEUE_RECEIVE_FAILED( pxQueue )            trace_rec_event( TRACE_EV_QUEUE_FAILED, ( pxQueue )->uxQueueNumber, 1 )
+
+#if TRACE_REC_TICKS==1
+#define traceTASK_INCREMENT_TICK( xTickCount )          trace_rec_event( TRACE_EV_TICK, 0, 0 )
+#endif
+#endif
+
+/* para las ISRs de la aplicacion (el port de Cortex-M no tiene hook de entrada a ISR) */
+#define TRACE_REC_ISR_ENTER( n )    trace_rec_event( TRACE_EV_ISR_ENTER, ( n ), 0 )
+#define TRACE_REC_ISR_EXIT( n )     trace_rec_event( TRACE_EV_ISR_EXIT, ( n ), 0 )
+
+#endif /* TRACE_REC_H_ */
@@ -38,11 +38,14 @@
 #include "FreeRTOSConfig.h"
 
 #include "task.h"
+#include "cpu_load.h"
 #include "semphr.h"
+#if TRACE_REC==1
+#include "trace_rec.h"
+#endif
 
 /*==================[definiciones y macros]==================================*/
 
-#define CUENTAS_1MS             (9251*2)
 /* en 1 usa semaforos en 0 usa mutex*/
 #define EVIDENCIAR_PROBLEMA     1
 
@@ -53,8 +56,15 @@
 #endif
 
 #define CRITICAL_DECLARE    SemaphoreHandle_t mutex
+
+#if LOCK_MON==1
+/* las tomas pasan por el monitor, que detecta la inversion de prioridades */
+#define CRITICAL_START      lock_mon_take( &lock , portMAX_DELAY )
+#define CRITICAL_END        lock_mon_give( &lock )
+#else
 #define CRITICAL_START      xSemaphoreTake( mutex , portMAX_DELAY )
 #define CRITICAL_END        xSemaphoreGive( mutex )
+#endif
 
 /*==================[definiciones de datos internos]=========================*/
 typedef struct
@@ -67,6 +77,14 @@ t_params params[] = { {LED1,3},{LED2,5} };
 
 CRITICAL_DECLARE;
 
+#if LOCK_MON==1
+t_lock_mon lock;
+
+/* A y D: la ultima en terminar verifica el resultado del monitor */
+#define TAREAS_CON_RECURSO  2
+uint32_t tareas_terminadas;
+#endif
+
 /*==================[definiciones de datos externos]=========================*/
 
 print_t debugPrint;
@@ -86,6 +104,8 @@ void tarea_iniciadora( void*  );
 void tarea_A_code( void*  );
 void tarea_D_code( void*  );
 void tarea_BC_code( void*  );
+void tarea_trace_code( void*  );
+void verificar_inversion( void );
 
 
 /*==================[funcion principal]======================================*/
@@ -99,6 +119,25 @@ int main( void )
 
     printf( "ejercicio D5\n" );
 
+    cpu_load_Init();                    // calibra la carga de CPU de las tareas (antes de la traza: reinicia el DWT)
+
+#if TRACE_REC==1
+    /* antes de crear tareas y semaforos, para que queden en la traza */
+    trace_rec_Init();
+
+    /* TEC1 vuelca la traza por la UART */
+    res = xTaskCreate(
+              tarea_trace_code,
+              ( const char * )"tarea_trace",
+              configMINIMAL_STACK_SIZE*2,
+              NULL,
+              tskIDLE_PRIORITY+1,
+              NULL
+          );
+
+    configASSERT( res == pdPASS );
+#endif
+
     // Crear tarea en freeRTOS
     res = xTaskCreate(
               tarea_iniciadora,
@@ -129,32 +168,6 @@ int main( void )
 /*==================[definiciones de funciones internas]=====================*/
 
 
-/**
-   @brief   Implementacion de un delay utilizando ciclos for.
-			Se implementa solo para generar utilizacion de CPU sin bloquear a la tarea.
-
-			NO DEBE UTILIZARSE BAJO NINGUN PUNTO DE VISTA EN UN APLICACION REAL SOBRE UN RTOS.
-
-   @param cuentas
- */
-void delay_con_for( uint32_t ms )
-{
-    volatile uint32_t i;
-    volatile uint32_t j;
-
-    //TickType_t t = xTaskGetTickCount();
-
-    for( i=0 ; i<ms ; i++ )
-    {
-        /* delay de aprox 1 ms */
-        for( j=0 ; j<CUENTAS_1MS ; j++ )
-        {
-        }
-    }
-
-    //printf( "%u == %u ? \n" , ms, xTaskGetTickCount()-t );
-}
-
 /**
    @brief blink bloqueante.
 
@@ -170,7 +183,7 @@ void blink_n_500( uint32_t n, uint32_t led )
     for( ; cycles>0 ; cycles-- )
     {
         gpioToggle( led );
-        delay_con_for( 500 );
+        cpu_load_busy_ms( 500 );
     }
 }
 
@@ -235,6 +248,10 @@ void tarea_iniciadora( void* taskParmPtr )
     xSemaphoreGive( mutex );
 #endif
 
+#if LOCK_MON==1
+    lock_mon_register( &lock, "recurso", mutex );
+#endif
+
     /* ya cumpli mi mision */
     vTaskDelete( 0 );
 }
@@ -252,6 +269,37 @@ void tarea_BC_code( void* taskParmPtr )
     vTaskDelete( 0 );
 }
 
+#if LOCK_MON==1
+/**
+   @brief   Prueba de regresion del monitor con el escenario de este ejercicio: con el
+            semaforo binario (EVIDENCIAR_PROBLEMA 1) tiene que detectar la inversion, y con
+            el mutex no. Lo llama cada tarea que usa el recurso al terminar; la ultima
+            informa el resultado por la UART y con LEDG (pasa) o LEDR (falla).
+ */
+void verificar_inversion( void )
+{
+    taskENTER_CRITICAL();
+    uint32_t terminadas = ++tareas_terminadas;
+    taskEXIT_CRITICAL();
+
+    if( terminadas != TAREAS_CON_RECURSO )
+    {
+        return;
+    }
+
+    lock_mon_report();
+
+    uint32_t inversiones = lock_mon_inversions();
+    bool_t pasa = ( EVIDENCIAR_PROBLEMA == 1 ) ? ( inversiones > 0 ) : ( inversiones == 0 );
+
+    printf( "%s: %s, se esperaban %s y hubo %u inversiones\n", pasa ? "REGRESION OK" : "REGRESION FALLA",
+            ( EVIDENCIAR_PROBLEMA == 1 ) ? "semaforo binario" : "mutex",
+            ( EVIDENCIAR_PROBLEMA == 1 ) ? "inversiones" : "ninguna", inversiones );
+
+    gpioWrite( pasa ? LEDG : LEDR, ON );
+}
+#endif
+
 void tarea_AD_common( void* taskParmPtr )
 {
     char* texto = ( char* ) taskParmPtr;
@@ -264,12 +312,16 @@ void tarea_AD_common( void* taskParmPtr )
 
     /* con este delay pierdo ciclos de CPU simulando un procesamiento de un cierto tiempo
        para la tarea */
-    delay_con_for( 1000 );
+    cpu_load_busy_ms( 1000 );
 
     CRITICAL_END;
 
     printf( "Chau ! Soy %s y tarde en ejecutarme %u ms \n", texto, xTaskGetTickCount()-tini );
 
+#if LOCK_MON==1
+    verificar_inversion();
+#endif
+
     /* adios */
     vTaskDelete( 0 );
 }
@@ -286,4 +338,25 @@ void tarea_D_code( void* taskParmPtr )
     tarea_AD_common( taskParmPtr );
 }
 
+#if TRACE_REC==1
+void tarea_trace_code( void* taskParmPtr )
+{
+    while( 1 )
+    {
+        vTaskDelay( 50 / portTICK_RATE_MS );
+
+        if( !gpioRead( TEC1 ) )
+        {
+            trace_rec_dump();
+
+            /* espero que suelten la tecla */
+            while( !gpioRead( TEC1 ) )
+            {
+                vTaskDelay( 50 / portTICK_RATE_MS );
+            }
+        }
+    }
+}
+#endif
+
 /*==================[fin del archivo]========================================*/
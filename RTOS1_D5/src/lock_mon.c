@@ -0,0 +1,233 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+
+/*==================[inlcusiones]============================================*/
+#include <stdio.h>
+#include <string.h>
+#include "sapi.h"
+#include "FreeRTOS.h"
+#include "FreeRTOSConfig.h"
+#include "task.h"
+#include "semphr.h"
+
+#include "lock_mon.h"
+
+/* con LOCK_MON 0 el monitor no se compila */
+#if LOCK_MON==1
+
+/*==================[definiciones de datos internos]=========================*/
+static t_lock_mon*  locks[LOCK_MON_MAX_LOCKS];
+static uint32_t     n_locks;
+
+/*==================[declaraciones de funciones internas]====================*/
+static uint32_t cycles_to_us( uint64_t cycles );
+
+/*==================[definiciones de funciones externas]=====================*/
+
+/**
+   @brief   Agrega un semaforo o mutex ya creado al monitor. Las tomas y liberaciones
+            deben hacerse con lock_mon_take / lock_mon_give.
+ */
+void lock_mon_register( t_lock_mon* lock, const char* name, void* sem )
+{
+    memset( lock, 0, sizeof( *lock ) );
+    lock->name = name;
+    lock->sem = sem;
+
+    taskENTER_CRITICAL();
+    configASSERT( n_locks < LOCK_MON_MAX_LOCKS );
+    locks[n_locks++] = lock;
+    taskEXIT_CRITICAL();
+}
+
+/**
+   @brief   xSemaphoreTake instrumentado: registra quien tiene el recurso, cuanto se espero
+            y cierra el episodio de inversion si lo hubo.
+
+   @return  pdTRUE si se obtuvo el recurso
+ */
+int32_t lock_mon_take( t_lock_mon* lock, uint32_t timeout )
+{
+    uint32_t t0 = DWT->CYCCNT;
+    uint32_t waited = 0;
+    BaseType_t res;
+
+    res = xSemaphoreTake( ( SemaphoreHandle_t ) lock->sem, 0 );
+
+    if( res != pdTRUE && timeout > 0 )
+    {
+        UBaseType_t my_prio = uxTaskPriorityGet( NULL );
+
+        taskENTER_CRITICAL();
+        lock->waiters++;
+        if( my_prio > lock->waiter_prio )
+        {
+            lock->waiter_prio = my_prio;
+        }
+        lock->contended++;
+        taskEXIT_CRITICAL();
+
+        res = xSemaphoreTake( ( SemaphoreHandle_t ) lock->sem, timeout );
+        waited = DWT->CYCCNT - t0;
+
+        taskENTER_CRITICAL();
+        /* con varias esperando, la maxima prioridad se mantiene hasta que no quede ninguna */
+        if( --lock->waiters == 0 )
+        {
+            lock->waiter_prio = 0;
+        }
+
+        if( lock->inverted )
+        {
+            uint32_t d = DWT->CYCCNT - lock->inversion_start;
+
+            lock->inverted = 0;
+            lock->inversion_total += d;
+            if( d > lock->inversion_max )
+            {
+                lock->inversion_max = d;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    if( res == pdTRUE )
+    {
+        taskENTER_CRITICAL();
+        lock->holder = ( void* ) xTaskGetCurrentTaskHandle();
+        lock->holder_prio = uxTaskPriorityGet( NULL );
+        lock->takes++;
+        lock->block_total += waited;
+        if( waited > lock->block_max )
+        {
+            lock->block_max = waited;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return res;
+}
+
+/**
+   @brief   xSemaphoreGive instrumentado
+ */
+void lock_mon_give( t_lock_mon* lock )
+{
+    taskENTER_CRITICAL();
+    lock->holder = NULL;
+    lock->holder_prio = 0;
+    taskEXIT_CRITICAL();
+
+    xSemaphoreGive( ( SemaphoreHandle_t ) lock->sem );
+}
+
+/**
+   @brief   Total de episodios de inversion detectados en todos los recursos
+ */
+uint32_t lock_mon_inversions( void )
+{
+    uint32_t total = 0;
+
+    taskENTER_CRITICAL();
+    for( uint32_t i = 0; i < n_locks; i++ )
+    {
+        total += locks[i]->inversions;
+    }
+    taskEXIT_CRITICAL();
+
+    return total;
+}
+
+/**
+   @brief   Imprime las estadisticas de cada recurso. Tiempos en us.
+ */
+void lock_mon_report( void )
+{
+    for( uint32_t i = 0; i < n_locks; i++ )
+    {
+        t_lock_mon l;
+
+        taskENTER_CRITICAL();
+        l = *locks[i];
+        taskEXIT_CRITICAL();
+
+        printf( "%s: %u tomas, %u con espera, espera max %u us avg %u us\n", l.name, l.takes, l.contended,
+                cycles_to_us( l.block_max ), l.contended ? cycles_to_us( l.block_total / l.contended ) : 0 );
+        printf( "%s: %u inversiones de prioridad, max %u us total %u us\n", l.name, l.inversions,
+                cycles_to_us( l.inversion_max ), cycles_to_us( l.inversion_total ) );
+    }
+}
+
+/**
+   @brief   Hook del cambio de contexto (traceTASK_SWITCHED_IN). Corre en el PendSV, con
+            las interrupciones del kernel enmascaradas: solo compara y anota.
+ */
+void lock_mon_switched_in( void* task, uint32_t prio )
+{
+    for( uint32_t i = 0; i < n_locks; i++ )
+    {
+        t_lock_mon* l = locks[i];
+
+        if( l->waiters > 0 && l->holder != NULL && task != l->holder &&
+            prio > l->holder_prio && prio < l->waiter_prio && !l->inverted )
+        {
+            l->inverted = 1;
+            l->inversion_start = DWT->CYCCNT;
+            l->inversions++;
+        }
+    }
+}
+
+/**
+   @brief   Hook de herencia de prioridad (traceTASK_PRIORITY_INHERIT / DISINHERIT): la
+            prioridad efectiva del holder cambia.
+ */
+void lock_mon_priority_changed( void* task, uint32_t prio )
+{
+    for( uint32_t i = 0; i < n_locks; i++ )
+    {
+        if( locks[i]->holder == task )
+        {
+            locks[i]->holder_prio = prio;
+        }
+    }
+}
+
+/*==================[definiciones de funciones internas]=====================*/
+
+static uint32_t cycles_to_us( uint64_t cycles )
+{
+    return ( uint32_t )( cycles / ( SystemCoreClock / 1000000 ) );
+}
+
+#endif /* LOCK_MON==1 */
@@ -0,0 +1,205 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[inlcusiones]============================================*/
+#include <stdio.h>
+#include <string.h>
+#include "sapi.h"
+#include "FreeRTOS.h"
+#include "FreeRTOSConfig.h"
+#include "task.h"
+
+#include "trace_rec.h"
+
+/* con TRACE_REC 0 el grabador no se compila */
+#if TRACE_REC==1
+
+/*==================[definiciones y macros]==================================*/
+#define TRACE_REC_MASK          ( TRACE_REC_LEN - 1 )
+#define TRACE_REC_CALIBRATION   64      // eventos de prueba para medir el costo de registrar
+
+/*==================[definiciones de datos internos]=========================*/
+static t_trace_rec  trace_buffer[TRACE_REC_LEN];
+static uint32_t     trace_head;         // cantidad total de registros escritos
+static bool_t       trace_on;
+
+static char         trace_task_names[TRACE_REC_MAX_TASKS][configMAX_TASK_NAME_LEN];
+static uint8_t      trace_queue_types[TRACE_REC_MAX_QUEUES];
+static uint32_t     trace_n_queues;
+
+static uint32_t     trace_cost_min;     // ciclos por evento medidos en trace_rec_Init
+static uint32_t     trace_cost_max;
+
+/*==================[definiciones de funciones externas]=====================*/
+
+/**
+   @brief   Arranca el contador de ciclos, mide el costo de registrar un evento y habilita
+            el registro. Se llama antes de crear cualquier tarea o cola, para que sus
+            nombres queden en la tabla.
+ */
+void trace_rec_Init( void )
+{
+    uint32_t t0;
+    uint32_t dt;
+
+    cyclesCounterInit( SystemCoreClock );
+
+    trace_on = TRUE;
+    trace_cost_min = UINT32_MAX;
+    trace_cost_max = 0;
+
+    for( int i = 0; i < TRACE_REC_CALIBRATION; i++ )
+    {
+        t0 = DWT->CYCCNT;
+        trace_rec_event( 0, 0, 0 );
+        dt = DWT->CYCCNT - t0;
+
+        if( dt < trace_cost_min )
+        {
+            trace_cost_min = dt;
+        }
+        if( dt > trace_cost_max )
+        {
+            trace_cost_max = dt;
+        }
+    }
+
+    /* los eventos de calibracion no son parte de la traza */
+    trace_head = 0;
+}
+
+/**
+   @brief   Agrega un registro al buffer circular; al llenarse se pisan los mas viejos.
+            Los hooks de FreeRTOS ya corren con las interrupciones del kernel enmascaradas,
+            pero las ISRs de la aplicacion no: se enmascara igual (son pocos ciclos) para
+            que la reserva del lugar y la escritura no se intercalen.
+ */
+void trace_rec_event( uint8_t type, uint8_t a, uint16_t b )
+{
+    UBaseType_t mask;
+    t_trace_rec* r;
+
+    if( !trace_on )
+    {
+        return;
+    }
+
+    mask = portSET_INTERRUPT_MASK_FROM_ISR();
+
+    r = &trace_buffer[trace_head & TRACE_REC_MASK];
+    trace_head++;
+
+    r->time = DWT->CYCCNT;
+    r->type = type;
+    r->a    = a;
+    r->b    = b;
+
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( mask );
+}
+
+/* guarda una copia del nombre: la TCB puede liberarse antes del volcado */
+void trace_rec_task_create( uint32_t number, const char* name, uint32_t priority )
+{
+    if( number < TRACE_REC_MAX_TASKS )
+    {
+        strncpy( trace_task_names[number], name, configMAX_TASK_NAME_LEN - 1 );
+    }
+
+    trace_rec_event( TRACE_EV_TASK_CREATE, number, priority );
+}
+
+/* numera las colas (tambien semaforos y mutex) a medida que se crean */
+uint32_t trace_rec_queue_create( uint8_t type )
+{
+    uint32_t number = ++trace_n_queues;
+
+    if( number < TRACE_REC_MAX_QUEUES )
+    {
+        trace_queue_types[number] = type;
+    }
+
+    trace_rec_event( TRACE_EV_QUEUE_CREATE, number, type );
+
+    return number;
+}
+
+/**
+   @brief   Detiene el registro y vuelca la traza por la UART de printf, en texto:
+
+            TRACE <hz> <registros> <ciclos/evento min> <max>
+            T <numero> <nombre>             una linea por tarea
+            Q <numero> <tipo>               una linea por cola/semaforo/mutex
+            <time 8 hex><type 2 hex><a 2 hex><b 4 hex>     un registro por linea, del mas viejo al mas nuevo
+            END
+
+            tools/trace2perfetto.py convierte el volcado a JSON para Perfetto / chrome://tracing.
+ */
+void trace_rec_dump( void )
+{
+    uint32_t head;
+    uint32_t first;
+    t_trace_rec r;
+
+    trace_on = FALSE;
+    head  = trace_head;
+    first = ( head > TRACE_REC_LEN ) ? head - TRACE_REC_LEN : 0;
+
+    printf( "TRACE %u %u %u %u\r\n", SystemCoreClock, head - first, trace_cost_min, trace_cost_max );
+
+    for( int i = 0; i < TRACE_REC_MAX_TASKS; i++ )
+    {
+        if( trace_task_names[i][0] != 0 )
+        {
+            printf( "T %u %s\r\n", i, trace_task_names[i] );
+        }
+    }
+
+    for( uint32_t i = 1; i <= trace_n_queues && i < TRACE_REC_MAX_QUEUES; i++ )
+    {
+        printf( "Q %u %u\r\n", i, trace_queue_types[i] );
+    }
+
+    for( ; first < head; first++ )
+    {
+        r = trace_buffer[first & TRACE_REC_MASK];
+        printf( "%08X%02X%02X%04X\r\n", r.time, r.type, r.a, r.b );
+    }
+
+    printf( "END\r\n" );
+
+    trace_head = 0;
+    trace_on = TRUE;
+}
+
+#endif /* TRACE_REC==1 */
+
+/*==================[fin del archivo]========================================*/
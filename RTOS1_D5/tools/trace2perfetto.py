@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+# Copyright 2020, Franco Bucafusco
+# All rights reserved.
+#
+# Convierte el volcado de trace_rec_dump() (capturado de la UART a un archivo de texto)
+# a JSON de Chrome Trace Event, que abren ui.perfetto.dev y chrome://tracing.
+#
+# uso: trace2perfetto.py captura.txt > traza.json
+
+import json
+import sys
+
+EV_SWITCH_IN = 1
+EV_TASK_CREATE = 2
+EV_TASK_DELETE = 3
+EV_DELAY = 4
+EV_PRIO_INHERIT = 5
+EV_PRIO_DISINHERIT = 6
+EV_QUEUE_CREATE = 7
+EV_QUEUE_SEND = 8
+EV_QUEUE_RECEIVE = 9
+EV_QUEUE_BLOCK_SEND = 10
+EV_QUEUE_BLOCK_RECEIVE = 11
+EV_QUEUE_FAILED = 12
+EV_ISR_ENTER = 13
+EV_ISR_EXIT = 14
+EV_TICK = 15
+
+# queueQUEUE_TYPE_xxx de FreeRTOS
+QUEUE_TYPES = {0: "cola", 1: "mutex", 2: "sem contador", 3: "sem binario", 4: "mutex recursivo"}
+
+QUEUE_NAMES = {
+    EV_QUEUE_SEND: "send",
+    EV_QUEUE_RECEIVE: "receive",
+    EV_QUEUE_BLOCK_SEND: "bloqueo send",
+    EV_QUEUE_BLOCK_RECEIVE: "bloqueo receive",
+    EV_QUEUE_FAILED: "timeout",
+}
+
+PID = 1
+ISR_TID = 1000  # fila de las interrupciones
+
+
+def parse(lines):
+    hz = None
+    tasks = {}
+    queues = {}
+    records = []
+
+    for line in lines:
+        line = line.strip()
+        if line.startswith("TRACE "):
+            f = line.split()
+            hz = int(f[1])
+            sys.stderr.write("%s registros, %s..%s ciclos/evento (%.2f..%.2f us)\n" % (
+                f[2], f[3], f[4], int(f[3]) * 1e6 / hz, int(f[4]) * 1e6 / hz))
+            records = []
+        elif line.startswith("T "):
+            _, num, name = line.split(" ", 2)
+            tasks[int(num)] = name
+        elif line.startswith("Q "):
+            _, num, qtype = line.split()
+            queues[int(num)] = "%s %s" % (QUEUE_TYPES.get(int(qtype), "cola"), num)
+        elif line == "END":
+            break
+        elif hz is not None and len(line) == 16:
+            records.append((int(line[0:8], 16), int(line[8:10], 16),
+                            int(line[10:12], 16), int(line[12:16], 16)))
+
+    if hz is None:
+        sys.exit("no se encontro la linea TRACE")
+
+    return hz, tasks, queues, records
+
+
+def unwrap(records):
+    """el contador de ciclos es de 32 bits: se reconstruye un tiempo monotono"""
+    offset = 0
+    last = None
+    for time, kind, a, b in records:
+        if last is not None and time < last:
+            offset += 1 << 32
+        last = time
+        yield time + offset, kind, a, b
+
+
+def convert(hz, tasks, queues, records):
+    events = []
+    us = 1e6 / hz
+    running = None
+    running_since = None
+    t0 = None
+
+    def task_name(num):
+        return tasks.get(num, "tarea %d" % num)
+
+    for num, name in tasks.items():
+        events.append({"ph": "M", "pid": PID, "tid": num, "name": "thread_name", "args": {"name": name}})
+    events.append({"ph": "M", "pid": PID, "tid": ISR_TID, "name": "thread_name", "args": {"name": "ISR"}})
+
+    for time, kind, a, b in unwrap(records):
+        if t0 is None:
+            t0 = time
+        ts = (time - t0) * us
+
+        if kind == EV_SWITCH_IN:
+            if running is not None and running != a:
+                events.append({"ph": "X", "pid": PID, "tid": running, "name": task_name(running),
+                               "ts": running_since, "dur": ts - running_since})
+            if running != a:
+                running = a
+                running_since = ts
+        elif kind in QUEUE_NAMES:
+            tid = running if running is not None else 0
+            qname = queues.get(a, "cola %d" % a)
+            if kind == EV_QUEUE_FAILED:
+                args = {"op": "receive" if b else "send"}
+            else:
+                args = {"isr": b}
+            events.append({"ph": "i", "s": "t", "pid": PID, "tid": tid, "ts": ts,
+                           "name": "%s %s" % (qname, QUEUE_NAMES[kind]), "args": args})
+        elif kind == EV_PRIO_INHERIT:
+            events.append({"ph": "i", "s": "p", "pid": PID, "tid": a, "ts": ts,
+                           "name": "%s hereda prioridad %d" % (task_name(a), b)})
+        elif kind == EV_PRIO_DISINHERIT:
+            events.append({"ph": "i", "s": "p", "pid": PID, "tid": a, "ts": ts,
+                           "name": "%s vuelve a prioridad %d" % (task_name(a), b)})
+        elif kind == EV_TASK_CREATE:
+            events.append({"ph": "i", "s": "t", "pid": PID, "tid": a, "ts": ts,
+                           "name": "creada (prioridad %d)" % b})
+        elif kind == EV_TASK_DELETE:
+            events.append({"ph": "i", "s": "t", "pid": PID, "tid": a, "ts": ts, "name": "borrada"})
+        elif kind == EV_DELAY and running is not None:
+            events.append({"ph": "i", "s": "t", "pid": PID, "tid": running, "ts": ts, "name": "delay"})
+        elif kind == EV_ISR_ENTER:
+            events.append({"ph": "B", "pid": PID, "tid": ISR_TID, "ts": ts, "name": "ISR %d" % a})
+        elif kind == EV_ISR_EXIT:
+            events.append({"ph": "E", "pid": PID, "tid": ISR_TID, "ts": ts})
+        elif kind == EV_TICK:
+            events.append({"ph": "i", "s": "t", "pid": PID, "tid": ISR_TID, "ts": ts, "name": "tick"})
+
+    if running is not None and t0 is not None:
+        events.append({"ph": "X", "pid": PID, "tid": running, "name": task_name(running),
+                       "ts": running_since, "dur": ts - running_since})
+
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("uso: trace2perfetto.py captura.txt > traza.json")
+
+    with open(sys.argv[1], errors="replace") as f:
+        hz, tasks, queues, records = parse(f)
+
+    json.dump(convert(hz, tasks, queues, records), sys.stdout, indent=0)
+
+
+if __name__ == "__main__":
+    main()
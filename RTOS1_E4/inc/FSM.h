@@ -16,6 +16,10 @@
 #include "semphr.h"
 /*==================[definiciones y macros]==================================*/
 #define DEBOUNCE_TIME 40
+
+// 1: una sola tarea antirrebotea todas las teclas con contadores verticales (vc_debounce.c)
+// 0: una tarea por tecla con la FSM de fsm_debounce.c
+#define USE_VC_DEBOUNCE 1
 /*==================[definiciones de datos]=========================*/
 // Tipo de dato FSM
 typedef enum
@@ -55,13 +55,13 @@ extern int DbgConsole_Printf( const char *fmt_s, ... );
 #define configUSE_PREEMPTION                         1
 #define configUSE_IDLE_HOOK                          0
 #define configUSE_TICK_HOOK                          0
-#define configUSE_TICKLESS_IDLE                      0
+#define configUSE_TICKLESS_IDLE                      1
 #define configUSE_DAEMON_TASK_STARTUP_HOOK           0
 #define configCPU_CLOCK_HZ                           ( SystemCoreClock )
 #define configTICK_RATE_HZ                           ( ( TickType_t ) 1000 ) // 1000 ticks per second => 1ms tick rate
 #define configMAX_PRIORITIES                         ( 7 )
 #define configMINIMAL_STACK_SIZE                     ( ( uint16_t ) 90 )
-#define configTOTAL_HEAP_SIZE                        ( ( size_t ) ( 8 * 1024 ) )    /* 8Kbytes. */
+#define configTOTAL_HEAP_SIZE                        ( ( size_t ) ( 10 * 1024 ) )   /* 10Kbytes: suma el stack de tarea_vc_stats. */
 #define configMAX_TASK_NAME_LEN                      ( 16 )
 #define configUSE_TRACE_FACILITY                     1
 #define configUSE_16_BIT_TICKS                       0
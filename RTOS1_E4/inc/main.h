@@ -22,6 +22,8 @@
 #define UART UART_USB
 
 #define MSG_TECLA	"tarea_tecla_"
+#define MSG_TECLAS	"tarea_teclas"
+#define MSG_VC_STATS	"tarea_vc_stats"
 #define MSG_LED     "tarea_led_"
 
 #endif /* _MAIN_H_ */
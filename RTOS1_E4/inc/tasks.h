@@ -17,11 +17,13 @@
 #include "auxs.h"
 #include "FreeRTOSConfig.h"
 #include "FSM.h"
+#include "vc_debounce.h"
 
 /*==================[definiciones y macros]==================================*/
 #define LED_RATE_MS 40
 #define MAX_RATE_MS 3000
 #define BUTTON_RATE_MS 1
+#define VC_STATS_RATE_MS 10000		// cada cuanto se informan los muestreos y despertares por segundo
 
 #define LED_RATE pdMS_TO_TICKS(LED_RATE_MS)
 #define MAX_RATE pdMS_TO_TICKS(MAX_RATE_MS)
@@ -30,9 +32,12 @@
 extern gpioMap_t teclas[];
 extern gpioMap_t leds[];
 extern tLedTecla tecla_led_config[];
+extern const uint16_t n_teclas;
 /*==================[prototipos de tareas]====================*/
 void tarea_led_a( void* taskParmPtr );
 void tarea_led_b( void* taskParmPtr );
 void tarea_tecla( void* taskParmPtr );
+void tarea_teclas( void* taskParmPtr );
+void tarea_vc_stats( void* taskParmPtr );
 
 #endif /* _Tasks_H_ */
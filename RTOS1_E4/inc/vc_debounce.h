@@ -0,0 +1,65 @@
+/*=============================================================================
+ * Copyright (c) 2020, Martin N. Menendez <menendezmartin81@gmail.com>
+ * All rights reserved.
+ * License: Free
+ * Date: 2020/09/03
+ * Version: v1.1
+ *===========================================================================*/
+#ifndef _VC_DEBOUNCE_H_
+#define _VC_DEBOUNCE_H_
+
+/*==================[inclusiones]============================================*/
+#include "FreeRTOSConfig.h"
+#include "FreeRTOS.h"
+#include "sapi.h"
+#include "FSM.h"
+/*==================[definiciones y macros]==================================*/
+#define VC_PORTS            8       // puertos GPIO del LPC4337
+#define VC_MAX_KEYS         32
+
+/* el contador vertical de 2 bits cambia el estado luego de 4 muestras iguales,
+   por lo que se muestrea a DEBOUNCE_TIME/4 para mantener la ventana de 40 ms */
+#define VC_SAMPLES          4
+#define VC_SAMPLE_RATE_MS   ( DEBOUNCE_TIME / VC_SAMPLES )
+#define VC_SAMPLE_RATE      pdMS_TO_TICKS(VC_SAMPLE_RATE_MS)
+
+/* 1: con todas las teclas estables la tarea no muestrea: queda bloqueada sin timeout
+   hasta que una PININT detecta un flanco, y el kernel puede suprimir el tick (tickless).
+   0: se muestrea cada VC_SAMPLE_RATE_MS siempre */
+#define VC_USE_WAKEUP       1
+#define VC_WAKE_CHANNELS    4       // canales PININT 0..3, uno por tecla (GPIO0..3_IRQHandler)
+/*==================[definiciones de datos]=========================*/
+// Contadores verticales de un puerto: un bit por pin
+typedef struct
+{
+	uint32_t mask;				// pines del puerto asociados a teclas
+	uint32_t state;				// nivel antirreboteado de cada pin
+	uint32_t cnt0;				// bit 0 del contador de cada pin
+	uint32_t cnt1;				// bit 1 del contador de cada pin
+} tVcPort;
+
+// Ubicacion de una tecla dentro de los puertos
+typedef struct
+{
+	uint8_t port;
+	uint32_t bit;
+	tLedTecla* config;
+} tVcKey;
+
+// Contadores para comparar el modo por interrupcion contra el muestreo continuo
+typedef struct
+{
+	uint32_t scans;				// muestreos de los puertos
+	uint32_t wakeups;			// veces que un flanco desperto a la tarea
+} tVcStats;
+
+/*==================[prototipos de funciones]====================*/
+uint32_t vcDebounceUpdate( tVcPort* vc, uint32_t sample );
+
+void vcDebounceInit( tLedTecla* config, uint16_t n );
+void vcDebounceScan( void );
+bool_t vcDebounceIdle( void );
+void vcDebounceWait( void );
+void vcDebounceGetStats( tVcStats* stats );
+
+#endif /* _VC_DEBOUNCE_H_ */
@@ -19,6 +19,7 @@ gpioMap_t leds[]   = {LEDB,LED1,LED2,LED3};
 #define N_TECLAS  sizeof(teclas)/sizeof(gpioMap_t)		// 4 * (gpioMap_t / gpioMap_t) = 4
 
 tLedTecla tecla_led_config[N_TECLAS];
+const uint16_t n_teclas = N_TECLAS;
 
 /*==================[declaraciones de funciones internas]====================*/
 
@@ -8,6 +8,13 @@
 
 /*==================[inclusiones]============================================*/
 #include "FSM.h"
+/*==================[definiciones y macros]==================================*/
+#if USE_VC_DEBOUNCE==1
+// una sola tarea atiende todas las teclas: no puede quedar bloqueada por la cola de una de ellas
+#define QUEUE_WAIT	0
+#else
+#define QUEUE_WAIT	portMAX_DELAY
+#endif
 /*==================[prototipos]============================================*/
 
 void fsmButtonError( tLedTecla* config );
@@ -30,7 +37,7 @@ void buttonReleased( tLedTecla* config )
 	config->tiempo_medido = xTaskGetTickCount() - config->tiempo_down;
 
 	if (config->tiempo_medido > 0)
-			xQueueSend( config->queue_tec_pulsada , &(config->tiempo_medido),  portMAX_DELAY  );
+			xQueueSend( config->queue_tec_pulsada , &(config->tiempo_medido),  QUEUE_WAIT  );
 	}
 
 void fsmButtonError( tLedTecla* config )
@@ -33,7 +33,12 @@ int main( void )
 	tecla_led_init();							// Inicializar estructura de datos
 
 	 // Crear y validar tarea en freeRTOS
+#if USE_VC_DEBOUNCE==1
+	tarea_crear(tarea_teclas,MSG_TECLAS,SIZE,NULL,PRIORITY,NULL);	// Tarea unica de teclas
+	tarea_crear(tarea_vc_stats,MSG_VC_STATS,4,NULL,PRIORITY,NULL);	// Muestreos/despertares por segundo (printf)
+#else
 	tareas_crear(tarea_tecla,MSG_TECLA);		 // Tareas de teclas
+#endif
 	tareas_crear(tarea_led_a,MSG_LED);			 // Tareas de leds
 	tareas_crear(tarea_led_b,MSG_LED);			 // Tareas de leds
 
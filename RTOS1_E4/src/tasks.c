@@ -33,6 +33,49 @@ void tarea_tecla( void* taskParmPtr )
 	}
 }
 
+// Unica tarea de muestreo: antirrebota todas las teclas leyendo los puertos GPIO completos
+void tarea_teclas( void* taskParmPtr )
+{
+	TickType_t xLastWakeTime = xTaskGetTickCount();
+
+	vcDebounceInit( tecla_led_config , n_teclas );
+
+	while( TRUE )
+	{
+		// Sin cambios en curso no hay nada que muestrear: se espera un flanco sin timeout
+		if( vcDebounceIdle() )
+		{
+			vcDebounceWait();
+			xLastWakeTime = xTaskGetTickCount();
+		}
+
+		vcDebounceScan();
+		vTaskDelayUntil( &xLastWakeTime , VC_SAMPLE_RATE );
+	}
+}
+
+// Informa por la UART cuantas veces por segundo se despierta tarea_teclas: con VC_USE_WAKEUP 0
+// son todos muestreos periodicos; con 1 deberian quedar solo los de cada pulsacion
+void tarea_vc_stats( void* taskParmPtr )
+{
+	TickType_t xLastWakeTime = xTaskGetTickCount();
+	tVcStats last = { 0 };
+	tVcStats now;
+
+	while( TRUE )
+	{
+		vTaskDelayUntil( &xLastWakeTime , pdMS_TO_TICKS( VC_STATS_RATE_MS ) );
+
+		vcDebounceGetStats( &now );
+
+		printf( "teclas: %u muestreos/s, %u despertares por flanco/s (VC_USE_WAKEUP %u)\r\n",
+				( now.scans - last.scans ) * 1000 / VC_STATS_RATE_MS,
+				( now.wakeups - last.wakeups ) * 1000 / VC_STATS_RATE_MS, VC_USE_WAKEUP );
+
+		last = now;
+	}
+}
+
 void tarea_led_a( void* taskParmPtr )
 {
     // ---------- CONFIGURACIONES ------------------------------
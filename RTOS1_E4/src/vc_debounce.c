@@ -0,0 +1,281 @@
+/*=============================================================================
+ * Copyright (c) 2020, Martin N. Menendez <menendezmartin81@gmail.com>
+ * All rights reserved.
+ * License: Free
+ * Date: 2020/09/03
+ * Version: v1.1
+ *===========================================================================*/
+
+/*==================[inclusiones]============================================*/
+#include "vc_debounce.h"
+/*==================[definiciones de datos internos]=========================*/
+static tVcPort vc_ports[VC_PORTS];
+static tVcKey  vc_keys[VC_MAX_KEYS];
+static uint16_t vc_n_keys;
+
+static uint8_t vc_used_ports[VC_PORTS];		// solo se leen los puertos que tienen teclas
+static uint8_t vc_n_ports;
+
+static tVcStats vc_stats;
+
+#if VC_USE_WAKEUP==1
+static SemaphoreHandle_t vc_wakeup;			// lo entrega la PININT de cualquier tecla
+static bool_t vc_wakeup_ok;					// FALSE si hay mas teclas que canales: se muestrea siempre
+#endif
+
+/*==================[definiciones de datos externos]=========================*/
+extern pinInitGpioLpc4337_t gpioPinsInit[];
+
+/*==================[declaraciones de funciones internas]====================*/
+#if VC_USE_WAKEUP==1
+static void vcWakeupConfig( void );
+static void vcWakeupEnable( void );
+static void vcWakeupDisable( void );
+static void vcWakeupIsr( uint8_t ch );
+#endif
+
+/*==================[funciones]============================================*/
+
+/* Antirrebote de hasta 32 pines en paralelo con contadores verticales de 2 bits.
+   Cada pin cuyo nivel difiere del estado antirreboteado incrementa su contador;
+   si coincide, el contador vuelve a 0. Al completar VC_SAMPLES muestras distintas
+   seguidas el pin cambia de estado. Devuelve la mascara de pines que cambiaron. */
+uint32_t vcDebounceUpdate( tVcPort* vc, uint32_t sample )
+{
+	uint32_t delta = ( sample ^ vc->state ) & vc->mask;
+	uint32_t toggle;
+
+	vc->cnt1 = ( vc->cnt1 ^ vc->cnt0 ) & delta;
+	vc->cnt0 = ~vc->cnt0 & delta;
+
+	toggle = delta & ~( vc->cnt0 | vc->cnt1 );
+	vc->state ^= toggle;
+
+	return toggle;
+}
+
+void vcDebounceInit( tLedTecla* config, uint16_t n )
+{
+	uint16_t i;
+	uint8_t port;
+
+	vc_n_keys  = 0;
+	vc_n_ports = 0;
+
+	for( i = 0 ; i < n && i < VC_MAX_KEYS ; i++ )
+	{
+		port = gpioPinsInit[config[i].tecla].gpio.port;
+
+		vc_keys[i].port   = port;
+		vc_keys[i].bit    = 1UL << gpioPinsInit[config[i].tecla].gpio.pin;
+		vc_keys[i].config = &config[i];
+
+		if( vc_ports[port].mask == 0 )
+		{
+			vc_used_ports[vc_n_ports++] = port;
+		}
+
+		vc_ports[port].mask |= vc_keys[i].bit;
+
+		fsmButtonInit( &config[i] );
+		vc_n_keys++;
+	}
+
+	// el estado inicial es el nivel actual de los pines (teclas sueltas = 1)
+	for( i = 0 ; i < vc_n_ports ; i++ )
+	{
+		port = vc_used_ports[i];
+		vc_ports[port].state = Chip_GPIO_GetPortValue( LPC_GPIO_PORT, port ) & vc_ports[port].mask;
+		vc_ports[port].cnt0  = 0;
+		vc_ports[port].cnt1  = 0;
+	}
+
+#if VC_USE_WAKEUP==1
+	vc_wakeup_ok = ( vc_n_keys <= VC_WAKE_CHANNELS );
+	if( vc_wakeup_ok )
+	{
+		vc_wakeup = xSemaphoreCreateBinary();
+		configASSERT( vc_wakeup != NULL );
+		vcWakeupConfig();
+	}
+#endif
+}
+
+// Lee todos los puertos con teclas de una vez y despacha los eventos de las que cambiaron
+void vcDebounceScan( void )
+{
+	uint16_t i;
+	uint16_t k;
+	uint8_t port;
+	uint32_t toggle;
+
+	vc_stats.scans++;
+
+	for( i = 0 ; i < vc_n_ports ; i++ )
+	{
+		port   = vc_used_ports[i];
+		toggle = vcDebounceUpdate( &vc_ports[port], Chip_GPIO_GetPortValue( LPC_GPIO_PORT, port ) );
+
+		if( toggle == 0 )
+		{
+			continue;		// caso habitual: ninguna tecla de este puerto cambio
+		}
+
+		for( k = 0 ; k < vc_n_keys ; k++ )
+		{
+			if( vc_keys[k].port == port && ( toggle & vc_keys[k].bit ) )
+			{
+				// las teclas son activas en bajo
+				if( vc_ports[port].state & vc_keys[k].bit )
+				{
+					vc_keys[k].config->fsmButtonState = STATE_BUTTON_UP;
+					buttonReleased( vc_keys[k].config );
+				}
+				else
+				{
+					vc_keys[k].config->fsmButtonState = STATE_BUTTON_DOWN;
+					buttonPressed( vc_keys[k].config );
+				}
+			}
+		}
+	}
+}
+
+// TRUE si ninguna tecla esta en medio de un cambio: todos los contadores verticales en 0
+bool_t vcDebounceIdle( void )
+{
+#if VC_USE_WAKEUP==1
+	uint16_t i;
+	uint8_t port;
+
+	if( !vc_wakeup_ok )
+	{
+		return FALSE;
+	}
+
+	for( i = 0 ; i < vc_n_ports ; i++ )
+	{
+		port = vc_used_ports[i];
+		if( vc_ports[port].cnt0 | vc_ports[port].cnt1 )
+		{
+			return FALSE;
+		}
+	}
+	return TRUE;
+#else
+	return FALSE;					// sin interrupciones no hay con que despertar: se muestrea siempre
+#endif
+}
+
+/* Bloquea a la tarea sin timeout hasta el proximo flanco de cualquier tecla.
+   Se habilitan las interrupciones y recien despues se compara el nivel de los pines
+   con el estado antirreboteado: un flanco ocurrido entre el ultimo muestreo y la
+   habilitacion no se pierde, porque el pin ya difiere y no se espera. */
+void vcDebounceWait( void )
+{
+#if VC_USE_WAKEUP==1
+	uint16_t i;
+	uint8_t port;
+
+	vcWakeupEnable();
+
+	for( i = 0 ; i < vc_n_ports ; i++ )
+	{
+		port = vc_used_ports[i];
+		if( ( Chip_GPIO_GetPortValue( LPC_GPIO_PORT, port ) ^ vc_ports[port].state ) & vc_ports[port].mask )
+		{
+			vcWakeupDisable();
+			return;
+		}
+	}
+
+	xSemaphoreTake( vc_wakeup , portMAX_DELAY );
+	vc_stats.wakeups++;
+#endif
+}
+
+void vcDebounceGetStats( tVcStats* stats )
+{
+	taskENTER_CRITICAL();
+	*stats = vc_stats;
+	taskEXIT_CRITICAL();
+}
+
+#if VC_USE_WAKEUP==1
+/*==================[funciones internas]=====================================*/
+
+// Un canal PININT por tecla, sensible a ambos flancos. Quedan deshabilitados hasta vcDebounceWait
+static void vcWakeupConfig( void )
+{
+	uint16_t k;
+
+	Chip_PININT_Init( LPC_GPIO_PIN_INT );
+
+	for( k = 0 ; k < vc_n_keys ; k++ )
+	{
+		Chip_SCU_GPIOIntPinSel( k, gpioPinsInit[vc_keys[k].config->tecla].gpio.port, gpioPinsInit[vc_keys[k].config->tecla].gpio.pin );
+		Chip_PININT_SetPinModeEdge( LPC_GPIO_PIN_INT, PININTCH( k ) );
+		Chip_PININT_EnableIntLow( LPC_GPIO_PIN_INT, PININTCH( k ) );
+		Chip_PININT_EnableIntHigh( LPC_GPIO_PIN_INT, PININTCH( k ) );
+
+		NVIC_SetPriority( ( IRQn_Type )( PIN_INT0_IRQn + k ), configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY );
+	}
+}
+
+static void vcWakeupEnable( void )
+{
+	uint16_t k;
+
+	for( k = 0 ; k < vc_n_keys ; k++ )
+	{
+		Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH( k ) );
+		NVIC_ClearPendingIRQ( ( IRQn_Type )( PIN_INT0_IRQn + k ) );
+		NVIC_EnableIRQ( ( IRQn_Type )( PIN_INT0_IRQn + k ) );
+	}
+}
+
+static void vcWakeupDisable( void )
+{
+	uint16_t k;
+
+	for( k = 0 ; k < vc_n_keys ; k++ )
+	{
+		NVIC_DisableIRQ( ( IRQn_Type )( PIN_INT0_IRQn + k ) );
+	}
+}
+
+// Primer flanco: se deshabilitan las interrupciones (el rebote las dispararia de nuevo)
+// y el antirrebote vuelve a muestrear hasta que todas las teclas se estabilicen
+static void vcWakeupIsr( uint8_t ch )
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH( ch ) );
+
+	vcWakeupDisable();
+
+	xSemaphoreGiveFromISR( vc_wakeup , &xHigherPriorityTaskWoken );
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+void GPIO0_IRQHandler( void )
+{
+	vcWakeupIsr( 0 );
+}
+
+void GPIO1_IRQHandler( void )
+{
+	vcWakeupIsr( 1 );
+}
+
+void GPIO2_IRQHandler( void )
+{
+	vcWakeupIsr( 2 );
+}
+
+void GPIO3_IRQHandler( void )
+{
+	vcWakeupIsr( 3 );
+}
+#endif
@@ -44,7 +44,7 @@
 #define configTICK_RATE_HZ                           ( ( TickType_t ) 1000 ) // 1000 ticks per second => 1ms tick rate
 #define configMAX_PRIORITIES                         ( 7 )
 #define configMINIMAL_STACK_SIZE                     90
-#define configTOTAL_HEAP_SIZE                        ( ( size_t ) ( 8 * 1024 ) )    /* 8Kbytes. */
+#define configTOTAL_HEAP_SIZE                        ( ( size_t ) ( 12 * 1024 ) )   /* 12Kbytes: JOBS_BENCH con 16 tareas (ver jobs_bench.h) */
 #define configMAX_TASK_NAME_LEN                      ( 16 )
 #define configUSE_TRACE_FACILITY                     0
 #define configUSE_16_BIT_TICKS                       0
@@ -0,0 +1,77 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef JOBS_H_
+#define JOBS_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* public macros ================================================================= */
+
+/* trabajos periodicos que puede multiplexar el ejecutivo */
+#define JOBS_MAX            64
+
+/* stack de la tarea del ejecutivo: los callbacks corren sobre el */
+#define JOBS_TASK_STACK     ( configMINIMAL_STACK_SIZE*2 )
+
+/* types ================================================================= */
+struct t_job;
+
+/* Se ejecuta en la tarea del ejecutivo: no debe bloquearse, porque demoraria a todos los
+   demas trabajos. Puede cambiar su propio periodo con jobs_set_period. */
+typedef void ( *t_job_callback )( struct t_job* job );
+
+typedef struct t_job
+{
+    const char*     name;
+    t_job_callback  callback;
+    void*           param;
+    TickType_t      period;
+    TickType_t      release;        //proximo release (tick absoluto)
+
+    /* estadisticas, en us */
+    uint32_t        runs;
+    uint32_t        overruns;       //releases que se saltearon por atraso
+    uint32_t        jitter_max;     //inicio del callback - release
+    uint64_t        jitter_sum;
+} t_job;
+
+/* methods ================================================================= */
+void jobs_Init( UBaseType_t priority );
+void jobs_add( t_job* job, const char* name, TickType_t period, TickType_t phase, t_job_callback callback, void* param );
+void jobs_set_period( t_job* job, TickType_t period );
+void jobs_report( void );
+uint32_t jobs_now_us( void );
+
+#endif /* JOBS_H_ */
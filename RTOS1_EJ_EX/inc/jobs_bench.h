@@ -0,0 +1,71 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef JOBS_BENCH_H_
+#define JOBS_BENCH_H_
+
+/* public macros ================================================================= */
+
+/* 1: en lugar de la aplicacion se corre la comparacion de jitter entre el ejecutivo de
+   trabajos y una tarea por trabajo. 0: aplicacion normal */
+#define JOBS_BENCH              0
+
+#define JOBS_BENCH_N            16      //trabajos: 4, 16 o 64
+#define JOBS_BENCH_USE_TASKS    0       //1: una tarea por trabajo, 0: ejecutivo
+#define JOBS_BENCH_PERIOD_MS    10      //todos con el mismo periodo y fase: peor caso de jitter
+#define JOBS_BENCH_SECONDS      10      //duracion de la medicion
+
+/* stack de cada tarea en la version de una tarea por trabajo */
+#define JOBS_BENCH_TASK_STACK   configMINIMAL_STACK_SIZE
+
+/* heap que consume la comparacion (heap_1 redondea cada pedido a 8 bytes): cada tarea pide
+   su stack y su TCB, mas la tarea report y la idle. Con JOBS_BENCH_USE_TASKS 1 son unos
+   470 bytes por trabajo: 16 trabajos entran en los 12 KB de FreeRTOSConfig.h, 64 piden
+   unos 32 KB. jobs_bench.c lo verifica en compilacion */
+#define JOBS_BENCH_ALLOC( bytes )   ( ( ( bytes ) + 7 ) & ~7 )
+#define JOBS_BENCH_TASK_HEAP( depth ) \
+    ( JOBS_BENCH_ALLOC( ( depth ) * sizeof( StackType_t ) ) + JOBS_BENCH_ALLOC( sizeof( StaticTask_t ) ) )
+
+#if JOBS_BENCH_USE_TASKS==1
+#define JOBS_BENCH_HEAP     ( JOBS_BENCH_N * JOBS_BENCH_TASK_HEAP( JOBS_BENCH_TASK_STACK ) )
+#else
+#define JOBS_BENCH_HEAP     JOBS_BENCH_TASK_HEAP( JOBS_TASK_STACK )
+#endif
+
+#define JOBS_BENCH_HEAP_TOTAL \
+    ( JOBS_BENCH_HEAP + JOBS_BENCH_TASK_HEAP( configMINIMAL_STACK_SIZE*2 ) + JOBS_BENCH_TASK_HEAP( configMINIMAL_STACK_SIZE ) + portBYTE_ALIGNMENT )
+
+/* methods ================================================================= */
+void jobs_bench_Init( void );
+
+#endif /* JOBS_BENCH_H_ */
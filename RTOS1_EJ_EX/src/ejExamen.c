@@ -37,19 +37,49 @@
 
 #include "sapi.h"
 #include "keys.h"
+#include "jobs.h"
+#include "jobs_bench.h"
 
 /*=====[Definition & macros of public constants]==============================*/
 
+/* 1: los cuatro blinks son trabajos de un unico ejecutivo (jobs.c)
+   0: una tarea por blink */
+#define LEDS_USE_JOBS   1
+
 /*=====[Definitions of extern global functions]==============================*/
 
+#if LEDS_USE_JOBS==1
+void led_job( t_job* job );
+#else
 // Prototipo de funcion de la tarea
 void task_led1( void* taskParmPtr );
 void task_led2( void* taskParmPtr );
 void task_led3( void* taskParmPtr );
 void task_led4( void* taskParmPtr );
+#endif
 
 /*=====[Definitions of public global variables]==============================*/
 
+#if LEDS_USE_JOBS==1
+typedef struct
+{
+    gpioMap_t led;
+    uint32_t tecla;
+} t_led_config;
+
+static const t_led_config led_config[] =
+{
+    { LEDB, TEC1_INDEX },
+    { LED1, TEC2_INDEX },
+    { LED2, TEC3_INDEX },
+    { LED3, TEC4_INDEX },
+};
+
+#define led_count   sizeof(led_config)/sizeof(led_config[0])
+
+static t_job led_jobs[led_count];
+#endif
+
 /*=====[Main function, program entry point after power on or reset]==========*/
 
 int main( void )
@@ -61,6 +91,20 @@ int main( void )
 
     printf( "Ejercicio de ejemplo examen\n" );
 
+#if JOBS_BENCH==1
+    jobs_bench_Init();
+#elif LEDS_USE_JOBS==1
+    /* una sola tarea para los cuatro blinks */
+    jobs_Init( tskIDLE_PRIORITY+1 );
+
+    for( uint32_t i = 0 ; i < led_count ; i++ )
+    {
+        jobs_add( &led_jobs[i], "led", pdMS_TO_TICKS( 500 ), 0, led_job, ( void* ) &led_config[i] );
+    }
+
+    /* inicializo driver de teclas */
+    keys_Init();
+#else
     // Crear tareas en freeRTOS
     res = xTaskCreate (
               task_led1,					// Funcion de la tarea a ejecutar
@@ -103,6 +147,8 @@ int main( void )
     /* inicializo driver de teclas */
     keys_Init();
 
+#endif
+
     // Iniciar scheduler
     vTaskStartScheduler();					// Enciende tick | Crea idle y pone en ready | Evalua las tareas creadas | Prioridad mas alta pasa a running
 
@@ -111,6 +157,29 @@ int main( void )
     return 0;
 }
 
+#if LEDS_USE_JOBS==1
+/* El periodo del trabajo es dif: cada ejecucion alterna encendido y apagado, como el par
+   vTaskDelay( dif ) / vTaskDelayUntil( 2*dif ) de la version con tareas. El nuevo dif se
+   toma al encender, y rige desde ese mismo encendido. */
+void led_job( t_job* job )
+{
+    const t_led_config* config = ( const t_led_config* ) job->param;
+
+    if( job->runs % 2 == 0 )
+    {
+        if( key_pressed( config->tecla ) )
+        {
+            jobs_set_period( job, get_diff( config->tecla ) );
+        }
+
+        gpioWrite( config->led, ON );
+    }
+    else
+    {
+        gpioWrite( config->led, OFF );
+    }
+}
+#else
 void task_led1( void* taskParmPtr )
 {
     TickType_t dif =   pdMS_TO_TICKS( 500 );
@@ -209,6 +278,8 @@ void task_led4( void* taskParmPtr )
         vTaskDelayUntil( &xLastWakeTime, 2*dif );
     }
 }
+#endif
+
 /* hook que se ejecuta si al necesitar un objeto dinamico, no hay memoria disponible */
 void vApplicationMallocFailedHook()
 {
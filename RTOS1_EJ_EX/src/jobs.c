@@ -0,0 +1,304 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*=====[Inclusions of function dependencies]=================================*/
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sapi.h"
+#include "jobs.h"
+
+/*
+ * Ejecutivo de trabajos periodicos: una sola tarea corre todos los trabajos. Los trabajos
+ * se ordenan en un min-heap por proximo release; la tarea duerme hasta el release mas
+ * cercano, corre en orden los trabajos vencidos y los vuelve a insertar con el release
+ * siguiente. El costo por trabajo es un t_job (~40 bytes) en lugar de un TCB y un stack.
+ */
+
+/*=====[Definition macros of private constants]==============================*/
+#define US_PER_TICK     ( 1000000 / configTICK_RATE_HZ )
+
+/* comparacion de ticks que tolera el desborde del contador */
+#define BEFORE( a, b )  ( ( int32_t )( ( a ) - ( b ) ) < 0 )
+
+/*=====[Definitions of private global variables]=============================*/
+static t_job* heap[JOBS_MAX];
+static uint32_t heap_count;
+
+static t_job* registry[JOBS_MAX];       //todos los trabajos, para jobs_report
+static uint32_t registry_count;
+
+static TaskHandle_t jobs_task_handle;
+
+/*=====[Prototypes (declarations) of private functions]======================*/
+static void jobs_task( void* taskParmPtr );
+static void heap_push( t_job* job );
+static t_job* heap_pop( void );
+
+/*=====[Implementations of public functions]=================================*/
+
+/**
+   @brief   Crea la tarea del ejecutivo. Los trabajos se pueden agregar antes o despues.
+
+   @param priority  prioridad de la tarea (la de todos los trabajos)
+ */
+void jobs_Init( UBaseType_t priority )
+{
+    BaseType_t res;
+
+    res = xTaskCreate (
+              jobs_task,                    // Funcion de la tarea a ejecutar
+              ( const char * )"jobs",       // Nombre de la tarea como String amigable para el usuario
+              JOBS_TASK_STACK,              // Cantidad de stack de la tarea
+              0,                            // Parametros de tarea
+              priority,                     // Prioridad de la tarea
+              &jobs_task_handle             // Puntero a la tarea creada en el sistema
+          );
+
+    // Gestión de errores
+    configASSERT( res == pdPASS );
+}
+
+/**
+   @brief   Registra un trabajo periodico
+
+   @param job
+   @param name
+   @param period    en ticks
+   @param phase     primer release, en ticks desde ahora
+   @param callback
+   @param param     queda en job->param para el callback
+ */
+void jobs_add( t_job* job, const char* name, TickType_t period, TickType_t phase, t_job_callback callback, void* param )
+{
+    job->name       = name;
+    job->callback   = callback;
+    job->param      = param;
+    job->period     = period;
+    job->runs       = 0;
+    job->overruns   = 0;
+    job->jitter_max = 0;
+    job->jitter_sum = 0;
+
+    taskENTER_CRITICAL();
+    configASSERT( registry_count < JOBS_MAX );
+    registry[registry_count++] = job;
+
+    job->release = xTaskGetTickCount() + phase;
+    heap_push( job );
+    taskEXIT_CRITICAL();
+
+    /* el nuevo trabajo puede vencer antes que aquel por el que la tarea esta esperando */
+    if( jobs_task_handle != NULL )
+    {
+        xTaskNotifyGive( jobs_task_handle );
+    }
+}
+
+/**
+   @brief   Cambia el periodo a partir del proximo release. Pensada para llamarse desde el
+            propio callback: el release siguiente se calcula con el periodo nuevo.
+ */
+void jobs_set_period( t_job* job, TickType_t period )
+{
+    job->period = period;
+}
+
+/**
+   @brief   Imprime las estadisticas de cada trabajo. Tiempos en us.
+ */
+void jobs_report( void )
+{
+    for( uint32_t i = 0 ; i < registry_count ; i++ )
+    {
+        t_job job;
+
+        taskENTER_CRITICAL();
+        job = *registry[i];
+        taskEXIT_CRITICAL();
+
+        if( job.runs > 0 )
+        {
+            printf( "%s: %u ejecuciones, %u overruns, jitter avg %u max %u\n", job.name, job.runs, job.overruns,
+                    ( uint32_t )( job.jitter_sum / job.runs ), job.jitter_max );
+        }
+    }
+}
+
+/**
+   @brief   Tiempo actual en us, con resolucion sub-tick: ticks del kernel mas lo que el
+            SysTick ya conto del tick en curso. Da la vuelta cada ~71 minutos.
+ */
+uint32_t jobs_now_us( void )
+{
+    TickType_t ticks;
+    uint32_t val;
+
+    taskENTER_CRITICAL();
+    ticks = xTaskGetTickCount();
+    val = SysTick->VAL;
+
+    /* si el SysTick llego a cero pero su interrupcion todavia no se atendio, el tick leido
+       esta atrasado en uno */
+    if( SCB->ICSR & SCB_ICSR_PENDSTSET_Msk )
+    {
+        ticks++;
+        val = SysTick->VAL;
+    }
+    taskEXIT_CRITICAL();
+
+    return ticks * US_PER_TICK + ( SysTick->LOAD - val ) / ( configCPU_CLOCK_HZ / 1000000 );
+}
+
+/*=====[Implementations of private functions]================================*/
+
+static void jobs_task( void* taskParmPtr )
+{
+    t_job* job;
+    TickType_t now;
+
+    while( 1 )
+    {
+        now = xTaskGetTickCount();
+
+        taskENTER_CRITICAL();
+        job = ( heap_count > 0 ) ? heap[0] : NULL;
+
+        if( job != NULL && !BEFORE( now, job->release ) )
+        {
+            heap_pop();
+        }
+        else
+        {
+            job = NULL;
+        }
+        taskEXIT_CRITICAL();
+
+        if( job == NULL )
+        {
+            /* duermo hasta el release mas cercano, o hasta que se agregue un trabajo */
+            TickType_t wait = portMAX_DELAY;
+
+            taskENTER_CRITICAL();
+            if( heap_count > 0 )
+            {
+                wait = heap[0]->release - now;
+            }
+            taskEXIT_CRITICAL();
+
+            ulTaskNotifyTake( pdTRUE, wait );
+            continue;
+        }
+
+        uint32_t jitter = jobs_now_us() - job->release * US_PER_TICK;
+
+        job->callback( job );
+
+        job->runs++;
+        job->jitter_sum += jitter;
+        if( jitter > job->jitter_max )
+        {
+            job->jitter_max = jitter;
+        }
+
+        /* como vTaskDelayUntil, el release siguiente es relativo al anterior. Si el trabajo
+           quedo mas de un periodo atrasado no se ejecuta varias veces seguidas para
+           ponerse al dia: se saltean los releases perdidos y se cuentan */
+        job->release += job->period;
+        now = xTaskGetTickCount();
+        while( !BEFORE( now, job->release ) && ( now - job->release ) >= job->period )
+        {
+            job->release += job->period;
+            job->overruns++;
+        }
+
+        taskENTER_CRITICAL();
+        heap_push( job );
+        taskEXIT_CRITICAL();
+    }
+}
+
+/* inserta al final y sube mientras su release sea anterior al del padre */
+static void heap_push( t_job* job )
+{
+    configASSERT( heap_count < JOBS_MAX );
+
+    uint32_t i = heap_count++;
+
+    while( i > 0 )
+    {
+        uint32_t parent = ( i - 1 ) / 2;
+
+        if( !BEFORE( job->release, heap[parent]->release ) )
+        {
+            break;
+        }
+
+        heap[i] = heap[parent];
+        i = parent;
+    }
+
+    heap[i] = job;
+}
+
+/* saca la raiz, pone el ultimo en su lugar y lo baja mientras algun hijo venza antes */
+static t_job* heap_pop( void )
+{
+    t_job* top = heap[0];
+    t_job* last = heap[--heap_count];
+    uint32_t i = 0;
+
+    while( 1 )
+    {
+        uint32_t child = 2 * i + 1;
+
+        if( child >= heap_count )
+        {
+            break;
+        }
+        if( child + 1 < heap_count && BEFORE( heap[child + 1]->release, heap[child]->release ) )
+        {
+            child++;
+        }
+        if( !BEFORE( heap[child]->release, last->release ) )
+        {
+            break;
+        }
+
+        heap[i] = heap[child];
+        i = child;
+    }
+
+    heap[i] = last;
+
+    return top;
+}
@@ -0,0 +1,179 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*=====[Inclusions of function dependencies]=================================*/
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sapi.h"
+#include "jobs.h"
+#include "jobs_bench.h"
+
+#if JOBS_BENCH==1
+
+/*=====[Definition macros of private constants]==============================*/
+#define US_PER_TICK     ( 1000000 / configTICK_RATE_HZ )
+#define BENCH_PRIORITY  ( tskIDLE_PRIORITY+1 )
+
+/*=====[Definitions of private global variables]=============================*/
+
+/* en la version con tareas se usan solo los campos de estadisticas */
+static t_job bench_jobs[JOBS_BENCH_N];
+
+static volatile uint32_t bench_sink;
+
+/*=====[Prototypes (declarations) of private functions]======================*/
+static void bench_job( t_job* job );
+static void bench_report_task( void* taskParmPtr );
+#if JOBS_BENCH_USE_TASKS==1
+static void bench_task( void* taskParmPtr );
+#endif
+
+_Static_assert( JOBS_BENCH_HEAP_TOTAL <= configTOTAL_HEAP_SIZE, "jobs_bench: no entra en configTOTAL_HEAP_SIZE, bajar JOBS_BENCH_N" );
+
+/*=====[Implementations of public functions]=================================*/
+
+/**
+   @brief   Crea JOBS_BENCH_N trabajos periodicos identicos, como trabajos del ejecutivo o
+            como tareas, y una tarea que al cabo de JOBS_BENCH_SECONDS informa el jitter de
+            release y el heap consumido.
+ */
+void jobs_bench_Init( void )
+{
+    BaseType_t res;
+    size_t heap_before = xPortGetFreeHeapSize();
+
+#if JOBS_BENCH_USE_TASKS==1
+    for( uint32_t i = 0 ; i < JOBS_BENCH_N ; i++ )
+    {
+        res = xTaskCreate (
+                  bench_task,                   // Funcion de la tarea a ejecutar
+                  ( const char * )"bench",      // Nombre de la tarea como String amigable para el usuario
+                  JOBS_BENCH_TASK_STACK,        // Cantidad de stack de la tarea
+                  &bench_jobs[i],               // Parametros de tarea
+                  BENCH_PRIORITY,               // Prioridad de la tarea
+                  0                             // Puntero a la tarea creada en el sistema
+              );
+
+        // Gestión de errores
+        configASSERT( res == pdPASS );
+    }
+#else
+    jobs_Init( BENCH_PRIORITY );
+
+    for( uint32_t i = 0 ; i < JOBS_BENCH_N ; i++ )
+    {
+        jobs_add( &bench_jobs[i], "bench", pdMS_TO_TICKS( JOBS_BENCH_PERIOD_MS ), 1, bench_job, NULL );
+    }
+#endif
+
+    printf( "bench %s: %u trabajos, heap usado %u bytes\n", JOBS_BENCH_USE_TASKS ? "tareas" : "ejecutivo",
+            JOBS_BENCH_N, heap_before - xPortGetFreeHeapSize() );
+
+    res = xTaskCreate (
+              bench_report_task,            // Funcion de la tarea a ejecutar
+              ( const char * )"report",     // Nombre de la tarea como String amigable para el usuario
+              configMINIMAL_STACK_SIZE*2,   // Cantidad de stack de la tarea
+              0,                            // Parametros de tarea
+              BENCH_PRIORITY+1,             // Prioridad de la tarea
+              0                             // Puntero a la tarea creada en el sistema
+          );
+
+    // Gestión de errores
+    configASSERT( res == pdPASS );
+}
+
+/*=====[Implementations of private functions]================================*/
+
+/* el trabajo en si: un poco de computo, igual en las dos versiones */
+static void bench_job( t_job* job )
+{
+    for( uint32_t i = 0 ; i < 100 ; i++ )
+    {
+        bench_sink += i;
+    }
+}
+
+#if JOBS_BENCH_USE_TASKS==1
+static void bench_task( void* taskParmPtr )
+{
+    t_job* job = ( t_job* ) taskParmPtr;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while( 1 )
+    {
+        vTaskDelayUntil( &last_wake, pdMS_TO_TICKS( JOBS_BENCH_PERIOD_MS ) );
+
+        uint32_t jitter = jobs_now_us() - last_wake * US_PER_TICK;
+
+        bench_job( job );
+
+        job->runs++;
+        job->jitter_sum += jitter;
+        if( jitter > job->jitter_max )
+        {
+            job->jitter_max = jitter;
+        }
+    }
+}
+#endif
+
+static void bench_report_task( void* taskParmPtr )
+{
+    vTaskDelay( pdMS_TO_TICKS( JOBS_BENCH_SECONDS * 1000 ) );
+
+    uint32_t runs = 0;
+    uint64_t sum = 0;
+    uint32_t max = 0;
+    uint32_t overruns = 0;
+
+    vTaskSuspendAll();
+    for( uint32_t i = 0 ; i < JOBS_BENCH_N ; i++ )
+    {
+        runs += bench_jobs[i].runs;
+        sum += bench_jobs[i].jitter_sum;
+        overruns += bench_jobs[i].overruns;
+        if( bench_jobs[i].jitter_max > max )
+        {
+            max = bench_jobs[i].jitter_max;
+        }
+    }
+    xTaskResumeAll();
+
+    printf( "bench %s: %u trabajos, %u ejecuciones, %u overruns, jitter avg %u us max %u us\n",
+            JOBS_BENCH_USE_TASKS ? "tareas" : "ejecutivo", JOBS_BENCH_N, runs, overruns,
+            runs ? ( uint32_t )( sum / runs ) : 0, max );
+
+    vTaskDelete( 0 );
+}
+
+#endif
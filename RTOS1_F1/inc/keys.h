@@ -64,9 +64,10 @@ typedef struct
 typedef struct
 {
     keys_ButtonState_t state;   //variables
-    TickType_t time_down;		//timestamp of the last High to Low transition of the key
-    TickType_t time_up;		    //timestamp of the last Low to High transition of the key
-    TickType_t time_diff;	    //variables
+    volatile TickType_t time_down;	//timestamp of the last High to Low transition of the key
+    volatile TickType_t time_up;		//timestamp of the last Low to High transition of the key
+    volatile TickType_t time_diff;	//palabra alineada de 32 bits: se lee y escribe sin seccion critica
+    volatile uint32_t seq;			//la ISR lo incrementa luego de escribir time_down/time_up: el lector que lo ve cambiar durante la copia, reintenta
 
 #if KEYS_USE_ISR==1
     SemaphoreHandle_t isr_signal;   //almacenara el handle del semaforo creado para una cierta tecla
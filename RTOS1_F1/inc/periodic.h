@@ -0,0 +1,89 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef PERIODIC_H_
+#define PERIODIC_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* public macros ================================================================= */
+
+/* tareas periodicas que se pueden registrar (para periodic_report) */
+#define PERIODIC_MAX_TASKS      4
+
+/* histograma del tiempo de respuesta: PERIODIC_HIST_BINS franjas iguales entre 0 y el
+   plazo, y una franja extra para los trabajos que terminaron despues del plazo */
+#define PERIODIC_HIST_BINS      8
+
+/* types ================================================================= */
+
+/* min/max/promedio de una magnitud, en us */
+typedef struct
+{
+    int32_t  min;
+    int32_t  max;
+    int64_t  sum;
+} t_periodic_stat;
+
+typedef struct
+{
+    uint32_t jobs;                              //trabajos terminados
+    uint32_t misses;                            //trabajos que terminaron despues del plazo
+    uint32_t overruns;                          //releases que ya habian pasado al terminar el trabajo (vTaskDelayUntil no bloqueo)
+    t_periodic_stat jitter;                     //inicio real - release
+    t_periodic_stat exec;                       //fin - inicio real (incluye desalojos y bloqueos dentro del trabajo)
+    t_periodic_stat lateness;                   //fin - plazo absoluto (negativo: termino antes)
+    uint32_t hist[PERIODIC_HIST_BINS + 1];      //tiempo de respuesta (fin - release)
+} t_periodic_stats;
+
+typedef struct
+{
+    const char* name;
+    TickType_t  period;
+    TickType_t  deadline;       //relativo al release
+    TickType_t  last_wake;      //release del trabajo en curso (lo actualiza vTaskDelayUntil)
+    uint32_t    start_us;       //inicio real del trabajo en curso
+    t_periodic_stats stats;
+} t_periodic;
+
+/* methods ================================================================= */
+void periodic_Init( t_periodic* task, const char* name, TickType_t period, TickType_t deadline );
+void periodic_set_period( t_periodic* task, TickType_t period, TickType_t deadline );
+void periodic_job_start( t_periodic* task );
+void periodic_wait( t_periodic* task );
+void periodic_get_stats( t_periodic* task, t_periodic_stats* stats );
+void periodic_report( void );
+uint32_t periodic_now_us( void );
+
+#endif /* PERIODIC_H_ */
@@ -37,14 +37,19 @@
 
 #include "sapi.h"
 #include "keys.h"
+#include "periodic.h"
 
 /*=====[Definition & macros of public constants]==============================*/
 
+/* cada cuanto task_report imprime las estadisticas de las tareas periodicas */
+#define REPORT_PERIOD_MS    10000
+
 /*=====[Definitions of extern global functions]==============================*/
 
 // Prototipo de funcion de la tarea
 void task_led( void* taskParmPtr );
 void task_tecla( void* taskParmPtr );
+void task_report( void* taskParmPtr );
 
 /*=====[Definitions of public global variables]==============================*/
 
@@ -72,6 +77,18 @@ int main( void )
     // Gestión de errores
     configASSERT( res == pdPASS );
 
+    res = xTaskCreate (
+              task_report,				// Funcion de la tarea a ejecutar
+              ( const char * )"task_report",	// Nombre de la tarea como String amigable para el usuario
+              configMINIMAL_STACK_SIZE*4,	// Cantidad de stack de la tarea (printf)
+              0,							// Parametros de tarea
+              tskIDLE_PRIORITY,			// Prioridad de la tarea: no debe perturbar a las medidas
+              0							// Puntero a la tarea creada en el sistema
+          );
+
+    // Gestión de errores
+    configASSERT( res == pdPASS );
+
     /* inicializo driver de teclas */
     keys_Init();
 
@@ -87,15 +104,18 @@ void task_led( void* taskParmPtr )
 {
     TickType_t dif =   pdMS_TO_TICKS( 500 );
     int tecla_presionada;
-    TickType_t xPeriodicity = pdMS_TO_TICKS( 1000 ); // Tarea periodica cada 1000 ms
+    static t_periodic periodic;
 
-    TickType_t xLastWakeTime = xTaskGetTickCount();
+    periodic_Init( &periodic, "task_led", 2*dif, 0 );   // Tarea periodica cada 1000 ms
 
     while( 1 )
     {
+        periodic_job_start( &periodic );
+
         if( key_pressed( TEC1_INDEX ) )
         {
             dif = get_diff();
+            periodic_set_period( &periodic, 2*dif, 0 );
         }
 
         gpioWrite( LEDB, ON );
@@ -103,8 +123,17 @@ void task_led( void* taskParmPtr )
         gpioWrite( LEDB, OFF );
 
 
-        // Envia la tarea al estado bloqueado durante xPeriodicity (delay periodico)
-        vTaskDelayUntil( &xLastWakeTime, 2*dif );
+        // Envia la tarea al estado bloqueado hasta el proximo release (delay periodico)
+        periodic_wait( &periodic );
+    }
+}
+
+void task_report( void* taskParmPtr )
+{
+    while( 1 )
+    {
+        vTaskDelay( pdMS_TO_TICKS( REPORT_PERIOD_MS ) );
+        periodic_report();
     }
 }
 
@@ -42,11 +42,15 @@
 //#define BUTTON_RATE     1
 #define DEBOUNCE_TIME   40
 
+/* barrera de compilador: evita que se reordenen los accesos a keys_data alrededor de seq */
+#define KEYS_BARRIER()  __asm volatile( "" ::: "memory" )
+
 /*=====[Prototypes (declarations) of private functions]======================*/
 static void keys_isr_config( void );
 static void keys_ButtonError( uint32_t index );
 static void buttonPressed( uint32_t index );
 static void buttonReleased( uint32_t index );
+static TickType_t keys_read_diff( uint32_t index );
 
 /*=====[Definitions of private global variables]=============================*/
 
@@ -67,20 +71,12 @@ void task_tecla( void* taskParmPtr );
 /*=====[Implementations of public functions]=================================*/
 TickType_t get_diff()
 {
-    TickType_t tiempo;
-
-    taskENTER_CRITICAL();
-    tiempo = keys_data[TEC1_INDEX].time_diff;
-    taskEXIT_CRITICAL();
-
-    return tiempo;
+    return keys_data[TEC1_INDEX].time_diff;
 }
 
 void clear_diff()
 {
-    taskENTER_CRITICAL();
     keys_data[TEC1_INDEX].time_diff = 0;
-    taskEXIT_CRITICAL();
 }
 
 /* funcion no bloqueante que consulta si la tecla fue pulsada. */
@@ -280,12 +276,36 @@ static void buttonPressed( uint32_t index )
 
 }
 
+/**
+   @brief calcula time_up - time_down sin deshabilitar interrupciones.
+          Si una ISR actualiza los timestamps mientras se leen, seq cambia y se vuelve a leer.
+
+   @param index
+   @return duracion de la ultima pulsacion
+ */
+static TickType_t keys_read_diff( uint32_t index )
+{
+    uint32_t seq;
+    TickType_t time_down;
+    TickType_t time_up;
+
+    do
+    {
+        seq = keys_data[index].seq;
+        KEYS_BARRIER();
+        time_down   = keys_data[index].time_down;
+        time_up     = keys_data[index].time_up;
+        KEYS_BARRIER();
+    }
+    while( seq != keys_data[index].seq );
+
+    return time_up - time_down;
+}
+
 /* accion de el evento de tecla liberada */
 static void buttonReleased( uint32_t index )
 {
-    taskENTER_CRITICAL();
-    keys_data[index].time_diff  = keys_data[index].time_up - keys_data[index].time_down;
-    taskEXIT_CRITICAL();
+    keys_data[index].time_diff  = keys_read_diff( index );
 
     xSemaphoreGive( keys_data[TEC1_INDEX].pressed_signal ) ;
 }
@@ -408,13 +428,9 @@ void keys_isr_config( void )
  */
 void keys_isr_fall( uint32_t index )
 {
-    UBaseType_t uxSavedInterruptStatus;
-
-    /* esta operacion debe realizarse en zona critica. Recordar que el objeto global puede estar leyendose
-       o escribiendose en otro contexto  */
-    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
     keys_data[TEC1_INDEX].time_down = xTaskGetTickCountFromISR();
-    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    KEYS_BARRIER();
+    keys_data[TEC1_INDEX].seq++;
 }
 
 /**
@@ -424,13 +440,9 @@ void keys_isr_fall( uint32_t index )
  */
 void keys_isr_rise( uint32_t index )
 {
-    UBaseType_t uxSavedInterruptStatus;
-
-    /* esta operacion debe realizarse en zona critica. Recordar que el objeto global puede estar leyendose
-       o escribiendose en otro contexto  */
-    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
     keys_data[TEC1_INDEX].time_up = xTaskGetTickCountFromISR();
-    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+    KEYS_BARRIER();
+    keys_data[TEC1_INDEX].seq++;
 }
 
 void GPIO0_IRQHandler( void )   //asociado a tec1
@@ -0,0 +1,247 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*=====[Inclusions of function dependencies]=================================*/
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sapi.h"
+#include "periodic.h"
+
+#include <string.h>
+
+/*=====[Definition macros of private constants]==============================*/
+#define US_PER_TICK     ( 1000000 / configTICK_RATE_HZ )
+
+/*=====[Definitions of private global variables]=============================*/
+static t_periodic* registry[PERIODIC_MAX_TASKS];
+static uint32_t registry_count;
+
+/*=====[Prototypes (declarations) of private functions]======================*/
+static void stat_reset( t_periodic_stat* stat );
+static void stat_add( t_periodic_stat* stat, int32_t value );
+static uint32_t ticks_to_us( TickType_t ticks );
+
+/*=====[Implementations of public functions]=================================*/
+
+/**
+   @brief   Inicializa el seguimiento de una tarea periodica y la registra para periodic_report.
+            Se llama desde la propia tarea, antes del lazo: el primer release es el tick actual.
+
+   @param task
+   @param name      nombre para el informe
+   @param period    en ticks
+   @param deadline  plazo relativo al release, en ticks (0: igual al periodo)
+ */
+void periodic_Init( t_periodic* task, const char* name, TickType_t period, TickType_t deadline )
+{
+    task->name = name;
+    task->last_wake = xTaskGetTickCount();
+
+    periodic_set_period( task, period, deadline );
+
+    taskENTER_CRITICAL();
+    configASSERT( registry_count < PERIODIC_MAX_TASKS );
+    registry[registry_count++] = task;
+    taskEXIT_CRITICAL();
+}
+
+/**
+   @brief   Cambia el periodo (y el plazo) a partir del proximo release. Las estadisticas se
+            reinician porque dejan de ser comparables.
+ */
+void periodic_set_period( t_periodic* task, TickType_t period, TickType_t deadline )
+{
+    taskENTER_CRITICAL();
+
+    task->period = period;
+    task->deadline = ( deadline == 0 ) ? period : deadline;
+
+    memset( &task->stats, 0, sizeof( task->stats ) );
+    stat_reset( &task->stats.jitter );
+    stat_reset( &task->stats.exec );
+    stat_reset( &task->stats.lateness );
+
+    taskEXIT_CRITICAL();
+}
+
+/**
+   @brief   Marca el comienzo del trabajo: se llama apenas la tarea despierta.
+            Registra el jitter de release (cuanto despues del release pudo empezar).
+ */
+void periodic_job_start( t_periodic* task )
+{
+    task->start_us = periodic_now_us();
+
+    int32_t jitter = task->start_us - ticks_to_us( task->last_wake );
+
+    taskENTER_CRITICAL();
+    stat_add( &task->stats.jitter, jitter );
+    taskEXIT_CRITICAL();
+}
+
+/**
+   @brief   Marca el fin del trabajo, registra sus tiempos y bloquea a la tarea hasta el
+            proximo release con vTaskDelayUntil. Reemplaza a la llamada a vTaskDelayUntil
+            del lazo de la tarea.
+ */
+void periodic_wait( t_periodic* task )
+{
+    uint32_t end_us = periodic_now_us();
+    uint32_t release_us = ticks_to_us( task->last_wake );
+    uint32_t response = end_us - release_us;
+    int32_t lateness = ( int32_t ) response - ( int32_t ) ticks_to_us( task->deadline );
+    uint32_t bin = ( uint64_t ) response * PERIODIC_HIST_BINS / ticks_to_us( task->deadline );
+
+    if( bin > PERIODIC_HIST_BINS )
+    {
+        bin = PERIODIC_HIST_BINS;
+    }
+
+    taskENTER_CRITICAL();
+
+    task->stats.jobs++;
+    stat_add( &task->stats.exec, end_us - task->start_us );
+    stat_add( &task->stats.lateness, lateness );
+    task->stats.hist[bin]++;
+
+    if( lateness > 0 )
+    {
+        task->stats.misses++;
+    }
+
+    /* si el proximo release ya paso, vTaskDelayUntil vuelve sin bloquear y la tarea
+       "se pone al dia" en silencio: se cuenta para que quede a la vista */
+    if( ( TickType_t )( xTaskGetTickCount() - task->last_wake ) >= task->period )
+    {
+        task->stats.overruns++;
+    }
+
+    taskEXIT_CRITICAL();
+
+    vTaskDelayUntil( &task->last_wake, task->period );
+}
+
+/**
+   @brief   Copia consistente de las estadisticas de una tarea
+ */
+void periodic_get_stats( t_periodic* task, t_periodic_stats* stats )
+{
+    taskENTER_CRITICAL();
+    *stats = task->stats;
+    taskEXIT_CRITICAL();
+}
+
+/**
+   @brief   Imprime las estadisticas de todas las tareas registradas. Tiempos en us.
+ */
+void periodic_report( void )
+{
+    t_periodic_stats s;
+
+    for( uint32_t i = 0 ; i < registry_count ; i++ )
+    {
+        periodic_get_stats( registry[i], &s );
+
+        if( s.jobs == 0 )
+        {
+            continue;
+        }
+
+        printf( "%s: T %u ms D %u ms, %u trabajos, %u plazos perdidos, %u overruns\n",
+                registry[i]->name, ticks_to_us( registry[i]->period ) / 1000, ticks_to_us( registry[i]->deadline ) / 1000,
+                s.jobs, s.misses, s.overruns );
+        printf( "  jitter   min %d avg %d max %d\n", s.jitter.min, ( int32_t )( s.jitter.sum / s.jobs ), s.jitter.max );
+        printf( "  ejec     min %d avg %d max %d\n", s.exec.min, ( int32_t )( s.exec.sum / s.jobs ), s.exec.max );
+        printf( "  demora   min %d avg %d max %d\n", s.lateness.min, ( int32_t )( s.lateness.sum / s.jobs ), s.lateness.max );
+        printf( "  respuesta/D" );
+        for( uint32_t b = 0 ; b <= PERIODIC_HIST_BINS ; b++ )
+        {
+            printf( " %u", s.hist[b] );
+        }
+        printf( "\n" );
+    }
+}
+
+/**
+   @brief   Tiempo actual en us, con resolucion sub-tick: ticks del kernel mas lo que el
+            SysTick ya conto del tick en curso. Da la vuelta cada ~71 minutos.
+ */
+uint32_t periodic_now_us( void )
+{
+    TickType_t ticks;
+    uint32_t val;
+
+    taskENTER_CRITICAL();
+    ticks = xTaskGetTickCount();
+    val = SysTick->VAL;
+
+    /* si el SysTick llego a cero pero su interrupcion todavia no se atendio, el tick leido
+       esta atrasado en uno */
+    if( SCB->ICSR & SCB_ICSR_PENDSTSET_Msk )
+    {
+        ticks++;
+        val = SysTick->VAL;
+    }
+    taskEXIT_CRITICAL();
+
+    uint32_t elapsed = SysTick->LOAD - val;
+
+    return ticks_to_us( ticks ) + elapsed / ( configCPU_CLOCK_HZ / 1000000 );
+}
+
+/*=====[Implementations of private functions]================================*/
+
+static void stat_reset( t_periodic_stat* stat )
+{
+    stat->min = INT32_MAX;
+    stat->max = INT32_MIN;
+    stat->sum = 0;
+}
+
+static void stat_add( t_periodic_stat* stat, int32_t value )
+{
+    if( value < stat->min )
+    {
+        stat->min = value;
+    }
+    if( value > stat->max )
+    {
+        stat->max = value;
+    }
+    stat->sum += value;
+}
+
+static uint32_t ticks_to_us( TickType_t ticks )
+{
+    return ( uint32_t ) ticks * US_PER_TICK;
+}
@@ -57,7 +57,7 @@
 #define configUSE_APPLICATION_TASK_TAG               0
 #define configUSE_COUNTING_SEMAPHORES                0
 #define configGENERATE_RUN_TIME_STATS                0
-#define configSUPPORT_STATIC_ALLOCATION              0
+#define configSUPPORT_STATIC_ALLOCATION              1
 #define configOVERRIDE_DEFAULT_TICK_CONFIGURATION    1
 #define configRECORD_STACK_HIGH_ADDRESS              1
 
@@ -0,0 +1,115 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef GESTURES_H_
+#define GESTURES_H_
+
+#include "FreeRTOS.h"
+#include "sapi.h"
+#include "keys.h"
+
+/* public macros ================================================================= */
+#define GESTURES_MAX_KEYS           4       /* teclas que sigue el reconocedor (TEC1..TEC4) */
+
+/* umbrales por defecto (se pueden cambiar en gestures_Init) */
+#define GESTURES_LONG_PRESS_MS      800     /* pulsacion sostenida a partir de la cual es "larga" */
+#define GESTURES_MULTI_CLICK_MS     300     /* maxima separacion entre clicks de un doble/triple click */
+#define GESTURES_CHORD_MS           100     /* maxima separacion entre las pulsaciones de un acorde */
+
+#define GESTURES_QUEUE_LEN          10
+
+/* user_gesture corre en la tarea del reconocedor: el stack tiene que alcanzar para lo que haga
+   la aplicacion. Con la newlib completa (USE_NANO=n) un printf usa mas de 1 KB */
+#define GESTURES_TASK_STACK         ( configMINIMAL_STACK_SIZE*8 )
+
+/* en 1 mide los ciclos de CPU que consume cada evento procesado */
+#define GESTURES_MEASURE_CYCLES     0
+
+/* 1: la FSM de cada tecla corre sobre la tabla de fsm_table.c; 0: con los switch de antes.
+   Se puede elegir al compilar para comparar el costo de ambas (test/test_gestures) */
+#ifndef GESTURES_USE_TABLE
+#define GESTURES_USE_TABLE          1
+#endif
+
+/* types ================================================================= */
+typedef enum
+{
+    GESTURE_CLICK,
+    GESTURE_DOUBLE_CLICK,
+    GESTURE_TRIPLE_CLICK,
+    GESTURE_LONG_PRESS,
+    GESTURE_CHORD
+} t_gesture_type;
+
+typedef struct
+{
+    TickType_t long_press;      //ticks
+    TickType_t multi_click;     //ticks
+    TickType_t chord;           //ticks
+} t_gesture_config;
+
+typedef struct
+{
+    t_gesture_type  type;
+    uint32_t        tecla;          //tecla que genero el gesto
+    uint32_t        tecla2;         //segunda tecla (solo GESTURE_CHORD)
+    TickType_t      event_time;     //timestamp de la primera pulsacion del gesto
+    TickType_t      duration;       //duracion de la pulsacion (GESTURE_LONG_PRESS)
+} t_gesture_event;
+
+typedef struct
+{
+    uint32_t events;            //flancos procesados
+    uint32_t gestures;          //gestos publicados
+    uint32_t dropped;           //flancos descartados por cola llena
+#if GESTURES_MEASURE_CYCLES==1
+    uint32_t cycles_max;        //peor caso de ciclos por evento
+    uint32_t cycles_total;      //ciclos acumulados (promedio = cycles_total / events)
+#endif
+} t_gesture_stats;
+
+/* methods ================================================================= */
+void gestures_Init( const t_gesture_config* config );
+void gestures_post( t_key_isr_signal* event_data );
+void gestures_get_stats( t_gesture_stats* stats );
+
+/* nucleo de la FSM, independiente del RTOS (gestures_fsm.c) */
+void gestures_fsm_Init( const t_gesture_config* config );
+void gestures_fsm_get_stats( t_gesture_stats* stats );
+void gestures_process_edge( t_key_isr_signal* event_data );
+TickType_t gestures_process_timeout( TickType_t now );
+
+/* la implementa la aplicacion; se llama desde la tarea del reconocedor (ver GESTURES_TASK_STACK) */
+void user_gesture( t_gesture_event* gesture );
+
+#endif /* GESTURES_H_ */
@@ -0,0 +1,73 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef KEYPAD_H_
+#define KEYPAD_H_
+
+#include "FreeRTOS.h"
+#include "sapi.h"
+#include "keys.h"
+
+/* public macros ================================================================= */
+#define KEYPAD_ROWS         4
+#define KEYPAD_COLS         4
+#define KEYPAD_KEYS         ( KEYPAD_ROWS * KEYPAD_COLS )
+
+/* las teclas del teclado matricial se informan a continuacion de TEC1..TEC4 */
+#define KEYPAD_FIRST_INDEX  ( TEC4_INDEX + 1 )
+#define KEYPAD_INDEX( row, col )    ( KEYPAD_FIRST_INDEX + ( row ) * KEYPAD_COLS + ( col ) )
+
+/* periodo de barrido mientras hay actividad. El antirrebote necesita 4 barridos
+   iguales, por lo que la ventana efectiva es 4 * KEYPAD_SCAN_MS */
+#define KEYPAD_SCAN_MS      5
+
+/* en 1 mide los ciclos de CPU de cada barrido */
+#define KEYPAD_MEASURE_CYCLES   0
+
+/* types ================================================================= */
+typedef struct
+{
+    uint32_t wakeups;       //veces que una interrupcion de columna desperto al servicio
+    uint32_t scans;         //barridos completos de la matriz
+    uint32_t events;        //eventos de pulsado/liberado emitidos
+#if KEYPAD_MEASURE_CYCLES==1
+    uint32_t scan_cycles_max;
+    uint32_t scan_cycles_last;
+#endif
+} t_keypad_stats;
+
+/* methods ================================================================= */
+void keypad_Init( void );
+void keypad_get_stats( t_keypad_stats* stats );
+
+#endif /* KEYPAD_H_ */
@@ -36,6 +36,7 @@
 #include "FreeRTOS.h"
 #include "semphr.h"
 #include "queue.h"      //Api de colas
+#include "event_groups.h"
 
 /* public macros ================================================================= */
 #define KEYS_INVALID_TIME   -1
@@ -47,6 +48,29 @@
 #define TEC3_INDEX  2
 #define TEC4_INDEX  3
 
+/* bits del event group de teclas (ver keys_wait_down / keys_wait_released).
+   Un event group tiene 24 bits utiles: se publican hasta 8 teclas. */
+#define KEYS_EVT_MAX_KEYS           8
+#define KEYS_EVT_DOWN( index )      ( ( EventBits_t ) 1 << ( index ) )          //nivel: la tecla esta pulsada
+#define KEYS_EVT_RELEASED( index )  ( ( EventBits_t ) 1 << ( ( index ) + 8 ) )  //pulso: la tecla se acaba de liberar
+
+/* tipo de flanco informado en t_key_isr_signal.event_type */
+#define TEC_FALL        0
+#define TEC_RISE        1
+
+/* prefiltro de la ISR: se descartan los flancos que llegan antes de este tiempo
+   desde el ultimo flanco encolado de la misma tecla */
+#define KEYS_ISR_HOLDOFF_MS     5
+
+/* en 1 keys.c, gestures.c y keypad.c crean sus tareas, colas y semaforos sobre memoria
+   estatica (requiere configSUPPORT_STATIC_ALLOCATION): el consumo de RAM queda fijo al
+   linkear y el arranque no puede fallar por falta de heap */
+#define KEYS_USE_STATIC         1
+
+/* limites de la ventana antirrebote que aprende cada tecla */
+#define KEYS_DEBOUNCE_MIN_MS    5
+#define KEYS_DEBOUNCE_MAX_MS    40
+
 
 /* types ================================================================= */
 typedef enum
@@ -62,12 +86,46 @@ typedef struct
     gpioMap_t tecla;			//config
 } t_key_config;
 
+typedef struct
+{
+    TickType_t time_down;		//timestamp of the last High to Low transition of the key
+    TickType_t time_up;		    //timestamp of the last Low to High transition of the key
+} t_key_times;
+
+typedef struct
+{
+    uint32_t accepted;          //flancos encolados en isr_queue
+    uint32_t dropped_holdoff;   //descartados por llegar dentro del holdoff
+    uint32_t dropped_same_dir;  //descartados por repetir el sentido del ultimo flanco encolado
+    uint32_t dropped_full;      //descartados porque isr_queue estaba llena
+    uint32_t queue_max;         //maximo de mensajes en isr_queue observado desde la ISR
+} t_key_isr_stats;
+
+typedef struct
+{
+    TickType_t debounce;        //ventana antirrebote vigente
+    TickType_t last_envelope;   //duracion del ultimo rebote medido
+    TickType_t max_envelope;    //rebote mas largo medido desde keys_Init
+    uint32_t extended;          //veces que hubo que extender la espera porque seguia rebotando
+    uint32_t skipped;           //eventos demorados en la cola, de los que no se aprende
+} t_key_debounce_stats;
+
 typedef struct
 {
     keys_ButtonState_t state;   //variables
     TickType_t time_down;		//timestamp of the last High to Low transition of the key
     TickType_t time_up;		    //timestamp of the last Low to High transition of the key
-    TickType_t time_diff;	    //variables
+    volatile TickType_t time_diff;	//palabra alineada de 32 bits: se lee y escribe sin seccion critica
+
+    t_key_times times[2];       //copias publicadas de time_down/time_up (ver keys_get_times)
+    volatile uint32_t seq;      //la copia vigente es times[seq & 1]
+
+    TickType_t isr_last_time;   //timestamp del ultimo flanco encolado (solo la ISR)
+    volatile uint32_t isr_last_type;    //sentido del ultimo flanco encolado (ISR y task_tecla)
+    t_key_isr_stats isr_stats;
+
+    volatile TickType_t isr_raw_time;   //timestamp del ultimo flanco visto por la ISR, aun descartado
+    t_key_debounce_stats debounce;
 
 
     SemaphoreHandle_t pressed_signal;
@@ -85,6 +143,12 @@ typedef struct
 void keys_Init( void );
 TickType_t get_diff( uint32_t index );
 void clear_diff();
+void keys_get_times( uint32_t index, t_key_times* times );
+void keys_get_isr_stats( uint32_t index, t_key_isr_stats* stats );
+void keys_get_debounce_stats( uint32_t index, t_key_debounce_stats* stats );
+void keys_inject_edge( uint32_t index, uint32_t event_type );
+EventBits_t keys_wait_down( EventBits_t keys, BaseType_t all, TickType_t timeout );
+EventBits_t keys_wait_released( EventBits_t keys, TickType_t timeout );
 
 
 #endif /* PDM_ANTIRREBOTE_MEF_INC_DEBOUNCE_H_ */
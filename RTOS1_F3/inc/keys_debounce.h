@@ -0,0 +1,51 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef KEYS_DEBOUNCE_H_
+#define KEYS_DEBOUNCE_H_
+
+#include "FreeRTOS.h"
+#include "sapi.h"
+#include "keys.h"
+
+/* public macros ================================================================= */
+#define KEYS_DEBOUNCE_MARGIN_MS     3   /* silencio exigido al final del rebote y margen sobre la envolvente medida */
+#define KEYS_DEBOUNCE_DECAY         4   /* la ventana baja 1/KEYS_DEBOUNCE_DECAY de la diferencia por cada pulsacion limpia */
+
+/* methods ================================================================= */
+/* nucleo del antirrebote adaptivo, independiente del RTOS (keys_debounce.c) */
+void keys_debounce_reset( t_key_debounce_stats* db );
+bool_t keys_debounce_settling( TickType_t edge, TickType_t raw, TickType_t now );
+void keys_debounce_learn( t_key_debounce_stats* db, TickType_t edge, TickType_t raw, TickType_t start, TickType_t end );
+
+#endif /* KEYS_DEBOUNCE_H_ */
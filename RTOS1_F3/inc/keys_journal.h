@@ -0,0 +1,77 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef KEYS_JOURNAL_H_
+#define KEYS_JOURNAL_H_
+
+#include "FreeRTOS.h"
+#include "sapi.h"
+
+/* public macros ================================================================= */
+
+/* en 1 keys.c registra cada flanco encolado y cada decision del antirrebote */
+#ifndef KEYS_JOURNAL
+#define KEYS_JOURNAL        1
+#endif
+
+/* cantidad de registros, potencia de 2: al llenarse se pisan los mas viejos */
+#define KEYS_JOURNAL_LEN    64
+
+/* UART por la que sale keys_journal_export */
+#define KEYS_JOURNAL_UART   UART_USB
+
+/* resultado de cada registro */
+#define KEYS_JRN_QUEUED     0       //ISR: flanco aceptado por el prefiltro y encolado
+#define KEYS_JRN_LOST       1       //ISR: flanco aceptado pero isr_queue estaba llena
+#define KEYS_JRN_PRESSED    2       //task_tecla: el antirrebote confirmo la pulsacion
+#define KEYS_JRN_RELEASED   3       //task_tecla: el antirrebote confirmo la liberacion
+#define KEYS_JRN_REJECTED   4       //task_tecla: al terminar la espera el nivel no cambio (glitch)
+#define KEYS_JRN_IGNORED    5       //task_tecla: el flanco no corresponde al estado de la tecla
+
+/* types ================================================================= */
+
+/* 8 bytes por registro */
+typedef struct
+{
+    TickType_t time;        //timestamp del flanco (tick de la ISR)
+    uint8_t  tecla;
+    uint8_t  edge;          //TEC_FALL / TEC_RISE
+    uint8_t  result;        //KEYS_JRN_xxx
+    uint8_t  latency;       //ticks desde el flanco hasta el registro (saturado en 255)
+} t_keys_journal_entry;
+
+/* methods ================================================================= */
+void keys_journal_record( TickType_t time, uint32_t tecla, uint32_t edge, uint32_t result, TickType_t now );
+void keys_journal_export( void );
+
+#endif /* KEYS_JOURNAL_H_ */
@@ -0,0 +1,77 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef KEYS_SIM_H_
+#define KEYS_SIM_H_
+
+#include "FreeRTOS.h"
+#include "sapi.h"
+
+/* public macros ================================================================= */
+
+/* en 1 el driver de teclas no lee los pines ni usa las PININT: el nivel de cada tecla
+   y sus flancos los genera una tarea a partir de un guion (ver keys_sim_Init) */
+#ifndef KEYS_SIM
+#define KEYS_SIM    0
+#endif
+
+/* types ================================================================= */
+
+/* un paso del guion: silencio, pulsacion con rebote, tecla sostenida, liberacion con rebote */
+typedef struct
+{
+    uint8_t  tecla;         //indice de la tecla (TECn_INDEX)
+    uint8_t  bounces;       //flancos espurios antes del flanco definitivo, en cada transicion
+    uint8_t  bounce_ms;     //separacion entre flancos del rebote (minimo 1 tick)
+    uint16_t gap_ms;        //silencio antes de la pulsacion
+    uint16_t hold_ms;       //tiempo pulsada, medido desde el ultimo flanco del rebote
+} t_keys_sim_step;
+
+typedef struct
+{
+    uint32_t presses;       //pulsaciones inyectadas
+    uint32_t edges;         //flancos inyectados (incluye los rebotes)
+    uint32_t pressed;       //eventos de pulsado que emitio el driver
+    uint32_t released;      //eventos de liberado que emitio el driver
+    uint32_t spurious;      //eventos que no corresponden al nivel estable del guion
+    TickType_t latency_max; //desde el ultimo flanco del rebote hasta el evento
+    uint32_t latency_sum;
+} t_keys_sim_stats;
+
+/* methods ================================================================= */
+void keys_sim_Init( const t_keys_sim_step* script, uint32_t steps, uint32_t repeat );
+bool_t keys_sim_read( uint32_t index );
+void keys_sim_report( uint32_t index, uint32_t event_type );
+void keys_sim_get_stats( t_keys_sim_stats* stats );
+
+#endif /* KEYS_SIM_H_ */
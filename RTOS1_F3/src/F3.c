@@ -37,6 +37,10 @@
 
 #include "sapi.h"
 #include "keys.h"
+#include "gestures.h"
+#include "keypad.h"
+#include "keys_sim.h"
+#include "keys_journal.h"
 
 /*=====[Definition & macros of public constants]==============================*/
 
@@ -49,11 +53,24 @@ void task_tecla( void* taskParmPtr );
 typedef struct
 {
     gpioMap_t led;
-    xQueueHandle queue; //almacenara el evento en una cola
+    uint32_t tecla;     //tecla asociada: el led espera su KEYS_EVT_RELEASED y lee sus tiempos de keys_get_times
 } t_tecla_led;
 
 
-t_tecla_led leds_data[] = { {.led= LEDR}, {.led= LED1}, {.led= LED2}, {.led= LED3}};
+t_tecla_led leds_data[] = { {.led= LEDR, .tecla= TEC1_INDEX}, {.led= LED1, .tecla= TEC2_INDEX}, {.led= LED2, .tecla= TEC3_INDEX}, {.led= LED3, .tecla= TEC4_INDEX}};
+
+#if KEYS_SIM==1
+/* perfiles de rebote: contacto limpio, rebote corto, contacto gastado y pulsacion rapida */
+const t_keys_sim_step sim_script[] =
+{
+    {.tecla= TEC1_INDEX, .bounces= 0, .bounce_ms= 1, .gap_ms= 200, .hold_ms= 150},
+    {.tecla= TEC2_INDEX, .bounces= 3, .bounce_ms= 1, .gap_ms= 200, .hold_ms= 150},
+    {.tecla= TEC3_INDEX, .bounces= 8, .bounce_ms= 2, .gap_ms= 200, .hold_ms= 300},
+    {.tecla= TEC4_INDEX, .bounces= 2, .bounce_ms= 1, .gap_ms= 100, .hold_ms= 60},
+};
+
+#define SIM_REPEAT  500
+#endif
 
 /*=====[Definitions of public global variables]==============================*/
 
@@ -88,6 +105,17 @@ int main( void )
     /* inicializo driver de teclas */
     keys_Init();
 
+#if KEYS_SIM==1
+    /* reproduce el guion en lugar de leer las teclas de la placa */
+    keys_sim_Init( sim_script, sizeof(sim_script)/sizeof(sim_script[0]), SIM_REPEAT );
+#endif
+
+    /* inicializo el reconocedor de gestos con los umbrales por defecto */
+    gestures_Init( NULL );
+
+    /* teclado matricial 4x4: informa sus teclas con los mismos eventos que keys.c */
+    keypad_Init();
+
     // Iniciar scheduler
     vTaskStartScheduler();					// Enciende tick | Crea idle y pone en ready | Evalua las tareas creadas | Prioridad mas alta pasa a running
 
@@ -98,61 +126,77 @@ int main( void )
 
 void user_buttonPressed( t_key_isr_signal* event_data )
 {
-    //nada
+    gestures_post( event_data );
 }
 
 void user_buttonReleased( t_key_isr_signal* event_data )
 {
-    /* asociacion tecla - led */
-    if( event_data->tecla == TEC1_INDEX )
-    {
-        xQueueSend( leds_data[0].queue, event_data, portMAX_DELAY );
-    }
+    /* los leds no reciben copias del evento: esperan el bit de liberacion publicado por keys.c */
+    gestures_post( event_data );
+}
 
-    if( event_data->tecla == TEC2_INDEX )
-    {
-        xQueueSend( leds_data[1].queue, event_data, portMAX_DELAY );
-    }
 
-    if( event_data->tecla == TEC3_INDEX )
+void user_gesture( t_gesture_event* gesture )
+{
+    static const char* nombres[] = { "click", "doble click", "triple click", "pulsacion larga", "acorde" };
+
+    if( gesture->type == GESTURE_CHORD )
     {
-        xQueueSend( leds_data[2].queue, event_data, portMAX_DELAY );
-    }
+        printf( "%s TEC%u+TEC%u\n", nombres[gesture->type], gesture->tecla+1, gesture->tecla2+1 );
 
-    if( event_data->tecla == TEC4_INDEX )
+#if KEYS_JOURNAL==1
+        /* TEC1+TEC4 vuelca el journal de teclas para diagnostico */
+        if( ( gesture->tecla == TEC1_INDEX && gesture->tecla2 == TEC4_INDEX ) ||
+            ( gesture->tecla == TEC4_INDEX && gesture->tecla2 == TEC1_INDEX ) )
+        {
+            keys_journal_export();
+        }
+#endif
+    }
+    else
     {
-        xQueueSend( leds_data[3].queue, event_data, portMAX_DELAY );
+        printf( "%s TEC%u (%u ms)\n", nombres[gesture->type], gesture->tecla+1, gesture->duration );
     }
 }
 
-
+/* el led parpadea con periodo 2*dif y espera la liberacion de su tecla en el event group de
+   keys.c mientras tanto: cualquier cantidad de tareas puede suscribirse a la misma tecla sin
+   que task_tecla copie eventos ni se bloquee. El nuevo dif rige desde el proximo encendido */
 void task_led( void* taskParmPtr )
 {
-    t_key_isr_signal evnt;
+    t_key_times times;
     t_tecla_led* led_data = taskParmPtr;
+    EventBits_t released = KEYS_EVT_RELEASED( led_data->tecla );
 
-    led_data->queue = xQueueCreate( 2, sizeof(   t_key_isr_signal )  );
+    TickType_t dif      = pdMS_TO_TICKS( 500 );
+    TickType_t next_dif = dif;
+    bool_t led_on = FALSE;
 
-    TickType_t dif =   pdMS_TO_TICKS( 500 );
-    int tecla_presionada;
-    TickType_t xPeriodicity = pdMS_TO_TICKS( 1000 ); // Tarea periodica cada 1000 ms
-
-    TickType_t xLastWakeTime = xTaskGetTickCount();
+    TickType_t next = xTaskGetTickCount();    //proximo cambio del led
 
     while( 1 )
     {
-        if( xQueueReceive( led_data->queue, &evnt, 0 ) == pdPASS  )
+        TickType_t now = xTaskGetTickCount();
+
+        if( ( int32_t )( now - next ) >= 0 )
         {
-            dif = get_diff( evnt.tecla );
-        }
+            led_on = !led_on;
 
-        gpioWrite( led_data->led, ON );
-        vTaskDelay( dif );
-        gpioWrite( led_data->led, OFF );
+            if( led_on )
+            {
+                dif = next_dif;
+            }
 
+            gpioWrite( led_data->led, led_on );
+            next += dif;
+            continue;
+        }
 
-        // Envia la tarea al estado bloqueado durante xPeriodicity (delay periodico)
-        vTaskDelayUntil( &xLastWakeTime, 2*dif );
+        if( keys_wait_released( released, next - now ) & released )
+        {
+            keys_get_times( led_data->tecla, &times );
+            next_dif = times.time_up - times.time_down;
+        }
     }
 }
 
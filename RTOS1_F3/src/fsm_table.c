@@ -0,0 +1,57 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[ Inclusions ]============================================*/
+#include "fsm_table.h"
+
+/*=====[Implementations of public functions]=================================*/
+
+/**
+   @brief ejecuta una transicion: busca la celda (state, event), llama a su accion y
+          devuelve el estado siguiente. No hay switch ni comparaciones por estado: la
+          accion "nada" es una funcion vacia, por lo que siempre se hace la misma llamada.
+
+   @param fsm
+   @param state     estado actual, menor que fsm->n_states
+   @param event     evento, menor que fsm->n_events
+   @param ctx       se pasa a la accion (por ejemplo el indice de la tecla)
+   @return estado siguiente
+ */
+uint8_t fsm_run( const t_fsm* fsm, uint8_t state, uint8_t event, uint32_t ctx )
+{
+    const t_fsm_transition* t = &fsm->table[state * fsm->n_events + event];
+
+    fsm->actions[t->action]( ctx );
+
+    return t->next;
+}
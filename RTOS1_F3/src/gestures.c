@@ -0,0 +1,141 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[ Inclusions ]============================================*/
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "sapi.h"
+#include "gestures.h"
+
+/*=====[Definition macros of private constants]==============================*/
+/* keys.c entrega cada flanco luego de su antirrebote, por lo que los eventos llegan
+   con retraso respecto de su timestamp. Los vencimientos se evaluan con este margen
+   para que un flanco ocurrido antes del vencimiento siempre se procese antes. */
+#define GESTURES_SETTLE_MS      50
+
+/*=====[Prototypes (declarations) of private functions]======================*/
+static void task_gestures( void* taskParmPtr );
+
+/*=====[Definitions of private global variables]=============================*/
+static uint32_t         gestures_dropped;         //flancos descartados por cola llena
+static xQueueHandle     gestures_queue;
+
+#if KEYS_USE_STATIC==1
+static StackType_t      task_gestures_stack[GESTURES_TASK_STACK];
+static StaticTask_t     task_gestures_tcb;
+static uint8_t          gestures_queue_storage[GESTURES_QUEUE_LEN * sizeof( t_key_isr_signal )];
+static StaticQueue_t    gestures_queue_struct;
+#endif
+
+/*=====[Implementations of public functions]=================================*/
+void gestures_Init( const t_gesture_config* config )
+{
+    BaseType_t res;
+
+    gestures_fsm_Init( config );
+
+#if GESTURES_MEASURE_CYCLES==1
+    cyclesCounterInit( SystemCoreClock );
+#endif
+
+#if KEYS_USE_STATIC==1
+    gestures_queue = xQueueCreateStatic( GESTURES_QUEUE_LEN, sizeof( t_key_isr_signal ), gestures_queue_storage, &gestures_queue_struct );
+#else
+    gestures_queue = xQueueCreate( GESTURES_QUEUE_LEN, sizeof( t_key_isr_signal ) );
+#endif
+
+    configASSERT( gestures_queue != NULL );
+
+    /* una unica tarea atiende los temporizados de todas las teclas */
+#if KEYS_USE_STATIC==1
+    res = xTaskCreateStatic (
+              task_gestures,					// Funcion de la tarea a ejecutar
+              ( const char * )"task_gestures",	// Nombre de la tarea como String amigable para el usuario
+              GESTURES_TASK_STACK,				// Cantidad de stack de la tarea
+              0,								// Parametros de tarea
+              tskIDLE_PRIORITY+1,				// Prioridad de la tarea
+              task_gestures_stack,				// Stack de la tarea
+              &task_gestures_tcb				// TCB de la tarea
+          ) != NULL ? pdPASS : pdFAIL;
+#else
+    res = xTaskCreate (
+              task_gestures,					// Funcion de la tarea a ejecutar
+              ( const char * )"task_gestures",	// Nombre de la tarea como String amigable para el usuario
+              GESTURES_TASK_STACK,				// Cantidad de stack de la tarea
+              0,								// Parametros de tarea
+              tskIDLE_PRIORITY+1,				// Prioridad de la tarea
+              0								// Puntero a la tarea creada en el sistema
+          );
+#endif
+
+    // Gestión de errores
+    configASSERT( res == pdPASS );
+}
+
+/* entrega un flanco ya filtrado por keys.c al reconocedor. No bloquea al productor. */
+void gestures_post( t_key_isr_signal* event_data )
+{
+    if( xQueueSend( gestures_queue, event_data, 0 ) != pdPASS )
+    {
+        taskENTER_CRITICAL();
+        gestures_dropped++;
+        taskEXIT_CRITICAL();
+    }
+}
+
+void gestures_get_stats( t_gesture_stats* stats )
+{
+    taskENTER_CRITICAL();
+    gestures_fsm_get_stats( stats );
+    stats->dropped = gestures_dropped;
+    taskEXIT_CRITICAL();
+}
+
+/*=====[Implementations of private functions]================================*/
+static void task_gestures( void* taskParmPtr )
+{
+    t_key_isr_signal event_data;
+    TickType_t wait = portMAX_DELAY;
+
+    while( 1 )
+    {
+        if( xQueueReceive( gestures_queue, &event_data, wait ) == pdPASS )
+        {
+            gestures_process_edge( &event_data );
+        }
+
+        wait = gestures_process_timeout( xTaskGetTickCount() - pdMS_TO_TICKS( GESTURES_SETTLE_MS ) );
+    }
+}
@@ -0,0 +1,499 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[ Inclusions ]============================================*/
+#include "gestures.h"
+#if GESTURES_USE_TABLE==1
+#include "fsm_table.h"
+#endif
+
+/* Nucleo del reconocedor: la FSM de cada tecla, sin dependencias del RTOS. La tarea y la
+   cola que la alimentan estan en gestures.c; test/test_gestures.c la ejercita en la PC. */
+
+/*=====[ Definitions of private data types ]===================================*/
+typedef enum
+{
+    GESTURE_STATE_IDLE,         //tecla suelta, sin gesto en curso
+    GESTURE_STATE_DOWN,         //tecla pulsada, esperando liberacion o timeout de pulsacion larga
+    GESTURE_STATE_WAIT_CLICK,   //tecla liberada, esperando un nuevo click o timeout de multi-click
+    GESTURE_STATE_HELD,         //pulsacion larga ya informada, esperando liberacion
+    GESTURE_STATE_IN_CHORD      //tecla consumida por un acorde, esperando liberacion
+} t_gesture_state;
+
+typedef struct
+{
+    t_gesture_state state;
+    uint32_t        clicks;         //clicks acumulados en el gesto en curso
+    TickType_t      time_first;     //timestamp de la primera pulsacion del gesto
+    TickType_t      time_down;      //timestamp de la ultima pulsacion
+    TickType_t      deadline;       //vencimiento (solo en DOWN y WAIT_CLICK)
+} t_gesture_key;
+
+/*=====[Definition macros of private constants]==============================*/
+/* comparacion de timestamps tolerante al desborde del contador de ticks */
+#define TIME_REACHED( now, deadline )   ( ( int32_t )( ( now ) - ( deadline ) ) >= 0 )
+
+#define GESTURE_STATES      5   //GESTURE_STATE_IDLE .. GESTURE_STATE_IN_CHORD
+
+/*=====[Prototypes (declarations) of private functions]======================*/
+static void gestures_publish( t_gesture_type type, uint32_t tecla, uint32_t tecla2, TickType_t event_time, TickType_t duration );
+#if GESTURES_USE_TABLE==1
+static void gestures_dispatch( uint32_t index, uint8_t event, TickType_t t );
+static uint8_t gestures_press_event( uint32_t index, TickType_t t );
+static uint8_t gestures_release_event( uint32_t index );
+static void gestures_act_nop( uint32_t index );
+static void gestures_act_first_down( uint32_t index );
+static void gestures_act_next_down( uint32_t index );
+static void gestures_act_click( uint32_t index );
+static void gestures_act_triple( uint32_t index );
+static void gestures_act_long( uint32_t index );
+static void gestures_act_clicks_done( uint32_t index );
+static void gestures_act_chord( uint32_t index );
+#else
+static void gestures_press( uint32_t index, TickType_t t );
+static void gestures_release( uint32_t index, TickType_t t );
+#endif
+
+/*=====[Definitions of private global variables]=============================*/
+static t_gesture_config gestures_config =
+{
+    .long_press  = pdMS_TO_TICKS( GESTURES_LONG_PRESS_MS ),
+    .multi_click = pdMS_TO_TICKS( GESTURES_MULTI_CLICK_MS ),
+    .chord       = pdMS_TO_TICKS( GESTURES_CHORD_MS ),
+};
+
+static t_gesture_key    gestures_keys[GESTURES_MAX_KEYS];
+static t_gesture_stats  gestures_stats;
+
+#if GESTURES_USE_TABLE==1
+/* eventos de la FSM de una tecla. Las condiciones que antes estaban dentro de los switch
+   (acorde con otra tecla, tercer click) se resuelven al clasificar el flanco */
+#define GEST_EV_PRESS           0   //flanco de bajada
+#define GEST_EV_CHORD           1   //flanco de bajada que completa un acorde con otra tecla pulsada
+#define GEST_EV_RELEASE         2   //flanco de subida
+#define GEST_EV_RELEASE_LAST    3   //flanco de subida que completa el tercer click
+#define GEST_EV_TIMEOUT         4   //vencio deadline
+#define GEST_EV_COUNT           5
+
+#define GEST_ACT_NONE           0
+#define GEST_ACT_FIRST_DOWN     1
+#define GEST_ACT_NEXT_DOWN      2
+#define GEST_ACT_CLICK          3
+#define GEST_ACT_TRIPLE         4
+#define GEST_ACT_LONG           5
+#define GEST_ACT_CLICKS_DONE    6
+#define GEST_ACT_CHORD          7
+
+/* T( estado, evento, estado siguiente, accion ) */
+#define GESTURES_FSM( T ) \
+    T( GESTURE_STATE_IDLE,       GEST_EV_PRESS,        GESTURE_STATE_DOWN,       GEST_ACT_FIRST_DOWN  ) \
+    T( GESTURE_STATE_IDLE,       GEST_EV_CHORD,        GESTURE_STATE_IN_CHORD,   GEST_ACT_CHORD       ) \
+    T( GESTURE_STATE_IDLE,       GEST_EV_RELEASE,      GESTURE_STATE_IDLE,       GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_IDLE,       GEST_EV_RELEASE_LAST, GESTURE_STATE_IDLE,       GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_IDLE,       GEST_EV_TIMEOUT,      GESTURE_STATE_IDLE,       GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_DOWN,       GEST_EV_PRESS,        GESTURE_STATE_DOWN,       GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_DOWN,       GEST_EV_CHORD,        GESTURE_STATE_IN_CHORD,   GEST_ACT_CHORD       ) \
+    T( GESTURE_STATE_DOWN,       GEST_EV_RELEASE,      GESTURE_STATE_WAIT_CLICK, GEST_ACT_CLICK       ) \
+    T( GESTURE_STATE_DOWN,       GEST_EV_RELEASE_LAST, GESTURE_STATE_IDLE,       GEST_ACT_TRIPLE      ) \
+    T( GESTURE_STATE_DOWN,       GEST_EV_TIMEOUT,      GESTURE_STATE_HELD,       GEST_ACT_LONG        ) \
+    T( GESTURE_STATE_WAIT_CLICK, GEST_EV_PRESS,        GESTURE_STATE_DOWN,       GEST_ACT_NEXT_DOWN   ) \
+    T( GESTURE_STATE_WAIT_CLICK, GEST_EV_CHORD,        GESTURE_STATE_IN_CHORD,   GEST_ACT_CHORD       ) \
+    T( GESTURE_STATE_WAIT_CLICK, GEST_EV_RELEASE,      GESTURE_STATE_WAIT_CLICK, GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_WAIT_CLICK, GEST_EV_RELEASE_LAST, GESTURE_STATE_WAIT_CLICK, GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_WAIT_CLICK, GEST_EV_TIMEOUT,      GESTURE_STATE_IDLE,       GEST_ACT_CLICKS_DONE ) \
+    T( GESTURE_STATE_HELD,       GEST_EV_PRESS,        GESTURE_STATE_HELD,       GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_HELD,       GEST_EV_CHORD,        GESTURE_STATE_IN_CHORD,   GEST_ACT_CHORD       ) \
+    T( GESTURE_STATE_HELD,       GEST_EV_RELEASE,      GESTURE_STATE_IDLE,       GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_HELD,       GEST_EV_RELEASE_LAST, GESTURE_STATE_IDLE,       GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_HELD,       GEST_EV_TIMEOUT,      GESTURE_STATE_HELD,       GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_IN_CHORD,   GEST_EV_PRESS,        GESTURE_STATE_IN_CHORD,   GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_IN_CHORD,   GEST_EV_CHORD,        GESTURE_STATE_IN_CHORD,   GEST_ACT_CHORD       ) \
+    T( GESTURE_STATE_IN_CHORD,   GEST_EV_RELEASE,      GESTURE_STATE_IDLE,       GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_IN_CHORD,   GEST_EV_RELEASE_LAST, GESTURE_STATE_IDLE,       GEST_ACT_NONE        ) \
+    T( GESTURE_STATE_IN_CHORD,   GEST_EV_TIMEOUT,      GESTURE_STATE_IN_CHORD,   GEST_ACT_NONE        )
+
+#define GESTURES_FSM_ROW( state, event, next, action )  FSM_ROW( GEST_EV_COUNT, state, event, next, action )
+#define GESTURES_FSM_CELL( state, event, next, action ) FSM_CELLS( GEST_EV_COUNT, state, event )
+
+_Static_assert( ( 0 GESTURES_FSM( FSM_COUNT ) ) == GESTURE_STATES * GEST_EV_COUNT, "GESTURES_FSM: sobran o faltan transiciones" );
+_Static_assert( ( 0 GESTURES_FSM( GESTURES_FSM_CELL ) ) == FSM_ALL_CELLS( GESTURE_STATES, GEST_EV_COUNT ), "GESTURES_FSM: par (estado, evento) repetido o faltante" );
+
+static const t_fsm_transition gestures_fsm_table[GESTURE_STATES * GEST_EV_COUNT] = { GESTURES_FSM( GESTURES_FSM_ROW ) };
+
+static const t_fsm_action gestures_fsm_actions[] =
+{
+    [GEST_ACT_NONE]         = gestures_act_nop,
+    [GEST_ACT_FIRST_DOWN]   = gestures_act_first_down,
+    [GEST_ACT_NEXT_DOWN]    = gestures_act_next_down,
+    [GEST_ACT_CLICK]        = gestures_act_click,
+    [GEST_ACT_TRIPLE]       = gestures_act_triple,
+    [GEST_ACT_LONG]         = gestures_act_long,
+    [GEST_ACT_CLICKS_DONE]  = gestures_act_clicks_done,
+    [GEST_ACT_CHORD]        = gestures_act_chord,
+};
+
+static const t_fsm gestures_fsm = { gestures_fsm_table, gestures_fsm_actions, GESTURE_STATES, GEST_EV_COUNT };
+
+/* estados con deadline: solo en ellos puede vencer un temporizado */
+static const uint8_t gestures_timed[GESTURE_STATES] = { [GESTURE_STATE_DOWN] = 1, [GESTURE_STATE_WAIT_CLICK] = 1 };
+
+static TickType_t   gestures_now;       //instante del evento que se esta despachando
+static uint32_t     gestures_partner;   //la otra tecla del acorde (GEST_EV_CHORD)
+#endif
+
+/*=====[Implementations of public functions]=================================*/
+void gestures_fsm_Init( const t_gesture_config* config )
+{
+    if( config != NULL )
+    {
+        gestures_config = *config;
+    }
+
+    for( int i = 0; i < GESTURES_MAX_KEYS; i++ )
+    {
+        gestures_keys[i].state  = GESTURE_STATE_IDLE;
+        gestures_keys[i].clicks = 0;
+    }
+
+    gestures_stats = ( t_gesture_stats ) { 0 };
+}
+
+/* sin proteccion: el llamador decide si hace falta una seccion critica */
+void gestures_fsm_get_stats( t_gesture_stats* stats )
+{
+    *stats = gestures_stats;
+}
+
+/**
+   @brief procesa un flanco de una tecla.
+          Antes de aplicarlo se vencen los temporizados anteriores al flanco,
+          para que el orden de los eventos respete sus timestamps.
+
+   @param event_data
+ */
+void gestures_process_edge( t_key_isr_signal* event_data )
+{
+    uint32_t index = event_data->tecla;
+
+#if GESTURES_MEASURE_CYCLES==1
+    uint32_t cycles = cyclesCounterRead();
+#endif
+
+    if( index >= GESTURES_MAX_KEYS )
+    {
+        return;
+    }
+
+    gestures_process_timeout( event_data->event_time );
+
+#if GESTURES_USE_TABLE==1
+    if( event_data->event_type == TEC_FALL )
+    {
+        gestures_dispatch( index, gestures_press_event( index, event_data->event_time ), event_data->event_time );
+    }
+    else
+    {
+        gestures_dispatch( index, gestures_release_event( index ), event_data->event_time );
+    }
+#else
+    if( event_data->event_type == TEC_FALL )
+    {
+        gestures_press( index, event_data->event_time );
+    }
+    else
+    {
+        gestures_release( index, event_data->event_time );
+    }
+#endif
+
+    gestures_stats.events++;
+
+#if GESTURES_MEASURE_CYCLES==1
+    cycles = cyclesCounterRead() - cycles;
+    gestures_stats.cycles_total += cycles;
+
+    if( cycles > gestures_stats.cycles_max )
+    {
+        gestures_stats.cycles_max = cycles;
+    }
+#endif
+}
+
+/**
+   @brief vence los temporizados de todas las teclas hasta el instante now.
+
+   @param now
+   @return ticks hasta el proximo vencimiento, o portMAX_DELAY si no hay ninguno pendiente
+ */
+TickType_t gestures_process_timeout( TickType_t now )
+{
+    TickType_t wait = portMAX_DELAY;
+
+#if GESTURES_USE_TABLE==1
+    for( uint32_t i = 0; i < GESTURES_MAX_KEYS; i++ )
+    {
+        t_gesture_key* key = &gestures_keys[i];
+
+        if( !gestures_timed[key->state] )
+        {
+            continue;
+        }
+
+        if( TIME_REACHED( now, key->deadline ) )
+        {
+            gestures_dispatch( i, GEST_EV_TIMEOUT, now );
+            continue;
+        }
+
+        /* sigue pendiente: calculo cuanto falta */
+        if( key->deadline - now < wait )
+        {
+            wait = key->deadline - now;
+        }
+    }
+#else
+    for( uint32_t i = 0; i < GESTURES_MAX_KEYS; i++ )
+    {
+        t_gesture_key* key = &gestures_keys[i];
+
+        switch( key->state )
+        {
+            case GESTURE_STATE_DOWN:
+                if( TIME_REACHED( now, key->deadline ) )
+                {
+                    key->state = GESTURE_STATE_HELD;
+                    gestures_publish( GESTURE_LONG_PRESS, i, i, key->time_down, now - key->time_down );
+                    continue;
+                }
+                break;
+
+            case GESTURE_STATE_WAIT_CLICK:
+                if( TIME_REACHED( now, key->deadline ) )
+                {
+                    key->state = GESTURE_STATE_IDLE;
+                    gestures_publish( ( key->clicks == 1 ) ? GESTURE_CLICK : GESTURE_DOUBLE_CLICK, i, i, key->time_first, 0 );
+                    continue;
+                }
+                break;
+
+            default:
+                continue;
+        }
+
+        /* sigue pendiente: calculo cuanto falta */
+        if( key->deadline - now < wait )
+        {
+            wait = key->deadline - now;
+        }
+    }
+#endif
+
+    return wait;
+}
+
+/*=====[Implementations of private functions]================================*/
+static void gestures_publish( t_gesture_type type, uint32_t tecla, uint32_t tecla2, TickType_t event_time, TickType_t duration )
+{
+    t_gesture_event gesture;
+
+    gesture.type        = type;
+    gesture.tecla       = tecla;
+    gesture.tecla2      = tecla2;
+    gesture.event_time  = event_time;
+    gesture.duration    = duration;
+
+    gestures_stats.gestures++;
+
+    user_gesture( &gesture );
+}
+
+#if GESTURES_USE_TABLE==1
+static void gestures_dispatch( uint32_t index, uint8_t event, TickType_t t )
+{
+    t_gesture_key* key = &gestures_keys[index];
+
+    gestures_now = t;
+    key->state   = ( t_gesture_state ) fsm_run( &gestures_fsm, key->state, event, index );
+}
+
+/* acorde: otra tecla se pulso hace menos de gestures_config.chord y aun no forma parte de otro gesto */
+static uint8_t gestures_press_event( uint32_t index, TickType_t t )
+{
+    for( uint32_t j = 0; j < GESTURES_MAX_KEYS; j++ )
+    {
+        t_gesture_key* other = &gestures_keys[j];
+
+        if( j != index && other->state == GESTURE_STATE_DOWN && other->clicks == 0 &&
+                ( t - other->time_down ) <= gestures_config.chord )
+        {
+            gestures_partner = j;
+            return GEST_EV_CHORD;
+        }
+    }
+
+    return GEST_EV_PRESS;
+}
+
+/* la liberacion que completa el tercer click es un evento aparte: la tabla no evalua condiciones */
+static uint8_t gestures_release_event( uint32_t index )
+{
+    return ( gestures_keys[index].clicks >= 2 ) ? GEST_EV_RELEASE_LAST : GEST_EV_RELEASE;
+}
+
+static void gestures_act_nop( uint32_t index )
+{
+}
+
+static void gestures_act_first_down( uint32_t index )
+{
+    gestures_keys[index].clicks     = 0;
+    gestures_keys[index].time_first = gestures_now;
+
+    gestures_act_next_down( index );
+}
+
+static void gestures_act_next_down( uint32_t index )
+{
+    gestures_keys[index].time_down  = gestures_now;
+    gestures_keys[index].deadline   = gestures_now + gestures_config.long_press;
+}
+
+static void gestures_act_click( uint32_t index )
+{
+    gestures_keys[index].clicks++;
+    gestures_keys[index].deadline   = gestures_now + gestures_config.multi_click;
+}
+
+static void gestures_act_triple( uint32_t index )
+{
+    gestures_keys[index].clicks++;
+    gestures_publish( GESTURE_TRIPLE_CLICK, index, index, gestures_keys[index].time_first, 0 );
+}
+
+static void gestures_act_long( uint32_t index )
+{
+    t_gesture_key* key = &gestures_keys[index];
+
+    gestures_publish( GESTURE_LONG_PRESS, index, index, key->time_down, gestures_now - key->time_down );
+}
+
+static void gestures_act_clicks_done( uint32_t index )
+{
+    t_gesture_key* key = &gestures_keys[index];
+
+    gestures_publish( ( key->clicks == 1 ) ? GESTURE_CLICK : GESTURE_DOUBLE_CLICK, index, index, key->time_first, 0 );
+}
+
+/* la otra tecla del acorde cambia de estado aca: la tabla solo mueve a la tecla del flanco */
+static void gestures_act_chord( uint32_t index )
+{
+    t_gesture_key* other = &gestures_keys[gestures_partner];
+
+    other->state                = GESTURE_STATE_IN_CHORD;
+    gestures_keys[index].clicks = 0;
+
+    gestures_publish( GESTURE_CHORD, gestures_partner, index, other->time_down, 0 );
+}
+#else
+static void gestures_press( uint32_t index, TickType_t t )
+{
+    t_gesture_key* key = &gestures_keys[index];
+
+    /* acorde: otra tecla se pulso hace menos de gestures_config.chord y aun no forma parte de otro gesto */
+    for( uint32_t j = 0; j < GESTURES_MAX_KEYS; j++ )
+    {
+        t_gesture_key* other = &gestures_keys[j];
+
+        if( j != index && other->state == GESTURE_STATE_DOWN && other->clicks == 0 &&
+                ( t - other->time_down ) <= gestures_config.chord )
+        {
+            other->state = GESTURE_STATE_IN_CHORD;
+            key->state   = GESTURE_STATE_IN_CHORD;
+            key->clicks  = 0;
+
+            gestures_publish( GESTURE_CHORD, j, index, other->time_down, 0 );
+            return;
+        }
+    }
+
+    switch( key->state )
+    {
+        case GESTURE_STATE_IDLE:
+            key->clicks     = 0;
+            key->time_first = t;
+            /* no break */
+
+        case GESTURE_STATE_WAIT_CLICK:
+            key->state      = GESTURE_STATE_DOWN;
+            key->time_down  = t;
+            key->deadline   = t + gestures_config.long_press;
+            break;
+
+        default:
+            /* flanco repetido: lo ignoro */
+            break;
+    }
+}
+
+static void gestures_release( uint32_t index, TickType_t t )
+{
+    t_gesture_key* key = &gestures_keys[index];
+
+    switch( key->state )
+    {
+        case GESTURE_STATE_DOWN:
+            key->clicks++;
+
+            if( key->clicks >= 3 )
+            {
+                key->state = GESTURE_STATE_IDLE;
+                gestures_publish( GESTURE_TRIPLE_CLICK, index, index, key->time_first, 0 );
+            }
+            else
+            {
+                key->state      = GESTURE_STATE_WAIT_CLICK;
+                key->deadline   = t + gestures_config.multi_click;
+            }
+            break;
+
+        case GESTURE_STATE_HELD:
+        case GESTURE_STATE_IN_CHORD:
+            key->state = GESTURE_STATE_IDLE;
+            break;
+
+        default:
+            /* flanco repetido: lo ignoro */
+            break;
+    }
+}
+#endif
@@ -0,0 +1,373 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[ Inclusions ]============================================*/
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+#include "sapi.h"
+#include "keypad.h"
+
+/*=====[ Definitions of private data types ]===================================*/
+
+/* contadores verticales: un bit por tecla de la matriz */
+typedef struct
+{
+    uint32_t state;         //1 = tecla pulsada (antirreboteada)
+    uint32_t cnt0;
+    uint32_t cnt1;
+    uint32_t delta;         //teclas cuyo nivel difiere de state en el ultimo barrido
+} t_keypad_vc;
+
+/*=====[Definition macros of private constants]==============================*/
+/* canales PININT usados para despertar con cualquier columna (TEC1..TEC4 usan 0..3) */
+#define KEYPAD_FIRST_PININT     4
+
+/* vueltas de espera para que la fila recien activada se estabilice antes de leer columnas */
+#define KEYPAD_SETTLE_LOOPS     20
+
+/*=====[Prototypes (declarations) of private functions]======================*/
+static uint32_t keypad_vc_update( t_keypad_vc* vc, uint32_t sample );
+static uint32_t keypad_read_cols( void );
+static uint32_t keypad_scan( void );
+static void keypad_rows_all( bool_t level );
+static void keypad_isr_config( void );
+static void keypad_isr_enable( void );
+static void keypad_isr_disable( void );
+static void task_keypad( void* taskParmPtr );
+
+void user_buttonPressed( t_key_isr_signal* event_data );
+void user_buttonReleased( t_key_isr_signal* event_data );
+
+/*=====[Definitions of private global variables]=============================*/
+
+/* mismo conexionado que el ejemplo de sapi_keypad */
+static const gpioMap_t keypad_rows[KEYPAD_ROWS] = { RS232_TXD, CAN_RD, CAN_TD, T_COL1 };
+static const gpioMap_t keypad_cols[KEYPAD_COLS] = { T_FIL0, T_FIL3, T_FIL2, T_COL0 };
+
+static t_keypad_vc      keypad_vc;
+static TickType_t       keypad_edge_time[KEYPAD_KEYS];   //primer barrido en que se vio el cambio
+static t_keypad_stats   keypad_stats;
+static SemaphoreHandle_t keypad_wakeup;
+
+#define KEYPAD_TASK_STACK   ( configMINIMAL_STACK_SIZE*2 )
+
+#if KEYS_USE_STATIC==1
+static StackType_t      task_keypad_stack[KEYPAD_TASK_STACK];
+static StaticTask_t     task_keypad_tcb;
+static StaticSemaphore_t keypad_wakeup_struct;
+#endif
+
+extern pinInitGpioLpc4337_t gpioPinsInit[];
+
+/*=====[Implementations of public functions]=================================*/
+void keypad_Init( void )
+{
+    BaseType_t res;
+
+    for( int i = 0; i < KEYPAD_ROWS; i++ )
+    {
+        gpioInit( keypad_rows[i], GPIO_OUTPUT );
+        gpioWrite( keypad_rows[i], ON );
+    }
+
+    for( int i = 0; i < KEYPAD_COLS; i++ )
+    {
+        gpioInit( keypad_cols[i], GPIO_INPUT_PULLUP );
+    }
+
+#if KEYPAD_MEASURE_CYCLES==1
+    cyclesCounterInit( SystemCoreClock );
+#endif
+
+#if KEYS_USE_STATIC==1
+    keypad_wakeup = xSemaphoreCreateBinaryStatic( &keypad_wakeup_struct );
+#else
+    keypad_wakeup = xSemaphoreCreateBinary();
+#endif
+
+    configASSERT( keypad_wakeup != NULL );
+
+#if KEYS_USE_STATIC==1
+    res = xTaskCreateStatic (
+              task_keypad,					// Funcion de la tarea a ejecutar
+              ( const char * )"task_keypad",	// Nombre de la tarea como String amigable para el usuario
+              KEYPAD_TASK_STACK,			// Cantidad de stack de la tarea
+              0,							// Parametros de tarea
+              tskIDLE_PRIORITY+1,			// Prioridad de la tarea
+              task_keypad_stack,			// Stack de la tarea
+              &task_keypad_tcb				// TCB de la tarea
+          ) != NULL ? pdPASS : pdFAIL;
+#else
+    res = xTaskCreate (
+              task_keypad,					// Funcion de la tarea a ejecutar
+              ( const char * )"task_keypad",	// Nombre de la tarea como String amigable para el usuario
+              KEYPAD_TASK_STACK,			// Cantidad de stack de la tarea
+              0,							// Parametros de tarea
+              tskIDLE_PRIORITY+1,			// Prioridad de la tarea
+              0							// Puntero a la tarea creada en el sistema
+          );
+#endif
+
+    keypad_isr_config();
+
+    // Gestión de errores
+    configASSERT( res == pdPASS );
+}
+
+void keypad_get_stats( t_keypad_stats* stats )
+{
+    taskENTER_CRITICAL();
+    *stats = keypad_stats;
+    taskEXIT_CRITICAL();
+}
+
+/*=====[Implementations of private functions]================================*/
+
+/* antirrebote de las 16 teclas en paralelo: cambian de estado luego de 4 barridos distintos */
+static uint32_t keypad_vc_update( t_keypad_vc* vc, uint32_t sample )
+{
+    uint32_t toggle;
+
+    vc->delta = sample ^ vc->state;
+    vc->cnt1  = ( vc->cnt1 ^ vc->cnt0 ) & vc->delta;
+    vc->cnt0  = ~vc->cnt0 & vc->delta;
+
+    toggle = vc->delta & ~( vc->cnt0 | vc->cnt1 );
+    vc->state ^= toggle;
+
+    return toggle;
+}
+
+/* devuelve una mascara de KEYPAD_COLS bits con 1 en las columnas en bajo */
+static uint32_t keypad_read_cols( void )
+{
+    uint32_t cols = 0;
+
+    for( int c = 0; c < KEYPAD_COLS; c++ )
+    {
+        if( !gpioRead( keypad_cols[c] ) )
+        {
+            cols |= 1UL << c;
+        }
+    }
+
+    return cols;
+}
+
+/* barre las filas y arma una mascara de 16 bits, bit = fila * KEYPAD_COLS + columna */
+static uint32_t keypad_scan( void )
+{
+    uint32_t sample = 0;
+
+    keypad_rows_all( ON );
+
+    for( int r = 0; r < KEYPAD_ROWS; r++ )
+    {
+        gpioWrite( keypad_rows[r], OFF );
+
+        for( volatile int d = 0; d < KEYPAD_SETTLE_LOOPS; d++ )
+        {
+        }
+
+        sample |= keypad_read_cols() << ( r * KEYPAD_COLS );
+
+        gpioWrite( keypad_rows[r], ON );
+    }
+
+    return sample;
+}
+
+static void keypad_rows_all( bool_t level )
+{
+    for( int r = 0; r < KEYPAD_ROWS; r++ )
+    {
+        gpioWrite( keypad_rows[r], level );
+    }
+}
+
+static void task_keypad( void* taskParmPtr )
+{
+    t_key_isr_signal event_data;
+    TickType_t xLastWakeTime;
+    uint32_t toggle;
+    uint32_t new_delta;
+    uint32_t prev_delta = 0;
+
+    while( 1 )
+    {
+        /* reposo: todas las filas en bajo, cualquier tecla pulsada baja una columna */
+        keypad_rows_all( OFF );
+        keypad_isr_enable();
+
+        if( keypad_read_cols() == 0 )
+        {
+            xSemaphoreTake( keypad_wakeup, portMAX_DELAY );
+            keypad_stats.wakeups++;
+        }
+
+        keypad_isr_disable();
+
+        /* actividad: barrido periodico hasta que todas las teclas se liberen y se estabilicen */
+        xLastWakeTime = xTaskGetTickCount();
+
+        do
+        {
+#if KEYPAD_MEASURE_CYCLES==1
+            uint32_t cycles = cyclesCounterRead();
+#endif
+            TickType_t now = xTaskGetTickCount();
+
+            toggle = keypad_vc_update( &keypad_vc, keypad_scan() );
+            keypad_stats.scans++;
+
+            /* el timestamp del evento es el del primer barrido en que se vio el cambio */
+            new_delta = keypad_vc.delta & ~prev_delta;
+            prev_delta = keypad_vc.delta;
+
+            for( uint32_t k = 0; new_delta != 0; k++, new_delta >>= 1 )
+            {
+                if( new_delta & 1 )
+                {
+                    keypad_edge_time[k] = now;
+                }
+            }
+
+            for( uint32_t k = 0; toggle != 0; k++, toggle >>= 1 )
+            {
+                if( toggle & 1 )
+                {
+                    event_data.tecla      = KEYPAD_FIRST_INDEX + k;
+                    event_data.event_time = keypad_edge_time[k];
+
+                    if( keypad_vc.state & ( 1UL << k ) )
+                    {
+                        event_data.event_type = TEC_FALL;
+                        user_buttonPressed( &event_data );
+                    }
+                    else
+                    {
+                        event_data.event_type = TEC_RISE;
+                        user_buttonReleased( &event_data );
+                    }
+
+                    keypad_stats.events++;
+                }
+            }
+
+#if KEYPAD_MEASURE_CYCLES==1
+            keypad_stats.scan_cycles_last = cyclesCounterRead() - cycles;
+
+            if( keypad_stats.scan_cycles_last > keypad_stats.scan_cycles_max )
+            {
+                keypad_stats.scan_cycles_max = keypad_stats.scan_cycles_last;
+            }
+#endif
+
+            vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( KEYPAD_SCAN_MS ) );
+        }
+        while( keypad_vc.state != 0 || keypad_vc.delta != 0 );
+    }
+}
+
+/**
+   @brief   Asocia cada columna a un canal PININT, sensible al flanco descendente.
+            Las interrupciones quedan deshabilitadas hasta que el servicio entra en reposo.
+ */
+static void keypad_isr_config( void )
+{
+    for( int c = 0; c < KEYPAD_COLS; c++ )
+    {
+        uint8_t ch = KEYPAD_FIRST_PININT + c;
+
+        Chip_SCU_GPIOIntPinSel( ch, gpioPinsInit[keypad_cols[c]].gpio.port, gpioPinsInit[keypad_cols[c]].gpio.pin );
+        Chip_PININT_SetPinModeEdge( LPC_GPIO_PIN_INT, PININTCH( ch ) );
+        Chip_PININT_EnableIntLow( LPC_GPIO_PIN_INT, PININTCH( ch ) );
+
+        NVIC_SetPriority( ( IRQn_Type )( PIN_INT4_IRQn + c ), configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY );
+    }
+}
+
+static void keypad_isr_enable( void )
+{
+    for( int c = 0; c < KEYPAD_COLS; c++ )
+    {
+        Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH( KEYPAD_FIRST_PININT + c ) );
+        NVIC_ClearPendingIRQ( ( IRQn_Type )( PIN_INT4_IRQn + c ) );
+        NVIC_EnableIRQ( ( IRQn_Type )( PIN_INT4_IRQn + c ) );
+    }
+}
+
+static void keypad_isr_disable( void )
+{
+    for( int c = 0; c < KEYPAD_COLS; c++ )
+    {
+        NVIC_DisableIRQ( ( IRQn_Type )( PIN_INT4_IRQn + c ) );
+    }
+}
+
+/* cualquier columna: deshabilito las interrupciones (durante el barrido habria un flanco por fila)
+   y despierto al servicio */
+static void keypad_isr( uint32_t ch )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH( ch ) );
+
+    keypad_isr_disable();
+
+    xSemaphoreGiveFromISR( keypad_wakeup, &xHigherPriorityTaskWoken );
+
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+void GPIO4_IRQHandler( void )
+{
+    keypad_isr( KEYPAD_FIRST_PININT + 0 );
+}
+
+void GPIO5_IRQHandler( void )
+{
+    keypad_isr( KEYPAD_FIRST_PININT + 1 );
+}
+
+void GPIO6_IRQHandler( void )
+{
+    keypad_isr( KEYPAD_FIRST_PININT + 2 );
+}
+
+void GPIO7_IRQHandler( void )
+{
+    keypad_isr( KEYPAD_FIRST_PININT + 3 );
+}
@@ -36,21 +36,33 @@
 
 #include "sapi.h"
 #include "keys.h"
+#include "keys_sim.h"
+#include "keys_journal.h"
+#include "keys_debounce.h"
 
 /*=====[ Definitions of private data types ]===================================*/
 
 /*=====[Definition macros of private constants]==============================*/
 //#define BUTTON_RATE     1
-#define DEBOUNCE_TIME   40
 
-#define TEC_FALL        0
-#define TEC_RISE        1
+/* nivel de la tecla: el pin real o el guion de keys_sim.c */
+#if KEYS_SIM==1
+#define keys_read( index )  keys_sim_read( index )
+#else
+#define keys_read( index )  gpioRead( keys_config[index].tecla )
+#endif
+
+/* barrera de compilador: evita que se reordenen los accesos a keys_data alrededor de seq */
+#define KEYS_BARRIER()  __asm volatile( "" ::: "memory" )
 
 /*=====[Prototypes (declarations) of private functions]======================*/
 static void keys_isr_config( void );
 
 static void buttonPressed( t_key_isr_signal* event_data );
 static void buttonReleased( t_key_isr_signal* event_data );
+static void keys_publish_times( uint32_t index );
+static void keys_isr_post( t_key_isr_signal* evnt, BaseType_t* woken );
+static void keys_debounce_wait( t_key_isr_signal* event_data );
 void user_buttonPressed( t_key_isr_signal* event_data );
 void user_buttonReleased( t_key_isr_signal* event_data );
 
@@ -62,69 +74,185 @@ const t_key_config  keys_config[] = { [TEC1_INDEX]= {TEC1}, [TEC2_INDEX]= {TEC2}
 
 #define key_count   sizeof(keys_config)/sizeof(keys_config[TEC1_INDEX])
 
+/* un pulsado y un liberado en vuelo por tecla, mas margen */
+#define KEYS_ISR_QUEUE_LEN  ( 2 * key_count + 2 )
+#define KEYS_TASK_STACK     ( configMINIMAL_STACK_SIZE*2 )
+
 t_key_data keys_data[key_count];
 
 
 
 xQueueHandle isr_queue; //almacenara el evento en una cola
 
+EventGroupHandle_t keys_events; //estado de las teclas publicado a cualquier cantidad de tareas
+
+#if KEYS_USE_STATIC==1
+static StackType_t          task_tecla_stack[KEYS_TASK_STACK];
+static StaticTask_t         task_tecla_tcb;
+static uint8_t              isr_queue_storage[KEYS_ISR_QUEUE_LEN * sizeof( t_key_isr_signal )];
+static StaticQueue_t        isr_queue_struct;
+static StaticEventGroup_t   keys_events_struct;
+#endif
+
 /*=====[prototype of private functions]=================================*/
 void task_tecla( void* taskParmPtr );
 
 /*=====[Implementations of public functions]=================================*/
 TickType_t get_diff( uint32_t index )
 {
-    TickType_t tiempo;
+    return keys_data[index].time_diff;
+}
+
+void clear_diff()
+{
+    keys_data[TEC1_INDEX].time_diff = 0;
+}
+
+/**
+   @brief obtiene una copia consistente de los timestamps de una tecla, sin secciones criticas.
+          Se copia el buffer publicado (seq & 1); si durante la copia task_tecla publico una
+          nueva version, seq cambia y se vuelve a copiar. La tarea lectora nunca espera a que
+          termine una escritura, porque task_tecla escribe siempre en el otro buffer.
+
+   @param index
+   @param times
+ */
+void keys_get_times( uint32_t index, t_key_times* times )
+{
+    uint32_t seq;
 
+    do
+    {
+        seq = keys_data[index].seq;
+        KEYS_BARRIER();
+        *times = keys_data[index].times[seq & 1];
+        KEYS_BARRIER();
+    }
+    while( seq != keys_data[index].seq );
+}
+
+/**
+   @brief copia los contadores del prefiltro de la ISR de una tecla.
+          Los contadores los escribe solo la ISR de esa tecla; se copian dentro de una
+          seccion critica (que enmascara las PININT) para obtener un conjunto coherente.
+
+   @param index
+   @param stats
+ */
+void keys_get_isr_stats( uint32_t index, t_key_isr_stats* stats )
+{
     taskENTER_CRITICAL();
-    tiempo = keys_data[index].time_diff;
+    *stats = keys_data[index].isr_stats;
     taskEXIT_CRITICAL();
-
-    return tiempo;
 }
 
-void clear_diff()
+/**
+   @brief copia los valores aprendidos por el antirrebote adaptivo de una tecla.
+          Solo task_tecla los escribe.
+
+   @param index
+   @param stats
+ */
+void keys_get_debounce_stats( uint32_t index, t_key_debounce_stats* stats )
 {
     taskENTER_CRITICAL();
-    keys_data[TEC1_INDEX].time_diff = 0;
+    *stats = keys_data[index].debounce;
     taskEXIT_CRITICAL();
 }
 
+/**
+   @brief bloquea a la tarea hasta que las teclas indicadas esten pulsadas.
+          Los bits KEYS_EVT_DOWN son de nivel: no se borran al salir, para que
+          cualquier cantidad de tareas pueda esperar la misma combinacion.
+
+   @param keys      mascara de KEYS_EVT_DOWN( index )
+   @param all       pdTRUE: todas las teclas de la mascara, pdFALSE: cualquiera de ellas
+   @param timeout
+   @return bits del event group al salir
+ */
+EventBits_t keys_wait_down( EventBits_t keys, BaseType_t all, TickType_t timeout )
+{
+    return xEventGroupWaitBits( keys_events, keys, pdFALSE, all, timeout );
+}
+
+/**
+   @brief bloquea a la tarea hasta que se libere alguna de las teclas indicadas.
+          Los bits KEYS_EVT_RELEASED son pulsos: xEventGroupSetBits despierta a todas
+          las tareas que esperan y luego el kernel los borra (clear on exit), por lo que
+          cada tarea ve cada liberacion una sola vez.
+
+   @param keys      mascara de KEYS_EVT_RELEASED( index )
+   @param timeout
+   @return bits del event group al salir
+ */
+EventBits_t keys_wait_released( EventBits_t keys, TickType_t timeout )
+{
+    return xEventGroupWaitBits( keys_events, keys, pdTRUE, pdFALSE, timeout );
+}
+
 
 
 void keys_Init( void )
 {
     BaseType_t res;
 
-    isr_queue      = xQueueCreate( 10,sizeof(   t_key_isr_signal ) ) ;
+#if KEYS_USE_STATIC==1
+    isr_queue      = xQueueCreateStatic( KEYS_ISR_QUEUE_LEN, sizeof( t_key_isr_signal ), isr_queue_storage, &isr_queue_struct );
+#else
+    isr_queue      = xQueueCreate( KEYS_ISR_QUEUE_LEN, sizeof( t_key_isr_signal ) );
+#endif
 
     configASSERT( isr_queue != NULL );
 
-    for( int i; i < key_count ; i++ )
+#if KEYS_USE_STATIC==1
+    keys_events    = xEventGroupCreateStatic( &keys_events_struct );
+#else
+    keys_events    = xEventGroupCreate();
+#endif
+
+    configASSERT( keys_events != NULL );
+
+    for( int i = 0; i < key_count ; i++ )
     {
         keys_data[i].state         = BUTTON_UP;  // Set initial state
         keys_data[i].time_down      = KEYS_INVALID_TIME;
         keys_data[i].time_up        = KEYS_INVALID_TIME;
         keys_data[i].time_diff      = KEYS_INVALID_TIME;
-
-        //keys_data[i].pressed_signal = xSemaphoreCreateBinary();
-
-
-        configASSERT( keys_data[i].pressed_signal != NULL );
+        keys_data[i].seq            = 0;
+        keys_data[i].times[0].time_down = KEYS_INVALID_TIME;
+        keys_data[i].times[0].time_up   = KEYS_INVALID_TIME;
+        keys_data[i].isr_last_time  = ( TickType_t ) 0 - KEYS_ISR_HOLDOFF_MS / portTICK_RATE_MS;
+        keys_data[i].isr_last_type  = TEC_RISE;     //las teclas arrancan liberadas
+        keys_data[i].isr_raw_time   = 0;
+        keys_debounce_reset( &keys_data[i].debounce );
     }
 
     // Crear tareas en freeRTOS
+#if KEYS_USE_STATIC==1
+    res = xTaskCreateStatic (
+              task_tecla,					// Funcion de la tarea a ejecutar
+              ( const char * )"task_tecla",	// Nombre de la tarea como String amigable para el usuario
+              KEYS_TASK_STACK,				// Cantidad de stack de la tarea
+              0,							// Parametros de tarea
+              tskIDLE_PRIORITY+1,			// Prioridad de la tarea
+              task_tecla_stack,				// Stack de la tarea
+              &task_tecla_tcb				// TCB de la tarea
+          ) != NULL ? pdPASS : pdFAIL;
+#else
     res = xTaskCreate (
               task_tecla,					// Funcion de la tarea a ejecutar
               ( const char * )"task_tecla",	// Nombre de la tarea como String amigable para el usuario
-              configMINIMAL_STACK_SIZE*2,	// Cantidad de stack de la tarea
+              KEYS_TASK_STACK,				// Cantidad de stack de la tarea
               0,							// Parametros de tarea
               tskIDLE_PRIORITY+1,			// Prioridad de la tarea
               0							// Puntero a la tarea creada en el sistema
           );
+#endif
 
 
+#if KEYS_SIM==0
     keys_isr_config();
+#endif
 
 
     // Gestión de errores
@@ -134,6 +262,7 @@ void keys_Init( void )
 void keys_Update_Isr( t_key_isr_signal* event_data )
 {
     uint32_t index = event_data->tecla;
+    uint32_t result = KEYS_JRN_IGNORED;
 
     switch( keys_data[index].state )
     {
@@ -141,11 +270,13 @@ void keys_Update_Isr( t_key_isr_signal* event_data )
 
             if( event_data->event_type == TEC_FALL )
             {
-                vTaskDelay( DEBOUNCE_TIME / portTICK_RATE_MS );
+                keys_debounce_wait( event_data );
+                result = KEYS_JRN_REJECTED;
 
-                if( !gpioRead( keys_config[index].tecla ) )
+                if( !keys_read( index ) )
                 {
                     keys_data[index].state = STATE_BUTTON_DOWN;
+                    result = KEYS_JRN_PRESSED;
 
                     /* ACCION DEL EVENTO !*/
                     buttonPressed( event_data );
@@ -158,11 +289,13 @@ void keys_Update_Isr( t_key_isr_signal* event_data )
 
             if( event_data->event_type == TEC_RISE )
             {
-                vTaskDelay( DEBOUNCE_TIME / portTICK_RATE_MS );
+                keys_debounce_wait( event_data );
+                result = KEYS_JRN_REJECTED;
 
-                if(  gpioRead( keys_config[index].tecla ) )
+                if( keys_read( index ) )
                 {
                     keys_data[index].state = STATE_BUTTON_UP;
+                    result = KEYS_JRN_RELEASED;
 
                     /* ACCION DEL EVENTO !*/
                     buttonReleased( event_data );
@@ -171,6 +304,14 @@ void keys_Update_Isr( t_key_isr_signal* event_data )
 
             break;
     }
+
+#if KEYS_JOURNAL==1
+    keys_journal_record( event_data->event_time, index, event_data->event_type, result, xTaskGetTickCount() );
+#endif
+
+    /* resincroniza el prefiltro de la ISR con el estado confirmado: si el flanco final
+       de un rebote cayo dentro del holdoff, el siguiente flanco real tiene que pasar */
+    keys_data[index].isr_last_type = ( keys_data[index].state == STATE_BUTTON_DOWN ) ? TEC_FALL : TEC_RISE;
 }
 
 
@@ -183,9 +324,17 @@ static void buttonPressed( t_key_isr_signal* event_data )
     uint32_t index = event_data->tecla;
 
     //internal event
-    taskENTER_CRITICAL();
     keys_data[index].time_down = event_data->event_time;
-    taskEXIT_CRITICAL();
+    keys_publish_times( index );
+
+#if KEYS_SIM==1
+    keys_sim_report( index, TEC_FALL );
+#endif
+
+    if( index < KEYS_EVT_MAX_KEYS )
+    {
+        xEventGroupSetBits( keys_events, KEYS_EVT_DOWN( index ) );
+    }
 
     //user event
     user_buttonPressed( event_data );
@@ -196,15 +345,69 @@ static void buttonReleased( t_key_isr_signal* event_data )
 {
     uint32_t index = event_data->tecla;
     //internal event
-    taskENTER_CRITICAL();
     keys_data[index].time_up    = event_data->event_time;
     keys_data[index].time_diff  = keys_data[index].time_up - keys_data[index].time_down;
-    taskEXIT_CRITICAL();
+    keys_publish_times( index );
+
+#if KEYS_SIM==1
+    keys_sim_report( index, TEC_RISE );
+#endif
+
+    if( index < KEYS_EVT_MAX_KEYS )
+    {
+        /* pulso: despierta a todos los suscriptores y luego se borra, para que
+           una tarea que empiece a esperar despues no vea una liberacion vieja */
+        xEventGroupClearBits( keys_events, KEYS_EVT_DOWN( index ) );
+        xEventGroupSetBits( keys_events, KEYS_EVT_RELEASED( index ) );
+        xEventGroupClearBits( keys_events, KEYS_EVT_RELEASED( index ) );
+    }
 
     //user event
     user_buttonReleased( event_data );
 }
 
+/**
+   @brief espera a que termine el rebote de la tecla y ajusta su ventana antirrebote.
+          Se espera la ventana aprendida; si la ISR siguio viendo flancos en los ultimos
+          KEYS_DEBOUNCE_MARGIN_MS la espera se extiende, como mucho hasta KEYS_DEBOUNCE_MAX_MS
+          desde el flanco. Las reglas estan en keys_debounce.c.
+
+   @param event_data
+ */
+static void keys_debounce_wait( t_key_isr_signal* event_data )
+{
+    t_key_data* key = &keys_data[event_data->tecla];
+    TickType_t edge = event_data->event_time;
+    TickType_t start = xTaskGetTickCount();
+
+    vTaskDelay( key->debounce.debounce );
+
+    while( keys_debounce_settling( edge, key->isr_raw_time, xTaskGetTickCount() ) )
+    {
+        key->debounce.extended++;
+        vTaskDelay( pdMS_TO_TICKS( KEYS_DEBOUNCE_MARGIN_MS ) );
+    }
+
+    keys_debounce_learn( &key->debounce, edge, key->isr_raw_time, start, xTaskGetTickCount() );
+}
+
+/**
+   @brief publica time_down/time_up para los lectores de keys_get_times.
+          Solo task_tecla escribe: completa el buffer que no esta publicado y recien
+          despues incrementa seq, que lo convierte en el buffer vigente.
+
+   @param index
+ */
+static void keys_publish_times( uint32_t index )
+{
+    uint32_t seq = keys_data[index].seq + 1;
+
+    keys_data[index].times[seq & 1].time_down   = keys_data[index].time_down;
+    keys_data[index].times[seq & 1].time_up     = keys_data[index].time_up;
+    KEYS_BARRIER();
+    keys_data[index].seq = seq;
+}
+
 /*=====[Implementations of private functions]=================================*/
 void task_tecla( void* taskParmPtr )
 {
@@ -302,6 +505,90 @@ void keys_isr_rise( uint32_t index, t_key_isr_signal*evnt )
     evnt->event_type    = TEC_RISE;
 }
 
+/**
+   @brief prefiltro de flancos: encola el evento solo si cambia el sentido respecto del
+          ultimo flanco encolado y si paso el holdoff desde ese flanco. Un contacto que
+          rebota genera una rafaga de flancos; asi la rafaga se reduce a uno o dos eventos
+          y no llena isr_queue ni despierta a task_tecla en cada rebote.
+          No hay llamadas al kernel para los flancos descartados.
+
+   @param evnt
+   @param woken
+ */
+static void keys_isr_post( t_key_isr_signal* evnt, BaseType_t* woken )
+{
+    t_key_data* key = &keys_data[evnt->tecla];
+    UBaseType_t waiting;
+
+    key->isr_raw_time = evnt->event_time;      //envolvente del rebote para el antirrebote adaptivo
+
+    if( evnt->event_type == key->isr_last_type )
+    {
+        key->isr_stats.dropped_same_dir++;
+        return;
+    }
+
+    if( ( TickType_t )( evnt->event_time - key->isr_last_time ) < KEYS_ISR_HOLDOFF_MS / portTICK_RATE_MS )
+    {
+        key->isr_stats.dropped_holdoff++;
+        return;
+    }
+
+    if( xQueueSendFromISR( isr_queue, evnt, woken ) != pdPASS )
+    {
+        key->isr_stats.dropped_full++;
+#if KEYS_JOURNAL==1
+        keys_journal_record( evnt->event_time, evnt->tecla, evnt->event_type, KEYS_JRN_LOST, evnt->event_time );
+#endif
+        return;
+    }
+
+#if KEYS_JOURNAL==1
+    keys_journal_record( evnt->event_time, evnt->tecla, evnt->event_type, KEYS_JRN_QUEUED, evnt->event_time );
+#endif
+
+    key->isr_last_time = evnt->event_time;
+    key->isr_last_type = evnt->event_type;
+    key->isr_stats.accepted++;
+
+    waiting = uxQueueMessagesWaitingFromISR( isr_queue );
+    if( waiting > key->isr_stats.queue_max )
+    {
+        key->isr_stats.queue_max = waiting;
+    }
+}
+
+/**
+   @brief inyecta un flanco como si lo hubiera detectado la PININT de la tecla.
+          Lo usa keys_sim.c desde una tarea: se enmascaran las interrupciones para
+          ejecutar el mismo camino que los handlers.
+
+   @param index
+   @param event_type    TEC_FALL o TEC_RISE
+ */
+void keys_inject_edge( uint32_t index, uint32_t event_type )
+{
+    t_key_isr_signal event_data;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    UBaseType_t mask;
+
+    mask = taskENTER_CRITICAL_FROM_ISR();
+
+    if( event_type == TEC_FALL )
+    {
+        keys_isr_fall( index, &event_data );
+    }
+    else
+    {
+        keys_isr_rise( index, &event_data );
+    }
+    keys_isr_post( &event_data, &xHigherPriorityTaskWoken );
+
+    taskEXIT_CRITICAL_FROM_ISR( mask );
+
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
 void GPIO0_IRQHandler( void )   //asociado a tec1
 {
     t_key_isr_signal event_data;
@@ -313,14 +600,14 @@ void GPIO0_IRQHandler( void )   //asociado a tec1
         Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH0 ); //Borramos el flag de interrupción
 
         keys_isr_fall( TEC1_INDEX, &event_data );
-        xQueueSendFromISR(  isr_queue, &event_data, &xHigherPriorityTaskWoken );
+        keys_isr_post( &event_data, &xHigherPriorityTaskWoken );
     }
 
     if ( Chip_PININT_GetRiseStates( LPC_GPIO_PIN_INT ) & PININTCH0 )
     {
         Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH0 );
         keys_isr_rise( TEC1_INDEX, &event_data );
-        xQueueSendFromISR( isr_queue, &event_data, &xHigherPriorityTaskWoken );
+        keys_isr_post( &event_data, &xHigherPriorityTaskWoken );
     }
 
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
@@ -337,14 +624,14 @@ void GPIO1_IRQHandler( void )  //asociado a tec1
         Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH1 ); //Borramos el flag de interrupción
 
         keys_isr_fall( TEC2_INDEX, &event_data );
-        xQueueSendFromISR( isr_queue, &event_data, &xHigherPriorityTaskWoken );
+        keys_isr_post( &event_data, &xHigherPriorityTaskWoken );
     }
 
     if ( Chip_PININT_GetRiseStates( LPC_GPIO_PIN_INT ) & PININTCH1 )
     {
         Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH1 );
         keys_isr_rise( TEC2_INDEX, &event_data );
-        xQueueSendFromISR( isr_queue, &event_data, &xHigherPriorityTaskWoken );
+        keys_isr_post( &event_data, &xHigherPriorityTaskWoken );
     }
 
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
@@ -362,14 +649,14 @@ void GPIO2_IRQHandler( void )
         Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH2 ); //Borramos el flag de interrupción
 
         keys_isr_fall( TEC3_INDEX, &event_data );
-        xQueueSendFromISR( isr_queue, &event_data, &xHigherPriorityTaskWoken );
+        keys_isr_post( &event_data, &xHigherPriorityTaskWoken );
     }
 
     if ( Chip_PININT_GetRiseStates( LPC_GPIO_PIN_INT ) & PININTCH2 )
     {
         Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH2 );
         keys_isr_rise( TEC3_INDEX, &event_data );
-        xQueueSendFromISR( isr_queue, &event_data, &xHigherPriorityTaskWoken );
+        keys_isr_post( &event_data, &xHigherPriorityTaskWoken );
     }
 
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
@@ -386,14 +673,14 @@ void GPIO3_IRQHandler( void )
         Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH3 ); //Borramos el flag de interrupción
 
         keys_isr_fall( TEC4_INDEX, &event_data );
-        xQueueSendFromISR( isr_queue, &event_data, &xHigherPriorityTaskWoken );
+        keys_isr_post( &event_data, &xHigherPriorityTaskWoken );
     }
 
     if ( Chip_PININT_GetRiseStates( LPC_GPIO_PIN_INT ) & PININTCH3 )
     {
         Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH3 );
         keys_isr_rise( TEC4_INDEX, &event_data );
-        xQueueSendFromISR( isr_queue, &event_data, &xHigherPriorityTaskWoken );
+        keys_isr_post( &event_data, &xHigherPriorityTaskWoken );
     }
 
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
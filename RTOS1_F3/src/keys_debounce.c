@@ -0,0 +1,125 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[ Inclusions ]============================================*/
+#include "keys_debounce.h"
+
+/* Reglas del antirrebote adaptivo de keys.c, sin dependencias del RTOS: task_tecla decide
+   con ellas cuanto esperar y que aprender de cada rebote. test/test_debounce.c las ejercita
+   en la PC con rebotes grabados. */
+
+/*=====[Implementations of public functions]=================================*/
+void keys_debounce_reset( t_key_debounce_stats* db )
+{
+    db->debounce      = pdMS_TO_TICKS( KEYS_DEBOUNCE_MAX_MS );     //se arranca con la ventana conservadora
+    db->last_envelope = 0;
+    db->max_envelope  = 0;
+    db->extended      = 0;
+    db->skipped       = 0;
+}
+
+/**
+   @brief indica si hay que seguir esperando: la ISR vio un flanco crudo en los ultimos
+          KEYS_DEBOUNCE_MARGIN_MS y todavia no pasaron KEYS_DEBOUNCE_MAX_MS desde el flanco
+          que disparo el evento.
+
+   @param edge  timestamp del flanco del evento
+   @param raw   timestamp del ultimo flanco crudo visto por la ISR
+   @param now
+ */
+bool_t keys_debounce_settling( TickType_t edge, TickType_t raw, TickType_t now )
+{
+    return ( TickType_t )( now - raw ) < pdMS_TO_TICKS( KEYS_DEBOUNCE_MARGIN_MS ) &&
+           ( TickType_t )( now - edge ) < pdMS_TO_TICKS( KEYS_DEBOUNCE_MAX_MS );
+}
+
+/**
+   @brief ajusta la ventana de la tecla con el rebote que termina de asentarse.
+          La envolvente es el ultimo flanco crudo menos el flanco del evento, y solo cuenta
+          si el flanco crudo cae dentro de la espera [edge, end]. Si el evento estuvo demorado
+          en la cola (task_tecla lo tomo mas de KEYS_DEBOUNCE_MARGIN_MS despues del flanco),
+          el ultimo flanco crudo puede ser de una pulsacion posterior: no se aprende de el.
+          La envolvente mas el margen es la ventana segura: si es mayor que la vigente se
+          adopta de inmediato, si es menor la ventana baja de a poco, para que un rebote
+          corto aislado no deje a la tecla desprotegida.
+
+   @param db
+   @param edge  timestamp del flanco del evento
+   @param raw   timestamp del ultimo flanco crudo visto por la ISR al terminar la espera
+   @param start instante en que task_tecla empezo a esperar
+   @param end   instante en que termino la espera
+ */
+void keys_debounce_learn( t_key_debounce_stats* db, TickType_t edge, TickType_t raw, TickType_t start, TickType_t end )
+{
+    TickType_t envelope;
+    TickType_t target;
+
+    if( ( TickType_t )( start - edge ) > pdMS_TO_TICKS( KEYS_DEBOUNCE_MARGIN_MS ) )
+    {
+        db->skipped++;
+        return;
+    }
+
+    envelope = raw - edge;
+
+    if( envelope > ( TickType_t )( end - edge ) )
+    {
+        /* el ultimo flanco crudo es anterior al evento */
+        envelope = 0;
+    }
+
+    db->last_envelope = envelope;
+    if( envelope > db->max_envelope )
+    {
+        db->max_envelope = envelope;
+    }
+
+    target = envelope + pdMS_TO_TICKS( KEYS_DEBOUNCE_MARGIN_MS );
+    if( target < pdMS_TO_TICKS( KEYS_DEBOUNCE_MIN_MS ) )
+    {
+        target = pdMS_TO_TICKS( KEYS_DEBOUNCE_MIN_MS );
+    }
+    if( target > pdMS_TO_TICKS( KEYS_DEBOUNCE_MAX_MS ) )
+    {
+        target = pdMS_TO_TICKS( KEYS_DEBOUNCE_MAX_MS );
+    }
+
+    if( target >= db->debounce )
+    {
+        db->debounce = target;
+    }
+    else
+    {
+        db->debounce -= ( db->debounce - target + KEYS_DEBOUNCE_DECAY - 1 ) / KEYS_DEBOUNCE_DECAY;
+    }
+}
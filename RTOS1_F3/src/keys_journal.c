@@ -0,0 +1,127 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[ Inclusions ]============================================*/
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sapi.h"
+#include "keys_journal.h"
+
+#if KEYS_JOURNAL==1
+
+/*=====[Definition macros of private constants]==============================*/
+#define JOURNAL_MASK    ( KEYS_JOURNAL_LEN - 1 )
+
+/*=====[Definitions of private global variables]=============================*/
+static t_keys_journal_entry journal[KEYS_JOURNAL_LEN];
+static uint32_t journal_head;      //cantidad total de registros escritos
+
+/*=====[Implementations of public functions]=================================*/
+
+/**
+   @brief agrega un registro al journal. Se llama desde la ISR y desde task_tecla:
+          cada escritor reserva su lugar con un incremento atomico (LDREX/STREX en el
+          Cortex-M4), por lo que no hace falta enmascarar interrupciones ni tomar mutex.
+          Dos escritores nunca comparten lugar salvo que se escriban KEYS_JOURNAL_LEN
+          registros mientras uno de ellos esta a mitad de la escritura.
+
+   @param time      timestamp del flanco
+   @param tecla
+   @param edge      TEC_FALL / TEC_RISE
+   @param result    KEYS_JRN_xxx
+   @param now       tick actual, para la latencia
+ */
+void keys_journal_record( TickType_t time, uint32_t tecla, uint32_t edge, uint32_t result, TickType_t now )
+{
+    uint32_t slot = __atomic_fetch_add( &journal_head, 1, __ATOMIC_RELAXED ) & JOURNAL_MASK;
+    TickType_t latency = now - time;
+
+    journal[slot].time      = time;
+    journal[slot].tecla     = tecla;
+    journal[slot].edge      = edge;
+    journal[slot].result    = result;
+    journal[slot].latency   = ( latency > 255 ) ? 255 : latency;
+}
+
+/**
+   @brief envia el journal completo por KEYS_JOURNAL_UART en una sola rafaga, del
+          registro mas viejo al mas nuevo:
+
+          >J<total escrito, 8 hex><registro 1, 16 hex>...<registro n, 16 hex><\r\n
+
+          Cada registro va como time (8 hex), tecla, edge, result y latency (2 hex cada uno).
+          Los registros que se escriban durante la exportacion pueden salir mezclados con
+          los viejos; para un diagnostico post falla se exporta con las teclas quietas.
+ */
+void keys_journal_export( void )
+{
+    static const char hex[] = "0123456789ABCDEF";
+    uint8_t line[ 2 + 8 + 16 ];
+    uint32_t head = __atomic_load_n( &journal_head, __ATOMIC_RELAXED );
+    uint32_t first = ( head > KEYS_JOURNAL_LEN ) ? head - KEYS_JOURNAL_LEN : 0;
+    t_keys_journal_entry e;
+    uint32_t n;
+
+    line[0] = '>';
+    line[1] = 'J';
+    for( n = 0; n < 8; n++ )
+    {
+        line[2 + n] = hex[( head >> ( 28 - 4 * n ) ) & 0xF];
+    }
+    uartWriteByteArray( KEYS_JOURNAL_UART, line, 10 );
+
+    for( ; first < head; first++ )
+    {
+        e = journal[first & JOURNAL_MASK];
+
+        for( n = 0; n < 8; n++ )
+        {
+            line[n] = hex[( e.time >> ( 28 - 4 * n ) ) & 0xF];
+        }
+        line[8]  = hex[e.tecla >> 4];
+        line[9]  = hex[e.tecla & 0xF];
+        line[10] = hex[e.edge >> 4];
+        line[11] = hex[e.edge & 0xF];
+        line[12] = hex[e.result >> 4];
+        line[13] = hex[e.result & 0xF];
+        line[14] = hex[e.latency >> 4];
+        line[15] = hex[e.latency & 0xF];
+
+        uartWriteByteArray( KEYS_JOURNAL_UART, line, 16 );
+    }
+
+    uartWriteByteArray( KEYS_JOURNAL_UART, ( uint8_t* ) "<\r\n", 3 );
+}
+
+#endif
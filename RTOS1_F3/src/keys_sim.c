@@ -0,0 +1,208 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[ Inclusions ]============================================*/
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sapi.h"
+#include "keys.h"
+#include "keys_sim.h"
+
+#if KEYS_SIM==1
+
+/*=====[Definition macros of private constants]==============================*/
+#define KEYS_SIM_MAX_KEYS   4
+
+/*=====[Definitions of private global variables]=============================*/
+static const t_keys_sim_step* sim_script;
+static uint32_t sim_steps;
+static uint32_t sim_repeat;
+
+static volatile bool_t sim_level[KEYS_SIM_MAX_KEYS];        //nivel del pin simulado (1 = liberada)
+static bool_t sim_stable[KEYS_SIM_MAX_KEYS];                //nivel definitivo del ultimo flanco del guion
+static TickType_t sim_stable_time[KEYS_SIM_MAX_KEYS];       //instante del ultimo flanco del guion
+
+static t_keys_sim_stats sim_stats;
+
+/*=====[prototype of private functions]=================================*/
+static void task_keys_sim( void* taskParmPtr );
+static void keys_sim_transition( uint32_t index, bool_t level, const t_keys_sim_step* step, TickType_t* wake );
+
+/*=====[Implementations of public functions]=================================*/
+
+/**
+   @brief arranca la reproduccion de un guion de pulsaciones sobre el driver de teclas.
+          Los flancos se inyectan por el mismo camino que usan los handlers de PININT,
+          por lo que pasan por el prefiltro, la cola y el antirrebote reales.
+
+   @param script    pasos a reproducir en orden
+   @param steps     cantidad de pasos
+   @param repeat    veces que se repite el guion completo
+ */
+void keys_sim_Init( const t_keys_sim_step* script, uint32_t steps, uint32_t repeat )
+{
+    BaseType_t res;
+
+    sim_script  = script;
+    sim_steps   = steps;
+    sim_repeat  = repeat;
+
+    for( int i = 0; i < KEYS_SIM_MAX_KEYS ; i++ )
+    {
+        sim_level[i]    = 1;
+        sim_stable[i]   = 1;
+    }
+
+    /* prioridad mayor que task_tecla, para que los flancos salgan en el tick pedido */
+    res = xTaskCreate (
+              task_keys_sim,				// Funcion de la tarea a ejecutar
+              ( const char * )"task_keys_sim",	// Nombre de la tarea como String amigable para el usuario
+              configMINIMAL_STACK_SIZE*2,	// Cantidad de stack de la tarea
+              0,							// Parametros de tarea
+              tskIDLE_PRIORITY+2,			// Prioridad de la tarea
+              0							// Puntero a la tarea creada en el sistema
+          );
+
+    // Gestión de errores
+    configASSERT( res == pdPASS );
+}
+
+/* reemplaza a gpioRead dentro de keys.c */
+bool_t keys_sim_read( uint32_t index )
+{
+    return sim_level[index];
+}
+
+/**
+   @brief lo llama keys.c por cada evento que emite. Compara el evento con el nivel
+          estable del guion y acumula la latencia desde el ultimo flanco.
+
+   @param index
+   @param event_type    TEC_FALL (pulsado) o TEC_RISE (liberado)
+ */
+void keys_sim_report( uint32_t index, uint32_t event_type )
+{
+    TickType_t latency = xTaskGetTickCount() - sim_stable_time[index];
+
+    if( event_type == TEC_FALL )
+    {
+        sim_stats.pressed++;
+    }
+    else
+    {
+        sim_stats.released++;
+    }
+
+    if( sim_stable[index] != ( event_type == TEC_RISE ) )
+    {
+        sim_stats.spurious++;
+        return;
+    }
+
+    sim_stats.latency_sum += latency;
+    if( latency > sim_stats.latency_max )
+    {
+        sim_stats.latency_max = latency;
+    }
+}
+
+void keys_sim_get_stats( t_keys_sim_stats* stats )
+{
+    taskENTER_CRITICAL();
+    *stats = sim_stats;
+    taskEXIT_CRITICAL();
+}
+
+/*=====[Implementations of private functions]================================*/
+
+/* genera la transicion de una tecla al nivel pedido: bounces flancos espurios y el definitivo */
+static void keys_sim_transition( uint32_t index, bool_t level, const t_keys_sim_step* step, TickType_t* wake )
+{
+    TickType_t bounce = step->bounce_ms ? pdMS_TO_TICKS( step->bounce_ms ) : 1;
+
+    /* con bounces par el ultimo flanco deja el pin en el nivel pedido */
+    for( int i = 0; i <= 2 * step->bounces ; i++ )
+    {
+        if( i > 0 )
+        {
+            vTaskDelayUntil( wake, bounce );
+        }
+
+        sim_level[index] = ( i & 1 ) ? !level : level;
+        keys_inject_edge( index, sim_level[index] ? TEC_RISE : TEC_FALL );
+        sim_stats.edges++;
+    }
+
+    sim_stable[index]       = level;
+    sim_stable_time[index]  = *wake;
+}
+
+static void task_keys_sim( void* taskParmPtr )
+{
+    const t_keys_sim_step* step;
+    t_keys_sim_stats stats;
+    uint32_t valid;
+    TickType_t wake = xTaskGetTickCount();
+
+    for( uint32_t r = 0; r < sim_repeat ; r++ )
+    {
+        for( uint32_t s = 0; s < sim_steps ; s++ )
+        {
+            step = &sim_script[s];
+
+            vTaskDelayUntil( &wake, pdMS_TO_TICKS( step->gap_ms ) );
+            keys_sim_transition( step->tecla, 0, step, &wake );
+            sim_stats.presses++;
+
+            vTaskDelayUntil( &wake, pdMS_TO_TICKS( step->hold_ms ) );
+            keys_sim_transition( step->tecla, 1, step, &wake );
+        }
+    }
+
+    /* deja terminar el antirrebote de la ultima liberacion */
+    vTaskDelay( pdMS_TO_TICKS( 2 * KEYS_DEBOUNCE_MAX_MS ) );
+
+    keys_sim_get_stats( &stats );
+    valid = stats.pressed + stats.released - stats.spurious;
+
+    printf( "sim: %u pulsaciones, %u flancos\n", stats.presses, stats.edges );
+    printf( "sim: pulsados %u, liberados %u, perdidos %u, espurios %u\n",
+            stats.pressed, stats.released, 2 * stats.presses - valid, stats.spurious );
+    printf( "sim: latencia media %u ms, maxima %u ms\n",
+            valid ? stats.latency_sum / valid : 0, stats.latency_max );
+
+    vTaskDelete( NULL );
+}
+
+#endif
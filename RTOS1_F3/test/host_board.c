@@ -0,0 +1,200 @@
+/* Placa simulada para host_rtos.c: niveles de los pines GPIO, canales PININT y NVIC.
+   La prueba mueve los pines con host_board_set_pin; cada flanco que coincide con un canal
+   PININT configurado queda latcheado y, si el NVIC lo tiene habilitado, se ejecuta el
+   GPIOn_IRQHandler del driver en ese momento. Si esta deshabilitado queda pendiente y entra
+   cuando se habilite, como en el Cortex-M4. */
+
+#include "host_board.h"
+
+#define HOST_PORTS          8
+#define HOST_CHANNELS       8
+
+/* los handlers los define el driver que se esta probando; el que no tiene ninguno (un
+   driver por muestreo) linkea igual */
+void GPIO0_IRQHandler( void ) __attribute__( ( weak ) );
+void GPIO1_IRQHandler( void ) __attribute__( ( weak ) );
+void GPIO2_IRQHandler( void ) __attribute__( ( weak ) );
+void GPIO3_IRQHandler( void ) __attribute__( ( weak ) );
+void GPIO4_IRQHandler( void ) __attribute__( ( weak ) );
+void GPIO5_IRQHandler( void ) __attribute__( ( weak ) );
+void GPIO6_IRQHandler( void ) __attribute__( ( weak ) );
+void GPIO7_IRQHandler( void ) __attribute__( ( weak ) );
+
+/* mismos pines que la EDU-CIAA */
+pinInitGpioLpc4337_t gpioPinsInit[] =
+{
+    [TEC1] = { { 0, 4 } },
+    [TEC2] = { { 0, 8 } },
+    [TEC3] = { { 0, 9 } },
+    [TEC4] = { { 1, 9 } },
+    [LEDR] = { { 5, 0 } },
+    [LEDG] = { { 5, 1 } },
+    [LEDB] = { { 5, 2 } },
+    [LED1] = { { 0, 14 } },
+    [LED2] = { { 1, 11 } },
+    [LED3] = { { 1, 12 } },
+};
+
+static uint32_t levels[HOST_PORTS] = { [0 ... HOST_PORTS - 1] = 0xFFFFFFFF };    //pull-ups: teclas sueltas
+
+static struct
+{
+    uint8_t port;
+    uint8_t pin;
+    uint8_t used;
+} channels[HOST_CHANNELS];
+
+static uint32_t edge_mode;
+static uint32_t enabled_fall;
+static uint32_t enabled_rise;
+static uint32_t fall_states;
+static uint32_t rise_states;
+static uint32_t nvic_enabled;
+static uint32_t nvic_pending;
+
+static void ( *const handlers[HOST_CHANNELS] )( void ) =
+{
+    GPIO0_IRQHandler, GPIO1_IRQHandler, GPIO2_IRQHandler, GPIO3_IRQHandler,
+    GPIO4_IRQHandler, GPIO5_IRQHandler, GPIO6_IRQHandler, GPIO7_IRQHandler
+};
+
+static void host_board_irq( uint32_t ch )
+{
+    uint32_t mask = PININTCH( ch );
+
+    if( ( nvic_enabled & nvic_pending & mask ) && handlers[ch] != NULL )
+    {
+        nvic_pending &= ~mask;
+        host_rtos_isr( handlers[ch] );
+    }
+}
+
+void host_board_set_pin( gpioMap_t pin, bool_t level )
+{
+    uint8_t port = gpioPinsInit[pin].gpio.port;
+    uint8_t bit  = gpioPinsInit[pin].gpio.pin;
+    uint32_t ch;
+
+    if( ( ( levels[port] >> bit ) & 1 ) == level )
+    {
+        return;
+    }
+
+    levels[port] ^= 1UL << bit;
+
+    for( ch = 0 ; ch < HOST_CHANNELS ; ch++ )
+    {
+        uint32_t mask = PININTCH( ch );
+
+        if( !channels[ch].used || channels[ch].port != port || channels[ch].pin != bit || !( edge_mode & mask ) )
+        {
+            continue;
+        }
+
+        if( level ? ( enabled_rise & mask ) : ( enabled_fall & mask ) )
+        {
+            if( level )
+            {
+                rise_states |= mask;
+            }
+            else
+            {
+                fall_states |= mask;
+            }
+
+            nvic_pending |= mask;
+            host_board_irq( ch );
+        }
+    }
+}
+
+bool_t gpioRead( gpioMap_t pin )
+{
+    return ( levels[gpioPinsInit[pin].gpio.port] >> gpioPinsInit[pin].gpio.pin ) & 1;
+}
+
+bool_t gpioWrite( gpioMap_t pin, bool_t value )
+{
+    uint32_t mask = 1UL << gpioPinsInit[pin].gpio.pin;
+
+    if( value )
+    {
+        levels[gpioPinsInit[pin].gpio.port] |= mask;
+    }
+    else
+    {
+        levels[gpioPinsInit[pin].gpio.port] &= ~mask;
+    }
+
+    return TRUE;
+}
+
+uint32_t Chip_GPIO_GetPortValue( void* gpio, uint8_t port )
+{
+    return levels[port];
+}
+
+void Chip_SCU_GPIOIntPinSel( uint8_t channel, uint8_t port, uint8_t pin )
+{
+    channels[channel].port = port;
+    channels[channel].pin  = pin;
+    channels[channel].used = 1;
+}
+
+void Chip_PININT_Init( void* pint )
+{
+}
+
+void Chip_PININT_SetPinModeEdge( void* pint, uint32_t mask )
+{
+    edge_mode |= mask;
+}
+
+void Chip_PININT_EnableIntLow( void* pint, uint32_t mask )
+{
+    enabled_fall |= mask;
+}
+
+void Chip_PININT_EnableIntHigh( void* pint, uint32_t mask )
+{
+    enabled_rise |= mask;
+}
+
+/* en modo flanco, escribir IST borra la deteccion de subida y la de bajada del canal */
+void Chip_PININT_ClearIntStatus( void* pint, uint32_t mask )
+{
+    fall_states &= ~mask;
+    rise_states &= ~mask;
+}
+
+uint32_t Chip_PININT_GetFallStates( void* pint )
+{
+    return fall_states;
+}
+
+uint32_t Chip_PININT_GetRiseStates( void* pint )
+{
+    return rise_states;
+}
+
+void NVIC_EnableIRQ( IRQn_Type irq )
+{
+    uint32_t ch = irq - PIN_INT0_IRQn;
+
+    nvic_enabled |= PININTCH( ch );
+    host_board_irq( ch );
+}
+
+void NVIC_DisableIRQ( IRQn_Type irq )
+{
+    nvic_enabled &= ~PININTCH( irq - PIN_INT0_IRQn );
+}
+
+void NVIC_ClearPendingIRQ( IRQn_Type irq )
+{
+    nvic_pending &= ~PININTCH( irq - PIN_INT0_IRQn );
+}
+
+void NVIC_SetPriority( IRQn_Type irq, uint32_t priority )
+{
+}
@@ -0,0 +1,10 @@
+/* Placa simulada (host_board.c): la prueba cambia el nivel de los pines como lo haria un dedo */
+#ifndef HOST_BOARD_H
+#define HOST_BOARD_H
+
+#include "sapi.h"
+#include "host_rtos.h"
+
+void host_board_set_pin( gpioMap_t pin, bool_t level );
+
+#endif
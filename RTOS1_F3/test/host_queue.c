@@ -0,0 +1,162 @@
+/* Colas de FreeRTOS para las pruebas en la PC: lo justo para event_bus.c y los drivers.
+   Un mutex y una variable de condicion por cola; las versiones FromISR no bloquean nunca. */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "queue.h"
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t  changed;    //se avisa con cada envio o recepcion
+    UBaseType_t     length;
+    UBaseType_t     item_size;
+    UBaseType_t     head;
+    UBaseType_t     count;
+    uint8_t         storage[];
+} t_host_queue;
+
+void ( *host_queue_on_full )( QueueHandle_t queue );
+
+static int host_queue_wait( t_host_queue* q, TickType_t wait, const struct timespec* deadline )
+{
+    if( wait == portMAX_DELAY )
+    {
+        return pthread_cond_wait( &q->changed, &q->mutex );
+    }
+
+    return pthread_cond_timedwait( &q->changed, &q->mutex, deadline );
+}
+
+static void host_queue_deadline( TickType_t wait, struct timespec* deadline )
+{
+    clock_gettime( CLOCK_REALTIME, deadline );
+    deadline->tv_sec  += wait / 1000;
+    deadline->tv_nsec += ( long )( wait % 1000 ) * 1000000L;
+
+    if( deadline->tv_nsec >= 1000000000L )
+    {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+QueueHandle_t xQueueCreate( UBaseType_t length, UBaseType_t item_size )
+{
+    t_host_queue* q = calloc( 1, sizeof( t_host_queue ) + length * item_size );
+
+    if( q == NULL )
+    {
+        return NULL;
+    }
+
+    pthread_mutex_init( &q->mutex, NULL );
+    pthread_cond_init( &q->changed, NULL );
+    q->length    = length;
+    q->item_size = item_size;
+
+    return q;
+}
+
+BaseType_t xQueueSend( QueueHandle_t queue, const void* item, TickType_t wait )
+{
+    t_host_queue* q = queue;
+    struct timespec deadline;
+    int err = 0;
+
+    host_queue_deadline( wait, &deadline );
+    pthread_mutex_lock( &q->mutex );
+
+    while( q->count == q->length && wait != 0 && err != ETIMEDOUT )
+    {
+        err = host_queue_wait( q, wait, &deadline );
+    }
+
+    if( q->count == q->length )
+    {
+        pthread_mutex_unlock( &q->mutex );
+
+        if( host_queue_on_full != NULL )
+        {
+            host_queue_on_full( queue );
+        }
+
+        return pdFAIL;
+    }
+
+    memcpy( &q->storage[( ( q->head + q->count ) % q->length ) * q->item_size], item, q->item_size );
+    q->count++;
+
+    pthread_cond_broadcast( &q->changed );
+    pthread_mutex_unlock( &q->mutex );
+
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive( QueueHandle_t queue, void* item, TickType_t wait )
+{
+    t_host_queue* q = queue;
+    struct timespec deadline;
+    int err = 0;
+
+    host_queue_deadline( wait, &deadline );
+    pthread_mutex_lock( &q->mutex );
+
+    while( q->count == 0 && wait != 0 && err != ETIMEDOUT )
+    {
+        err = host_queue_wait( q, wait, &deadline );
+    }
+
+    if( q->count == 0 )
+    {
+        pthread_mutex_unlock( &q->mutex );
+        return pdFAIL;
+    }
+
+    memcpy( item, &q->storage[q->head * q->item_size], q->item_size );
+    q->head = ( q->head + 1 ) % q->length;
+    q->count--;
+
+    pthread_cond_broadcast( &q->changed );
+    pthread_mutex_unlock( &q->mutex );
+
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR( QueueHandle_t queue, const void* item, BaseType_t* woken )
+{
+    return xQueueSend( queue, item, 0 );
+}
+
+BaseType_t xQueueReceiveFromISR( QueueHandle_t queue, void* item, BaseType_t* woken )
+{
+    return xQueueReceive( queue, item, 0 );
+}
+
+BaseType_t xQueueIsQueueFullFromISR( QueueHandle_t queue )
+{
+    t_host_queue* q = queue;
+    BaseType_t full;
+
+    pthread_mutex_lock( &q->mutex );
+    full = ( q->count == q->length );
+    pthread_mutex_unlock( &q->mutex );
+
+    return full;
+}
+
+UBaseType_t uxQueueMessagesWaiting( QueueHandle_t queue )
+{
+    t_host_queue* q = queue;
+    UBaseType_t count;
+
+    pthread_mutex_lock( &q->mutex );
+    count = q->count;
+    pthread_mutex_unlock( &q->mutex );
+
+    return count;
+}
@@ -0,0 +1,596 @@
+/* Kernel de tiempo virtual para las pruebas en la PC: no hay un port POSIX de FreeRTOS en el
+   arbol, asi que se implementa lo que usan los drivers sobre ucontext.
+
+   Todo corre en un solo hilo. El tiempo avanza solo cuando todas las tareas estan bloqueadas,
+   y salta directo al proximo instante en que algo cambia (un timeout o un flanco de la prueba),
+   por lo que el codigo de las tareas tarda 0 ticks y miles de pulsaciones se simulan en
+   milisegundos. En cada instante primero entran las interrupciones y despues corren las tareas
+   listas, de mayor prioridad primero; una tarea que despierta a otra de mayor prioridad le cede
+   la CPU en el momento, como en el kernel real. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "host_rtos.h"
+
+#define HOST_MAX_TASKS      16
+#define HOST_STACK_SIZE     ( 64 * 1024 )
+
+typedef enum
+{
+    HOST_READY,
+    HOST_BLOCKED,
+    HOST_DELETED
+} t_host_state;
+
+typedef struct
+{
+    ucontext_t      ctx;
+    uint8_t*        stack;
+    TaskFunction_t  code;
+    void*           param;
+    UBaseType_t     priority;
+    t_host_state    state;
+    uint32_t        order;          //entre tareas de igual prioridad corre la que llego antes
+    void*           wait_on;        //cola o event group que espera; NULL en vTaskDelay
+    int             timed;
+    TickType_t      wake;
+
+    EventBits_t     group_bits;     //espera de xEventGroupWaitBits
+    BaseType_t      group_all;
+    BaseType_t      group_clear;
+    int             group_done;
+    EventBits_t     group_value;
+} t_host_task;
+
+typedef struct
+{
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t     storage[];
+} t_host_queue;
+
+typedef struct
+{
+    EventBits_t bits;
+} t_host_group;
+
+static t_host_task  tasks[HOST_MAX_TASKS];
+static uint32_t     n_tasks;
+static t_host_task* current;        //NULL fuera de las tareas: planificador, prueba o interrupcion
+static ucontext_t   scheduler;
+static TickType_t   now;
+static uint32_t     order;
+static int          preempt;
+static t_host_rtos_stats stats;
+
+static uint64_t host_ns( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return ( uint64_t ) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int host_due( TickType_t t )
+{
+    return ( int32_t )( t - now ) <= 0;
+}
+
+static void host_ready( t_host_task* t )
+{
+    t->state   = HOST_READY;
+    t->wait_on = NULL;
+    t->order   = order++;
+
+    if( current != NULL && t != current && t->priority > current->priority )
+    {
+        preempt = 1;
+    }
+}
+
+/* la tarea actual deja la CPU; vuelve cuando el planificador la elija de nuevo */
+static void host_switch( void )
+{
+    swapcontext( &current->ctx, &scheduler );
+}
+
+static void host_block( void* obj, int timed, TickType_t wake )
+{
+    current->state   = HOST_BLOCKED;
+    current->wait_on = obj;
+    current->timed   = timed;
+    current->wake    = wake;
+    host_switch();
+}
+
+/* cede la CPU si se desperto una tarea de mayor prioridad */
+static void host_preempt( void )
+{
+    if( preempt && current != NULL )
+    {
+        preempt = 0;
+        host_ready( current );
+        host_switch();
+    }
+    preempt = 0;
+}
+
+/* bloquea hasta que cambie obj o venza deadline. Devuelve 0 si no hay que esperar mas */
+static int host_wait( void* obj, TickType_t wait, TickType_t deadline )
+{
+    if( wait == 0 || current == NULL )
+    {
+        return 0;
+    }
+
+    if( wait != portMAX_DELAY && host_due( deadline ) )
+    {
+        return 0;
+    }
+
+    host_block( obj, wait != portMAX_DELAY, deadline );
+    return 1;
+}
+
+static BaseType_t host_wake( void* obj )
+{
+    BaseType_t woken = pdFALSE;
+    uint32_t i;
+
+    for( i = 0 ; i < n_tasks ; i++ )
+    {
+        if( tasks[i].state == HOST_BLOCKED && tasks[i].wait_on == obj )
+        {
+            host_ready( &tasks[i] );
+            woken = pdTRUE;
+        }
+    }
+
+    return woken;
+}
+
+static t_host_task* host_pick( void )
+{
+    t_host_task* best = NULL;
+    uint32_t i;
+
+    for( i = 0 ; i < n_tasks ; i++ )
+    {
+        t_host_task* t = &tasks[i];
+
+        if( t->state != HOST_READY )
+        {
+            continue;
+        }
+
+        if( best == NULL || t->priority > best->priority ||
+            ( t->priority == best->priority && ( int32_t )( t->order - best->order ) < 0 ) )
+        {
+            best = t;
+        }
+    }
+
+    return best;
+}
+
+static void host_task_entry( int index )
+{
+    tasks[index].code( tasks[index].param );
+    vTaskDelete( NULL );
+}
+
+/*=====[tiempo y planificador]===============================================*/
+
+void host_rtos_run( TickType_t duration, const t_host_hooks* hooks )
+{
+    TickType_t end = now + duration;
+    TickType_t next;
+    TickType_t when;
+    t_host_task* t;
+    uint64_t start;
+    uint32_t i;
+
+    while( 1 )
+    {
+        if( hooks->at != NULL )
+        {
+            hooks->at( now );
+        }
+
+        for( i = 0 ; i < n_tasks ; i++ )
+        {
+            if( tasks[i].state == HOST_BLOCKED && tasks[i].timed && host_due( tasks[i].wake ) )
+            {
+                host_ready( &tasks[i] );
+            }
+        }
+
+        while( ( t = host_pick() ) != NULL )
+        {
+            current = t;
+            stats.switches++;
+            start = host_ns();
+            swapcontext( &scheduler, &t->ctx );
+            stats.task_ns += host_ns() - start;
+            current = NULL;
+        }
+
+        if( hooks->idle != NULL )
+        {
+            hooks->idle( now );
+        }
+
+        if( now == end )
+        {
+            break;
+        }
+
+        next = end;
+
+        for( i = 0 ; i < n_tasks ; i++ )
+        {
+            if( tasks[i].state == HOST_BLOCKED && tasks[i].timed && ( int32_t )( tasks[i].wake - next ) < 0 )
+            {
+                next = tasks[i].wake;
+            }
+        }
+
+        if( hooks->next != NULL && hooks->next( now, &when ) && ( int32_t )( when - next ) < 0 )
+        {
+            next = when;
+        }
+
+        now = next;
+    }
+}
+
+void host_rtos_isr( void ( *handler )( void ) )
+{
+    uint64_t start = host_ns();
+
+    handler();
+
+    stats.isrs++;
+    if( current == NULL )
+    {
+        stats.isr_ns += host_ns() - start;      //dentro de una tarea ya lo cuenta task_ns
+    }
+}
+
+void host_rtos_get_stats( t_host_rtos_stats* s )
+{
+    *s = stats;
+}
+
+/*=====[tareas]==============================================================*/
+
+BaseType_t xTaskCreate( TaskFunction_t code, const char* name, uint32_t stack_depth, void* param, UBaseType_t priority, TaskHandle_t* handle )
+{
+    t_host_task* t;
+
+    if( n_tasks == HOST_MAX_TASKS )
+    {
+        return pdFAIL;
+    }
+
+    t = &tasks[n_tasks];
+    t->stack    = malloc( HOST_STACK_SIZE );
+    t->code     = code;
+    t->param    = param;
+    t->priority = priority;
+
+    if( t->stack == NULL )
+    {
+        return pdFAIL;
+    }
+
+    getcontext( &t->ctx );
+    t->ctx.uc_stack.ss_sp   = t->stack;
+    t->ctx.uc_stack.ss_size = HOST_STACK_SIZE;
+    t->ctx.uc_link          = &scheduler;
+    makecontext( &t->ctx, ( void ( * )( void ) ) host_task_entry, 1, ( int ) n_tasks );
+
+    n_tasks++;
+    host_ready( t );
+
+    if( handle != NULL )
+    {
+        *handle = t;
+    }
+
+    host_preempt();
+    return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStatic( TaskFunction_t code, const char* name, uint32_t stack_depth, void* param, UBaseType_t priority, StackType_t* stack, StaticTask_t* tcb )
+{
+    TaskHandle_t handle = NULL;
+
+    xTaskCreate( code, name, stack_depth, param, priority, &handle );
+    return handle;
+}
+
+void vTaskDelete( TaskHandle_t task )
+{
+    t_host_task* t = ( task == NULL ) ? current : task;
+
+    t->state = HOST_DELETED;
+
+    if( t == current )
+    {
+        host_switch();
+    }
+}
+
+void vTaskDelay( TickType_t ticks )
+{
+    if( ticks == 0 )
+    {
+        host_ready( current );
+        host_switch();
+        return;
+    }
+
+    host_block( NULL, 1, now + ticks );
+}
+
+void vTaskDelayUntil( TickType_t* previous_wake, TickType_t increment )
+{
+    *previous_wake += increment;
+
+    if( !host_due( *previous_wake ) )
+    {
+        host_block( NULL, 1, *previous_wake );
+    }
+}
+
+TickType_t xTaskGetTickCount( void )
+{
+    return now;
+}
+
+TickType_t xTaskGetTickCountFromISR( void )
+{
+    return now;
+}
+
+/*=====[colas y semaforos]===================================================*/
+
+static BaseType_t host_queue_put( t_host_queue* q, const void* item )
+{
+    if( q->count == q->length )
+    {
+        return pdFAIL;
+    }
+
+    if( q->item_size != 0 )
+    {
+        memcpy( &q->storage[( ( q->head + q->count ) % q->length ) * q->item_size], item, q->item_size );
+    }
+    q->count++;
+    return pdPASS;
+}
+
+static BaseType_t host_queue_get( t_host_queue* q, void* item )
+{
+    if( q->count == 0 )
+    {
+        return pdFAIL;
+    }
+
+    if( q->item_size != 0 )
+    {
+        memcpy( item, &q->storage[q->head * q->item_size], q->item_size );
+    }
+    q->head = ( q->head + 1 ) % q->length;
+    q->count--;
+    return pdPASS;
+}
+
+QueueHandle_t xQueueCreate( UBaseType_t length, UBaseType_t item_size )
+{
+    t_host_queue* q = calloc( 1, sizeof( t_host_queue ) + length * item_size );
+
+    if( q != NULL )
+    {
+        q->length    = length;
+        q->item_size = item_size;
+    }
+
+    return q;
+}
+
+QueueHandle_t xQueueCreateStatic( UBaseType_t length, UBaseType_t item_size, uint8_t* storage, StaticQueue_t* queue_buffer )
+{
+    return xQueueCreate( length, item_size );
+}
+
+QueueHandle_t xQueueCreateMutex( uint8_t type )
+{
+    t_host_queue* q = xQueueCreate( 1, 0 );
+
+    if( q != NULL )
+    {
+        q->count = 1;       //un mutex se crea disponible
+    }
+
+    return q;
+}
+
+BaseType_t xQueueSend( QueueHandle_t queue, const void* item, TickType_t wait )
+{
+    TickType_t deadline = now + wait;
+
+    while( host_queue_put( queue, item ) != pdPASS )
+    {
+        if( !host_wait( queue, wait, deadline ) )
+        {
+            return pdFAIL;
+        }
+    }
+
+    host_wake( queue );
+    host_preempt();
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive( QueueHandle_t queue, void* item, TickType_t wait )
+{
+    TickType_t deadline = now + wait;
+
+    while( host_queue_get( queue, item ) != pdPASS )
+    {
+        if( !host_wait( queue, wait, deadline ) )
+        {
+            return pdFAIL;
+        }
+    }
+
+    host_wake( queue );
+    host_preempt();
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR( QueueHandle_t queue, const void* item, BaseType_t* woken )
+{
+    if( host_queue_put( queue, item ) != pdPASS )
+    {
+        return pdFAIL;
+    }
+
+    if( host_wake( queue ) && woken != NULL )
+    {
+        *woken = pdTRUE;
+    }
+    return pdPASS;
+}
+
+BaseType_t xQueueReceiveFromISR( QueueHandle_t queue, void* item, BaseType_t* woken )
+{
+    if( host_queue_get( queue, item ) != pdPASS )
+    {
+        return pdFAIL;
+    }
+
+    if( host_wake( queue ) && woken != NULL )
+    {
+        *woken = pdTRUE;
+    }
+    return pdPASS;
+}
+
+BaseType_t xQueueIsQueueFullFromISR( QueueHandle_t queue )
+{
+    t_host_queue* q = queue;
+
+    return q->count == q->length;
+}
+
+UBaseType_t uxQueueMessagesWaiting( QueueHandle_t queue )
+{
+    return ( ( t_host_queue* ) queue )->count;
+}
+
+UBaseType_t uxQueueMessagesWaitingFromISR( QueueHandle_t queue )
+{
+    return ( ( t_host_queue* ) queue )->count;
+}
+
+/*=====[event groups]========================================================*/
+
+static int host_group_match( EventBits_t value, EventBits_t bits, BaseType_t all )
+{
+    return all ? ( value & bits ) == bits : ( value & bits ) != 0;
+}
+
+EventGroupHandle_t xEventGroupCreate( void )
+{
+    return calloc( 1, sizeof( t_host_group ) );
+}
+
+EventGroupHandle_t xEventGroupCreateStatic( StaticEventGroup_t* group_buffer )
+{
+    return xEventGroupCreate();
+}
+
+/* como en el kernel: se despierta a todas las tareas cuya condicion se cumple con el valor
+   nuevo y recien despues se borran los bits que pidieron borrar al salir */
+EventBits_t xEventGroupSetBits( EventGroupHandle_t group, EventBits_t bits )
+{
+    t_host_group* g = group;
+    EventBits_t clear = 0;
+    uint32_t i;
+
+    g->bits |= bits;
+
+    for( i = 0 ; i < n_tasks ; i++ )
+    {
+        t_host_task* t = &tasks[i];
+
+        if( t->state == HOST_BLOCKED && t->wait_on == group && host_group_match( g->bits, t->group_bits, t->group_all ) )
+        {
+            t->group_value = g->bits;
+            t->group_done  = 1;
+            if( t->group_clear )
+            {
+                clear |= t->group_bits;
+            }
+            host_ready( t );
+        }
+    }
+
+    g->bits &= ~clear;
+
+    host_preempt();
+    return g->bits;
+}
+
+EventBits_t xEventGroupClearBits( EventGroupHandle_t group, EventBits_t bits )
+{
+    t_host_group* g = group;
+    EventBits_t value = g->bits;
+
+    g->bits &= ~bits;
+    return value;
+}
+
+EventBits_t xEventGroupWaitBits( EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit, BaseType_t wait_all, TickType_t wait )
+{
+    t_host_group* g = group;
+    TickType_t deadline = now + wait;
+    EventBits_t value = g->bits;
+
+    if( host_group_match( value, bits, wait_all ) )
+    {
+        if( clear_on_exit )
+        {
+            g->bits &= ~bits;
+        }
+        return value;
+    }
+
+    if( current == NULL )
+    {
+        return value;
+    }
+
+    current->group_bits  = bits;
+    current->group_all   = wait_all;
+    current->group_clear = clear_on_exit;
+    current->group_done  = 0;
+
+    while( !current->group_done )
+    {
+        if( !host_wait( group, wait, deadline ) )
+        {
+            return g->bits;
+        }
+    }
+
+    return current->group_value;
+}
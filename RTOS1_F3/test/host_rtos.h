@@ -0,0 +1,32 @@
+/* Kernel de tiempo virtual para correr en la PC los drivers completos, con sus tareas,
+   colas, semaforos, event groups e interrupciones (ver host_rtos.c y host_board.c) */
+#ifndef HOST_RTOS_H
+#define HOST_RTOS_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "event_groups.h"
+
+/* lo que pasa fuera del microcontrolador: la prueba mueve los pines y mira los resultados */
+typedef struct
+{
+    int  ( *next )( TickType_t now, TickType_t* when );    //proximo instante con algo que hacer; 0 si no hay
+    void ( *at )( TickType_t now );                        //al empezar cada instante, antes que las tareas
+    void ( *idle )( TickType_t now );                      //con todas las tareas bloqueadas
+} t_host_hooks;
+
+typedef struct
+{
+    uint32_t switches;      //veces que una tarea recibio la CPU
+    uint32_t isrs;          //interrupciones atendidas
+    uint64_t task_ns;       //tiempo de PC dentro de las tareas, con el cambio de contexto simulado
+    uint64_t isr_ns;        //tiempo de PC dentro de las interrupciones
+} t_host_rtos_stats;
+
+void host_rtos_run( TickType_t duration, const t_host_hooks* hooks );
+void host_rtos_isr( void ( *handler )( void ) );
+void host_rtos_get_stats( t_host_rtos_stats* stats );
+
+#endif
@@ -0,0 +1,225 @@
+/* Guion de pulsaciones y medicion para los drivers de teclas sobre host_rtos.c (ver sim_keys.h) */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "sim_keys.h"
+
+#define SIM_MAX_TECLAS  4
+
+const t_sim_perfil sim_perfiles[] =
+{
+    { "tecla nueva",        {0, 1, 2}, 3,                           {0}, 1 },
+    { "tecla tipica",       {0, 1, 2, 4, 5}, 5,                     {0, 2, 3}, 3 },
+    { "tecla gastada",      {0, 2, 3, 5, 8, 10, 12}, 7,             {0, 1, 4, 6, 9}, 5 },
+    { "tecla muy gastada",  {0, 3, 5, 9, 14, 18, 21, 24, 26}, 9,    {0, 4, 8, 13, 17}, 5 },
+    /* dos flancos por ms durante 15 ms al pulsar y 10 ms al soltar */
+    { "tormenta de rebotes",
+      {0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15}, 31,
+      {0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10}, 21 },
+};
+
+const uint32_t sim_n_perfiles = sizeof( sim_perfiles ) / sizeof( sim_perfiles[0] );
+
+/* estado del guion en el proceso hijo */
+static const t_sim_driver*  driver;
+static const t_sim_perfil*  perfil;
+static uint32_t             flanco;             // proximo flanco a aplicar
+static uint32_t             n_flancos;
+static t_sim_resultado      resultado;
+
+static struct
+{
+    int         activa;         // ya empezo al menos una transicion
+    int         pulsada;        // sentido de la ultima transicion
+    TickType_t  desde;          // su primer flanco
+    int         informada;
+} teclas[SIM_MAX_TECLAS];
+
+typedef struct
+{
+    TickType_t  t;
+    uint32_t    index;
+    bool_t      nivel;
+    int         primero;        // primer flanco de una transicion
+} t_sim_flanco;
+
+static void sim_flanco( uint32_t k, t_sim_flanco* f )
+{
+    uint32_t por_pulsacion = perfil->n_pulsa + perfil->n_suelta;
+    uint32_t i = k / por_pulsacion;
+    uint32_t j = k % por_pulsacion;
+    TickType_t t0 = SIM_PAUSA_MS + i * ( SIM_SOSTENIDA_MS + SIM_PAUSA_MS );
+
+    f->index = i % driver->n_teclas;
+
+    if( j < perfil->n_pulsa )
+    {
+        f->t       = t0 + perfil->pulsa[j];
+        f->nivel   = j & 1;                 // activa en bajo: el primero de la pulsacion baja
+        f->primero = ( j == 0 );
+    }
+    else
+    {
+        j -= perfil->n_pulsa;
+        f->t       = t0 + SIM_SOSTENIDA_MS + perfil->suelta[j];
+        f->nivel   = !( j & 1 );
+        f->primero = ( j == 0 );
+    }
+}
+
+static int sim_next( TickType_t now, TickType_t* when )
+{
+    t_sim_flanco f;
+
+    if( flanco == n_flancos )
+    {
+        return 0;
+    }
+
+    sim_flanco( flanco, &f );
+    *when = f.t;
+    return 1;
+}
+
+static void sim_at( TickType_t now )
+{
+    t_sim_flanco f;
+
+    while( flanco < n_flancos )
+    {
+        sim_flanco( flanco, &f );
+        if( ( int32_t )( f.t - now ) > 0 )
+        {
+            break;
+        }
+
+        if( f.primero )
+        {
+            teclas[f.index].activa    = 1;
+            teclas[f.index].pulsada   = !f.nivel;
+            teclas[f.index].desde     = now;
+            teclas[f.index].informada = 0;
+            resultado.transiciones++;
+        }
+
+        host_board_set_pin( driver->teclas[f.index], f.nivel );
+        flanco++;
+    }
+}
+
+static void sim_idle( TickType_t now )
+{
+    if( driver->observar != NULL )
+    {
+        driver->observar( now );
+    }
+}
+
+void sim_evento( uint32_t index, int pulsada )
+{
+    TickType_t latencia;
+
+    if( index >= driver->n_teclas || !teclas[index].activa || teclas[index].informada || teclas[index].pulsada != pulsada )
+    {
+        resultado.espurios++;
+        return;
+    }
+
+    latencia = xTaskGetTickCount() - teclas[index].desde;
+
+    teclas[index].informada = 1;
+    resultado.eventos++;
+    resultado.latencia_total += latencia;
+    if( latencia > resultado.latencia_max )
+    {
+        resultado.latencia_max = latencia;
+    }
+}
+
+static void sim_hijo( int fd )
+{
+    const t_host_hooks hooks = { sim_next, sim_at, sim_idle };
+
+    flanco    = 0;
+    n_flancos = SIM_PULSACIONES * ( perfil->n_pulsa + perfil->n_suelta );
+
+    driver->iniciar();
+    host_rtos_run( SIM_PAUSA_MS + SIM_PULSACIONES * ( SIM_SOSTENIDA_MS + SIM_PAUSA_MS ) + SIM_FIN_MS, &hooks );
+
+    resultado.perdidos = resultado.transiciones - ( resultado.eventos < resultado.transiciones ? resultado.eventos : resultado.transiciones );
+    host_rtos_get_stats( &resultado.rtos );
+
+    if( write( fd, &resultado, sizeof( resultado ) ) != sizeof( resultado ) )
+    {
+        _exit( 1 );
+    }
+    _exit( 0 );
+}
+
+int sim_correr( const t_sim_driver* d, const t_sim_perfil* p, t_sim_resultado* res )
+{
+    int fds[2];
+    int status;
+    pid_t pid;
+    ssize_t n;
+
+    if( d->n_teclas > SIM_MAX_TECLAS || pipe( fds ) != 0 )
+    {
+        return -1;
+    }
+
+    fflush( stdout );
+    pid = fork();
+    if( pid < 0 )
+    {
+        return -1;
+    }
+
+    if( pid == 0 )
+    {
+        close( fds[0] );
+        driver = d;
+        perfil = p;
+        sim_hijo( fds[1] );
+    }
+
+    close( fds[1] );
+    n = read( fds[0], res, sizeof( *res ) );
+    close( fds[0] );
+    waitpid( pid, &status, 0 );
+
+    return ( n == sizeof( *res ) && WIFEXITED( status ) && WEXITSTATUS( status ) == 0 ) ? 0 : -1;
+}
+
+/* corre todos los perfiles: cada transicion tiene que dar exactamente un evento */
+uint32_t sim_probar( const t_sim_driver* d )
+{
+    uint32_t fallas = 0;
+    uint32_t i;
+
+    printf( "\n%s\n", d->nombre );
+    printf( "%-20s %6s %5s %5s %7s %7s %8s %7s %9s\n",
+            "perfil", "event", "perd", "esp", "lat ms", "max ms", "desp/p", "isr/p", "ns CPU/p" );
+
+    for( i = 0 ; i < sim_n_perfiles ; i++ )
+    {
+        const t_sim_perfil* p = &sim_perfiles[i];
+        t_sim_resultado r = { 0 };
+        int ok = sim_correr( d, p, &r ) == 0 && r.perdidos == 0 && r.espurios == 0 &&
+                 r.eventos == 2 * SIM_PULSACIONES;
+
+        printf( "%-20s %6u %5u %5u %7.1f %7u %8.1f %7.1f %9.0f  %s\n",
+                p->nombre, r.eventos, r.perdidos, r.espurios,
+                r.eventos ? ( double ) r.latencia_total / r.eventos : 0.0, r.latencia_max,
+                ( double ) r.rtos.switches / SIM_PULSACIONES,
+                ( double ) r.rtos.isrs / SIM_PULSACIONES,
+                ( double )( r.rtos.task_ns + r.rtos.isr_ns ) / SIM_PULSACIONES, ok ? "OK" : "FALLA" );
+
+        fallas += !ok;
+    }
+
+    return fallas;
+}
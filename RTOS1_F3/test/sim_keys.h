@@ -0,0 +1,59 @@
+/* Guion de pulsaciones con rebote para los drivers de teclas corriendo sobre host_rtos.c.
+   Cada prueba (test_sim_d1, test_sim_e4, test_sim_f3) describe como arrancar su driver y
+   como enterarse de sus eventos; sim_keys.c mueve los pines, mide y arma la tabla. */
+#ifndef SIM_KEYS_H
+#define SIM_KEYS_H
+
+#include "host_board.h"
+
+#define SIM_PULSACIONES     1000        // pulsaciones por perfil
+#define SIM_SOSTENIDA_MS    150         // desde el primer flanco de bajada al primero de subida
+#define SIM_PAUSA_MS        150         // desde el primer flanco de subida a la proxima pulsacion
+#define SIM_FIN_MS          500         // se sigue simulando luego de la ultima pulsacion
+
+/* rebote grabado: instantes de cada flanco desde el primero, en ms. La cantidad es impar:
+   el primero y el ultimo van en el sentido de la pulsacion o la liberacion */
+typedef struct
+{
+    const char* nombre;
+    uint32_t    pulsa[32];
+    uint32_t    n_pulsa;
+    uint32_t    suelta[32];
+    uint32_t    n_suelta;
+} t_sim_perfil;
+
+extern const t_sim_perfil sim_perfiles[];
+extern const uint32_t sim_n_perfiles;
+
+typedef struct
+{
+    const char*         nombre;
+    const gpioMap_t*    teclas;         // las pulsaciones se reparten entre estas teclas
+    uint32_t            n_teclas;
+    void ( *iniciar )( void );          // crea las tareas del driver, antes del primer tick
+    void ( *observar )( TickType_t now );   // opcional: con todas las tareas bloqueadas
+} t_sim_driver;
+
+typedef struct
+{
+    uint32_t    transiciones;       // pulsar y soltar: 2 por pulsacion
+    uint32_t    eventos;            // eventos del driver que corresponden a una transicion
+    uint32_t    perdidos;           // transiciones sin evento
+    uint32_t    espurios;           // eventos repetidos o en el sentido equivocado
+    uint64_t    latencia_total;     // desde el primer flanco de la transicion, en ticks
+    TickType_t  latencia_max;
+    t_host_rtos_stats rtos;
+} t_sim_resultado;
+
+/* el driver informa un evento de la tecla teclas[index] */
+void sim_evento( uint32_t index, int pulsada );
+
+/* corre el guion completo de un perfil en un proceso aparte: el driver y el kernel
+   arrancan de cero. Devuelve 0 si el proceso termino bien */
+int sim_correr( const t_sim_driver* driver, const t_sim_perfil* perfil, t_sim_resultado* res );
+
+/* corre todos los perfiles e imprime la tabla. Devuelve la cantidad de perfiles en los que
+   alguna transicion no dio exactamente un evento */
+uint32_t sim_probar( const t_sim_driver* driver );
+
+#endif
@@ -0,0 +1,42 @@
+/* Lo minimo de FreeRTOS para compilar en la PC los nucleos que no usan el RTOS.
+   Con host_rtos.c ademas corren los drivers completos en tiempo virtual */
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "FreeRTOSConfig.h"
+
+typedef uint32_t TickType_t;
+typedef long     BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t StackType_t;
+typedef void*    TaskHandle_t;
+typedef void*    SemaphoreHandle_t;
+typedef void*    QueueHandle_t;
+typedef void*    xQueueHandle;
+typedef void*    EventGroupHandle_t;
+typedef TickType_t EventBits_t;
+typedef void ( *TaskFunction_t )( void* );
+
+/* host_rtos.c no usa la memoria que se le pasa a las versiones Static */
+typedef struct { void* dummy; } StaticTask_t;
+typedef struct { void* dummy; } StaticQueue_t;
+typedef struct { void* dummy; } StaticEventGroup_t;
+
+#define portMAX_DELAY           ( ( TickType_t ) 0xFFFFFFFFUL )
+#define portTICK_RATE_MS        ( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portTICK_PERIOD_MS      portTICK_RATE_MS
+#define pdMS_TO_TICKS( ms )     ( ( TickType_t )( ( ( TickType_t )( ms ) * configTICK_RATE_HZ ) / 1000 ) )
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  1
+#define pdFAIL                  0
+#define tskIDLE_PRIORITY        0
+
+/* las interrupciones simuladas corren entre ticks, con todas las tareas bloqueadas:
+   el planificador elige despues a la tarea de mayor prioridad */
+#define portYIELD_FROM_ISR( x ) ( void )( x )
+
+#endif
@@ -0,0 +1,15 @@
+/* Configuracion de FreeRTOS en la PC. -Istubs va antes que el inc/ de cada proyecto,
+   asi que reemplaza a la FreeRTOSConfig.h de la placa */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <assert.h>
+
+#define configTICK_RATE_HZ                              1000
+#define configMINIMAL_STACK_SIZE                        256
+#define configSUPPORT_STATIC_ALLOCATION                 1
+#define configSUPPORT_DYNAMIC_ALLOCATION                1
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY    5
+#define configASSERT( x )                               assert( x )
+
+#endif
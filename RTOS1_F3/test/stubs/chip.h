@@ -0,0 +1,48 @@
+/* Lo minimo de LPCOpen para la PC: el GPIO, las PININT y el NVIC los simula host_board.c */
+#ifndef CHIP_H
+#define CHIP_H
+
+#include <stdint.h>
+
+#define LPC_GPIO_PORT       ( ( void* ) 0 )
+#define LPC_GPIO_PIN_INT    ( ( void* ) 0 )
+
+#define PININTCH( ch )      ( 1UL << ( ch ) )
+#define PININTCH0           PININTCH( 0 )
+#define PININTCH1           PININTCH( 1 )
+#define PININTCH2           PININTCH( 2 )
+#define PININTCH3           PININTCH( 3 )
+#define PININTCH4           PININTCH( 4 )
+#define PININTCH5           PININTCH( 5 )
+#define PININTCH6           PININTCH( 6 )
+#define PININTCH7           PININTCH( 7 )
+
+typedef enum
+{
+    PIN_INT0_IRQn = 32,
+    PIN_INT1_IRQn,
+    PIN_INT2_IRQn,
+    PIN_INT3_IRQn,
+    PIN_INT4_IRQn,
+    PIN_INT5_IRQn,
+    PIN_INT6_IRQn,
+    PIN_INT7_IRQn
+} IRQn_Type;
+
+uint32_t Chip_GPIO_GetPortValue( void* gpio, uint8_t port );
+
+void Chip_SCU_GPIOIntPinSel( uint8_t channel, uint8_t port, uint8_t pin );
+void Chip_PININT_Init( void* pint );
+void Chip_PININT_SetPinModeEdge( void* pint, uint32_t mask );
+void Chip_PININT_EnableIntLow( void* pint, uint32_t mask );
+void Chip_PININT_EnableIntHigh( void* pint, uint32_t mask );
+void Chip_PININT_ClearIntStatus( void* pint, uint32_t mask );
+uint32_t Chip_PININT_GetFallStates( void* pint );
+uint32_t Chip_PININT_GetRiseStates( void* pint );
+
+void NVIC_EnableIRQ( IRQn_Type irq );
+void NVIC_DisableIRQ( IRQn_Type irq );
+void NVIC_ClearPendingIRQ( IRQn_Type irq );
+void NVIC_SetPriority( IRQn_Type irq, uint32_t priority );
+
+#endif
@@ -0,0 +1,13 @@
+/* Event groups de FreeRTOS en la PC (host_rtos.c) */
+#ifndef EVENT_GROUPS_H
+#define EVENT_GROUPS_H
+
+#include "FreeRTOS.h"
+
+EventGroupHandle_t xEventGroupCreate( void );
+EventGroupHandle_t xEventGroupCreateStatic( StaticEventGroup_t* group_buffer );
+EventBits_t xEventGroupSetBits( EventGroupHandle_t group, EventBits_t bits );
+EventBits_t xEventGroupClearBits( EventGroupHandle_t group, EventBits_t bits );
+EventBits_t xEventGroupWaitBits( EventGroupHandle_t group, EventBits_t bits, BaseType_t clear_on_exit, BaseType_t wait_all, TickType_t wait );
+
+#endif
@@ -0,0 +1,26 @@
+/* Colas de FreeRTOS en la PC. Hay dos implementaciones:
+   host_queue.c: buffer circular con un mutex de pthreads, tiempos de espera en ms reales
+   host_rtos.c:  colas del kernel de tiempo virtual, las esperas bloquean a la tarea simulada */
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include "FreeRTOS.h"
+
+#define queueQUEUE_TYPE_MUTEX   1
+
+QueueHandle_t xQueueCreate( UBaseType_t length, UBaseType_t item_size );
+QueueHandle_t xQueueCreateStatic( UBaseType_t length, UBaseType_t item_size, uint8_t* storage, StaticQueue_t* queue_buffer );
+QueueHandle_t xQueueCreateMutex( uint8_t type );
+BaseType_t xQueueSend( QueueHandle_t queue, const void* item, TickType_t wait );
+BaseType_t xQueueReceive( QueueHandle_t queue, void* item, TickType_t wait );
+BaseType_t xQueueSendFromISR( QueueHandle_t queue, const void* item, BaseType_t* woken );
+BaseType_t xQueueReceiveFromISR( QueueHandle_t queue, void* item, BaseType_t* woken );
+BaseType_t xQueueIsQueueFullFromISR( QueueHandle_t queue );
+UBaseType_t uxQueueMessagesWaiting( QueueHandle_t queue );
+UBaseType_t uxQueueMessagesWaitingFromISR( QueueHandle_t queue );
+
+/* solo host_queue.c: se llama cuando un envio falla por cola llena, antes de volver.
+   Permite reproducir que el consumidor vacie la cola justo en ese instante */
+extern void ( *host_queue_on_full )( QueueHandle_t queue );
+
+#endif
@@ -0,0 +1,36 @@
+/* Lo minimo de la sAPI para compilar en la PC los nucleos que no usan el RTOS.
+   gpioRead/gpioWrite y la tabla gpioPinsInit los simula host_board.c */
+#ifndef SAPI_H
+#define SAPI_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "chip.h"
+
+typedef uint8_t bool_t;
+
+#define TRUE    1
+#define FALSE   0
+#define ON      1
+#define OFF     0
+
+typedef enum { TEC1, TEC2, TEC3, TEC4, LEDR, LEDG, LEDB, LED1, LED2, LED3 } gpioMap_t;
+
+/* los drivers usan BUTTON_UP como estado inicial de su propia FSM */
+#define BUTTON_UP       0
+
+/* de la tabla de la sAPI solo se usa el GPIO de cada pin */
+typedef struct
+{
+    struct
+    {
+        int8_t port;
+        int8_t pin;
+    } gpio;
+} pinInitGpioLpc4337_t;
+
+bool_t gpioRead( gpioMap_t pin );
+bool_t gpioWrite( gpioMap_t pin, bool_t value );
+
+#endif
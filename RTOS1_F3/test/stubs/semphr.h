@@ -0,0 +1,13 @@
+/* Semaforos de FreeRTOS en la PC: como en el kernel, son colas de largo 1 con items de 0 bytes */
+#ifndef SEMPHR_H
+#define SEMPHR_H
+
+#include "queue.h"
+
+#define xSemaphoreCreateBinary()                xQueueCreate( 1, 0 )
+#define xSemaphoreCreateMutex()                 xQueueCreateMutex( queueQUEUE_TYPE_MUTEX )
+#define xSemaphoreTake( sem, wait )             xQueueReceive( ( sem ), NULL, ( wait ) )
+#define xSemaphoreGive( sem )                   xQueueSend( ( sem ), NULL, 0 )
+#define xSemaphoreGiveFromISR( sem, woken )     xQueueSendFromISR( ( sem ), NULL, ( woken ) )
+
+#endif
@@ -0,0 +1,30 @@
+/* Tareas de FreeRTOS en la PC (host_rtos.c): tiempo virtual y una sola tarea corriendo a la vez */
+#ifndef TASK_H
+#define TASK_H
+
+#include <stdlib.h>
+
+#include "FreeRTOS.h"
+
+BaseType_t xTaskCreate( TaskFunction_t code, const char* name, uint32_t stack_depth, void* param, UBaseType_t priority, TaskHandle_t* handle );
+TaskHandle_t xTaskCreateStatic( TaskFunction_t code, const char* name, uint32_t stack_depth, void* param, UBaseType_t priority, StackType_t* stack, StaticTask_t* tcb );
+void vTaskDelete( TaskHandle_t task );
+void vTaskDelay( TickType_t ticks );
+void vTaskDelayUntil( TickType_t* previous_wake, TickType_t increment );
+TickType_t xTaskGetTickCount( void );
+TickType_t xTaskGetTickCountFromISR( void );
+
+#define taskYIELD()                         vTaskDelay( 0 )
+
+/* una tarea solo deja la CPU cuando se bloquea y las interrupciones entran entre ticks:
+   las secciones criticas no tienen nada que enmascarar */
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+#define taskENTER_CRITICAL_FROM_ISR()       0
+#define taskEXIT_CRITICAL_FROM_ISR( x )     ( void )( x )
+
+/* el configASSERT de las FreeRTOSConfig.h de la placa deshabilita las interrupciones y se
+   queda en un lazo: en la PC se aborta, y la prueba lo ve como una falla */
+#define taskDISABLE_INTERRUPTS()            abort()
+
+#endif
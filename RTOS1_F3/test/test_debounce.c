@@ -0,0 +1,364 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Prueba en la PC del antirrebote adaptivo (keys_debounce.c) con rebotes grabados.
+
+   Se simula de a 1 tick el camino completo de keys.c: la ISR con su prefiltro (sentido y
+   holdoff), la cola y task_tecla con su FSM, su espera y su aprendizaje. Cada perfil se
+   corre con la ventana adaptiva y con la ventana fija de 40 ms que habia antes; en ambos
+   casos tienen que salir exactamente una pulsacion y una liberacion por cada pulsacion
+   grabada, y se compara la latencia. Despues se repite cada perfil sin el prefiltro de la
+   ISR y se compara el maximo de isr_queue, los flancos perdidos y los despertares de
+   task_tecla, que es lo que cuesta CPU.
+
+   make -C RTOS1_F3/test */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "keys_debounce.h"
+
+#define PULSACIONES     40          // pulsaciones por perfil
+#define SOSTENIDA_MS    150         // duracion de cada pulsacion
+#define PAUSA_MS        250         // entre pulsaciones
+#define COLA_LEN        10          // isr_queue
+#define VENTANA_FIJA_MS 40          // el DEBOUNCE_TIME original
+
+/* rebote grabado: instantes de cada flanco desde el primero, en ms. La cantidad es impar:
+   el primero y el ultimo van en el sentido de la pulsacion o la liberacion */
+typedef struct
+{
+    const char* nombre;
+    uint32_t    pulsa[32];
+    uint32_t    n_pulsa;
+    uint32_t    suelta[32];
+    uint32_t    n_suelta;
+    uint32_t    largo_cada;         // si no es 0, cada tantas pulsaciones el rebote de pulsar
+    uint32_t    largo[32];          // es este, mas largo (tecla que falla de vez en cuando)
+    uint32_t    n_largo;
+} t_perfil;
+
+static const t_perfil perfiles[] =
+{
+    { "tecla nueva",        {0, 1, 2}, 3,                     {0}, 1,                 0, {0}, 0 },
+    { "tecla tipica",       {0, 1, 2, 4, 5}, 5,               {0, 2, 3}, 3,           0, {0}, 0 },
+    { "tecla gastada",      {0, 2, 3, 5, 8, 10, 12}, 7,       {0, 1, 4, 6, 9}, 5,     0, {0}, 0 },
+    { "tecla muy gastada",  {0, 3, 5, 9, 14, 18, 21, 24, 26}, 9, {0, 4, 8, 13, 17}, 5, 0, {0}, 0 },
+    { "rebote largo aislado", {0, 1, 2}, 3,                   {0, 1, 2}, 3,           7, {0, 1, 3, 6, 8, 11, 13}, 7 },
+    /* tormenta: dos flancos por ms durante 15 ms al pulsar y 10 ms al soltar */
+    { "tormenta de rebotes",
+      {0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15}, 31,
+      {0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10}, 21,      0, {0}, 0 },
+};
+
+typedef struct
+{
+    TickType_t  t;
+    uint32_t    type;
+} t_evento;
+
+/* estado de la simulacion de keys.c para una tecla */
+typedef struct
+{
+    /* pin */
+    int         nivel;              // 1 liberada, 0 pulsada
+    /* ISR */
+    int         prefiltro;          // 0: todo flanco va a la cola, como antes de keys_isr_post
+    TickType_t  raw;
+    TickType_t  isr_last_time;
+    uint32_t    isr_last_type;
+    t_evento    cola[COLA_LEN];
+    uint32_t    cola_n;
+    uint32_t    cola_max;           // high water mark de isr_queue
+    uint32_t    perdidos;
+    /* task_tecla */
+    int         pulsada;            // estado de la FSM
+    int         esperando;
+    t_evento    actual;
+    TickType_t  inicio;
+    TickType_t  despertar;
+    t_key_debounce_stats db;
+    /* resultados */
+    uint32_t    pulsaciones;
+    uint32_t    liberaciones;
+    uint32_t    despertares;        // veces que task_tecla sale de la cola o de su espera
+    uint64_t    latencia_total;
+    TickType_t  latencia_max;
+} t_sim;
+
+static void isr_flanco( t_sim* s, TickType_t t, uint32_t type )
+{
+    s->raw = t;
+
+    if( s->prefiltro && ( type == s->isr_last_type || ( TickType_t )( t - s->isr_last_time ) < KEYS_ISR_HOLDOFF_MS ) )
+    {
+        return;
+    }
+
+    if( s->cola_n == COLA_LEN )
+    {
+        s->perdidos++;
+        return;
+    }
+
+    s->cola[s->cola_n].t = t;
+    s->cola[s->cola_n].type = type;
+    s->cola_n++;
+    if( s->cola_n > s->cola_max )
+    {
+        s->cola_max = s->cola_n;
+    }
+    s->isr_last_time = t;
+    s->isr_last_type = type;
+}
+
+static void resincronizar( t_sim* s )
+{
+    s->isr_last_type = s->pulsada ? TEC_FALL : TEC_RISE;
+}
+
+/* un tick de task_tecla. t_pulsa: instante del primer flanco de la ultima pulsacion */
+static void tarea( t_sim* s, TickType_t t, int adaptiva, TickType_t t_pulsa )
+{
+    while( !s->esperando && s->cola_n > 0 )
+    {
+        s->actual = s->cola[0];
+        memmove( &s->cola[0], &s->cola[1], --s->cola_n * sizeof( t_evento ) );
+        s->despertares++;
+
+        if( ( !s->pulsada && s->actual.type == TEC_FALL ) || ( s->pulsada && s->actual.type == TEC_RISE ) )
+        {
+            s->esperando = 1;
+            s->inicio = t;
+            s->despertar = t + ( adaptiva ? s->db.debounce : VENTANA_FIJA_MS );
+        }
+        else
+        {
+            resincronizar( s );
+        }
+    }
+
+    if( !s->esperando || t != s->despertar )
+    {
+        return;
+    }
+
+    s->despertares++;
+
+    if( adaptiva )
+    {
+        if( keys_debounce_settling( s->actual.t, s->raw, t ) )
+        {
+            s->db.extended++;
+            s->despertar = t + KEYS_DEBOUNCE_MARGIN_MS;
+            return;
+        }
+
+        keys_debounce_learn( &s->db, s->actual.t, s->raw, s->inicio, t );
+    }
+
+    s->esperando = 0;
+
+    if( s->actual.type == TEC_FALL && s->nivel == 0 )
+    {
+        TickType_t latencia = t - t_pulsa;
+
+        s->pulsada = 1;
+        s->pulsaciones++;
+        s->latencia_total += latencia;
+        if( latencia > s->latencia_max )
+        {
+            s->latencia_max = latencia;
+        }
+    }
+    else if( s->actual.type == TEC_RISE && s->nivel == 1 )
+    {
+        s->pulsada = 0;
+        s->liberaciones++;
+    }
+
+    resincronizar( s );
+}
+
+/* agrega los flancos de un rebote a la linea de tiempo del pin */
+static uint32_t agregar( TickType_t* cambios, uint32_t n, TickType_t t0, const uint32_t* rebote, uint32_t len )
+{
+    for( uint32_t i = 0; i < len; i++ )
+    {
+        cambios[n++] = t0 + rebote[i];
+    }
+    return n;
+}
+
+static void simular( const t_perfil* p, TickType_t origen, int adaptiva, int prefiltro, t_sim* s )
+{
+    static TickType_t cambios[PULSACIONES * 2 * 32];
+    TickType_t pulsas[PULSACIONES];
+    uint32_t n = 0;
+    uint32_t c = 0;
+    uint32_t k = 0;
+    TickType_t fin;
+
+    for( uint32_t i = 0; i < PULSACIONES; i++ )
+    {
+        TickType_t t0 = origen + 100 + i * ( SOSTENIDA_MS + PAUSA_MS );
+
+        pulsas[i] = t0;
+        if( p->largo_cada != 0 && i % p->largo_cada == p->largo_cada - 1 )
+        {
+            n = agregar( cambios, n, t0, p->largo, p->n_largo );
+        }
+        else
+        {
+            n = agregar( cambios, n, t0, p->pulsa, p->n_pulsa );
+        }
+        n = agregar( cambios, n, t0 + SOSTENIDA_MS, p->suelta, p->n_suelta );
+    }
+    fin = cambios[n - 1] + 200;
+
+    memset( s, 0, sizeof( *s ) );
+    s->prefiltro = prefiltro;
+    s->nivel = 1;
+    s->isr_last_time = origen - KEYS_ISR_HOLDOFF_MS;
+    s->isr_last_type = TEC_RISE;
+    keys_debounce_reset( &s->db );
+
+    for( TickType_t t = origen; t != fin; t++ )
+    {
+        while( c < n && cambios[c] == t )
+        {
+            s->nivel = !s->nivel;
+            isr_flanco( s, t, s->nivel ? TEC_RISE : TEC_FALL );
+            c++;
+        }
+
+        while( k + 1 < PULSACIONES && ( int32_t )( t - pulsas[k + 1] ) >= 0 )
+        {
+            k++;
+        }
+
+        tarea( s, t, adaptiva, pulsas[k] );
+    }
+}
+
+/* el caso que inflaba la ventana: el evento espero en la cola y, mientras tanto, una
+   pulsacion posterior actualizo el ultimo flanco crudo */
+static int probar_evento_demorado( void )
+{
+    t_key_debounce_stats db;
+    int ok;
+
+    keys_debounce_reset( &db );
+    db.debounce = pdMS_TO_TICKS( 6 );
+
+    /* flanco en 1000, task_tecla lo toma en 1030 y el ultimo flanco crudo es de 1028 */
+    keys_debounce_learn( &db, 1000, 1028, 1030, 1036 );
+    ok = db.debounce == pdMS_TO_TICKS( 6 ) && db.skipped == 1 && db.max_envelope == 0;
+
+    /* evento al dia: el ultimo flanco crudo es anterior al evento, envolvente 0 */
+    keys_debounce_learn( &db, 2000, 1990, 2000, 2006 );
+    ok = ok && db.last_envelope == 0 && db.skipped == 1;
+
+    printf( "%-4s evento demorado en la cola no infla la ventana\n", ok ? "OK" : "FALLA" );
+
+    return ok;
+}
+
+int main( void )
+{
+    uint32_t fallas = 0;
+
+    fallas += !probar_evento_demorado();
+    t_sim adaptiva;
+    t_sim fija;
+
+    printf( "%-22s %8s %8s %8s %8s %9s %9s\n", "perfil", "ventana", "envolv.", "saltea", "extend.", "lat fija", "lat adapt" );
+
+    for( uint32_t i = 0; i < sizeof( perfiles ) / sizeof( perfiles[0] ); i++ )
+    {
+        const t_perfil* p = &perfiles[i];
+
+        /* arranca cerca del desborde del tick para cubrirlo tambien */
+        simular( p, 0xFFFFF000UL, 0, 1, &fija );
+        simular( p, 0xFFFFF000UL, 1, 1, &adaptiva );
+
+        int ok = fija.pulsaciones == PULSACIONES && fija.liberaciones == PULSACIONES &&
+                 adaptiva.pulsaciones == PULSACIONES && adaptiva.liberaciones == PULSACIONES &&
+                 adaptiva.perdidos == 0 && adaptiva.db.debounce >= pdMS_TO_TICKS( KEYS_DEBOUNCE_MIN_MS ) &&
+                 adaptiva.db.debounce <= pdMS_TO_TICKS( KEYS_DEBOUNCE_MAX_MS ) &&
+                 adaptiva.latencia_total <= fija.latencia_total;
+
+        printf( "%-22s %5u ms %5u ms %8u %8u %6u ms %6u ms  %s\n", p->nombre, adaptiva.db.debounce, adaptiva.db.max_envelope,
+                adaptiva.db.skipped, adaptiva.db.extended,
+                ( uint32_t )( fija.latencia_total / PULSACIONES ), ( uint32_t )( adaptiva.latencia_total / PULSACIONES ),
+                ok ? "OK" : "FALLA" );
+
+        if( !ok )
+        {
+            printf( "     fija: %u/%u eventos, adaptiva: %u/%u eventos, %u perdidos en la cola\n", fija.pulsaciones,
+                    fija.liberaciones, adaptiva.pulsaciones, adaptiva.liberaciones, adaptiva.perdidos );
+            fallas++;
+        }
+    }
+
+    printf( "(latencia promedio desde el primer flanco hasta que task_tecla acepta la pulsacion)\n" );
+
+    /* el mismo camino sin el prefiltro de keys_isr_post: cada flanco crudo va a isr_queue */
+    printf( "\n%-22s %13s %13s %13s %13s\n", "perfil", "cola max", "despertares", "perdidos", "eventos" );
+    printf( "%-22s %6s %6s %6s %6s %6s %6s %6s %6s\n", "", "con", "sin", "con", "sin", "con", "sin", "con", "sin" );
+
+    for( uint32_t i = 0; i < sizeof( perfiles ) / sizeof( perfiles[0] ); i++ )
+    {
+        const t_perfil* p = &perfiles[i];
+        t_sim con;
+        t_sim sin;
+
+        simular( p, 0xFFFFF000UL, 1, 1, &con );
+        simular( p, 0xFFFFF000UL, 1, 0, &sin );
+
+        /* con el prefiltro no se pierde nada, y ni la cola ni los despertares superan a los de sin prefiltro */
+        int ok = con.perdidos == 0 && con.cola_max <= sin.cola_max && con.despertares <= sin.despertares &&
+                 con.pulsaciones == PULSACIONES && con.liberaciones == PULSACIONES;
+
+        printf( "%-22s %6u %6u %6u %6u %6u %6u %6u %6u  %s\n", p->nombre, con.cola_max, sin.cola_max,
+                con.despertares, sin.despertares, con.perdidos, sin.perdidos,
+                con.pulsaciones + con.liberaciones, sin.pulsaciones + sin.liberaciones, ok ? "OK" : "FALLA" );
+
+        fallas += !ok;
+    }
+
+    printf( "(%u pulsaciones por perfil; eventos: pulsaciones + liberaciones aceptadas, se esperan %u)\n",
+            PULSACIONES, 2 * PULSACIONES );
+    printf( "%u fallas\n", fallas );
+
+    return fallas ? 1 : 0;
+}
@@ -0,0 +1,252 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Prueba en la PC del bus de eventos de RTOS1_F3_M (event_bus.c) sobre las colas de host_queue.c.
+
+   Primero se verifican las politicas de desborde y el conteo de perdidas, incluido el caso
+   en que el consumidor vacia la cola entre el envio fallido y el descarte. Despues se mide,
+   con 1, 4 y 16 suscriptores que esperan cada uno en su hilo, el costo de bus_publish y la
+   latencia desde la publicacion hasta que cada suscriptor tiene el dato. Son tiempos de la
+   PC con hilos del sistema operativo: sirven para comparar cantidades de suscriptores, no
+   como valores del Cortex-M4.
+
+   make -C RTOS1_F3/test */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "event_bus.h"
+
+#define PUBLICACIONES   5000        // por cantidad de suscriptores
+#define MAX_SUBS        16
+#define FIN             0xFFFFFFFFu // seq que termina a los consumidores
+
+typedef struct
+{
+    uint64_t t_ns;                  // instante de la publicacion
+    uint32_t seq;
+} t_msg;
+
+typedef struct
+{
+    t_bus_subscriber* sub;
+    uint32_t*         latencias;    // ns, una por publicacion
+} t_consumidor;
+
+static volatile uint32_t recibidos;
+
+static uint64_t ahora_ns( void )
+{
+    struct timespec t;
+    clock_gettime( CLOCK_MONOTONIC, &t );
+    return ( uint64_t ) t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+static int comparar( const void* a, const void* b )
+{
+    uint32_t x = *( const uint32_t* ) a;
+    uint32_t y = *( const uint32_t* ) b;
+    return ( x > y ) - ( x < y );
+}
+
+/*=====[ politicas ]=====*/
+
+static void vaciar( QueueHandle_t queue )
+{
+    t_msg m;
+
+    host_queue_on_full = NULL;
+    while( xQueueReceive( queue, &m, 0 ) == pdPASS );
+}
+
+/* publica 0..4 en una cola de 2 y devuelve lo que quedo */
+static int probar_politica( t_bus_policy policy, int desde_isr, int consumidor_vacia, uint32_t perdidos, uint32_t primero, uint32_t quedan )
+{
+    t_bus_subscriber sub = BUS_SUBSCRIBER( 2, policy, 0 );
+    t_bus_subscriber* const subs[] = { &sub };
+    const t_bus_topic topic = BUS_TOPIC( t_msg, subs );
+    t_msg m = { 0 };
+    uint32_t n = 0;
+    int ok;
+
+    bus_topic_Init( &topic );
+
+    for( m.seq = 0; m.seq < 5; m.seq++ )
+    {
+        /* el consumidor toma todo justo despues del envio fallido */
+        host_queue_on_full = ( consumidor_vacia && m.seq == 2 ) ? vaciar : NULL;
+
+        if( desde_isr )
+        {
+            BaseType_t woken = 0;
+            bus_publish_from_isr( &topic, &m, sizeof( m ), &woken );
+        }
+        else
+        {
+            bus_publish( &topic, &m, sizeof( m ) );
+        }
+    }
+
+    host_queue_on_full = NULL;
+
+    ok = ( sub.dropped == perdidos );
+
+    while( bus_receive( &sub, &m, sizeof( m ), 0 ) == pdPASS )
+    {
+        ok &= ( m.seq == primero + n );
+        n++;
+    }
+
+    ok &= ( n == quedan );
+
+    return ok;
+}
+
+/*=====[ medicion ]=====*/
+
+static void* consumidor( void* arg )
+{
+    t_consumidor* c = arg;
+    t_msg m;
+
+    while( bus_receive( c->sub, &m, sizeof( m ), portMAX_DELAY ) == pdPASS && m.seq != FIN )
+    {
+        c->latencias[m.seq] = ( uint32_t )( ahora_ns() - m.t_ns );
+        __atomic_fetch_add( &recibidos, 1, __ATOMIC_RELEASE );
+    }
+
+    return NULL;
+}
+
+static void medir( uint32_t n_subs )
+{
+    static t_bus_subscriber subs[MAX_SUBS];
+    static t_bus_subscriber* lista[MAX_SUBS];
+    static t_consumidor consumidores[MAX_SUBS];
+    static uint32_t costos[PUBLICACIONES];
+    static uint32_t latencias[MAX_SUBS * PUBLICACIONES];
+    pthread_t hilos[MAX_SUBS];
+    t_msg m;
+    uint64_t suma_costo = 0, suma_lat = 0;
+
+    for( uint32_t i = 0; i < n_subs; i++ )
+    {
+        subs[i] = ( t_bus_subscriber ) BUS_SUBSCRIBER( 4, BUS_BLOCK, portMAX_DELAY );
+        lista[i] = &subs[i];
+        consumidores[i].sub = &subs[i];
+        consumidores[i].latencias = &latencias[i * PUBLICACIONES];
+    }
+
+    const t_bus_topic topic = { .subs = lista, .count = n_subs, .item_size = sizeof( t_msg ) };
+    bus_topic_Init( &topic );
+
+    recibidos = 0;
+    for( uint32_t i = 0; i < n_subs; i++ )
+    {
+        pthread_create( &hilos[i], NULL, consumidor, &consumidores[i] );
+    }
+
+    for( uint32_t k = 0; k < PUBLICACIONES; k++ )
+    {
+        uint64_t t0 = ahora_ns();
+
+        m.seq  = k;
+        m.t_ns = t0;
+        bus_publish( &topic, &m, sizeof( m ) );
+        costos[k] = ( uint32_t )( ahora_ns() - t0 );
+
+        /* una publicacion por vez: se mide la latencia, no la espera en la cola */
+        while( __atomic_load_n( &recibidos, __ATOMIC_ACQUIRE ) < ( k + 1 ) * n_subs );
+    }
+
+    m.seq = FIN;
+    bus_publish( &topic, &m, sizeof( m ) );
+
+    for( uint32_t i = 0; i < n_subs; i++ )
+    {
+        pthread_join( hilos[i], NULL );
+    }
+
+    for( uint32_t k = 0; k < PUBLICACIONES; k++ )
+    {
+        suma_costo += costos[k];
+    }
+
+    for( uint32_t k = 0; k < n_subs * PUBLICACIONES; k++ )
+    {
+        suma_lat += latencias[k];
+    }
+
+    qsort( costos, PUBLICACIONES, sizeof( costos[0] ), comparar );
+    qsort( latencias, n_subs * PUBLICACIONES, sizeof( latencias[0] ), comparar );
+
+    printf( "%4u %10llu %10u %10llu %10u\n", n_subs,
+            ( unsigned long long )( suma_costo / PUBLICACIONES ), costos[PUBLICACIONES * 99 / 100],
+            ( unsigned long long )( suma_lat / ( n_subs * PUBLICACIONES ) ), latencias[n_subs * PUBLICACIONES * 99 / 100] );
+}
+
+int main( void )
+{
+    static const uint32_t cantidades[] = { 1, 4, 16 };
+    uint32_t fallas = 0;
+    int ok;
+
+    ok = probar_politica( BUS_DROP_OLDEST, 0, 0, 3, 3, 2 );
+    printf( "%-4s drop oldest: quedan los 2 mas nuevos, 3 perdidos\n", ok ? "OK" : "FALLA" );
+    fallas += !ok;
+
+    ok = probar_politica( BUS_DROP_NEWEST, 0, 0, 3, 0, 2 );
+    printf( "%-4s drop newest: quedan los 2 mas viejos, 3 perdidos\n", ok ? "OK" : "FALLA" );
+    fallas += !ok;
+
+    ok = probar_politica( BUS_DROP_OLDEST, 1, 0, 3, 3, 2 );
+    printf( "%-4s drop oldest desde ISR\n", ok ? "OK" : "FALLA" );
+    fallas += !ok;
+
+    /* 0 y 1 los toma el consumidor, 2 entra sin descartar nada, 3 y 4 tambien */
+    ok = probar_politica( BUS_DROP_OLDEST, 0, 1, 1, 3, 2 );
+    printf( "%-4s drop oldest con la cola vaciada por el consumidor: solo cuenta lo descartado\n", ok ? "OK" : "FALLA" );
+    fallas += !ok;
+
+    printf( "\n%4s %10s %10s %10s %10s\n", "subs", "publ. ns", "p99 ns", "lat. ns", "p99 ns" );
+    for( uint32_t i = 0; i < sizeof( cantidades ) / sizeof( cantidades[0] ); i++ )
+    {
+        medir( cantidades[i] );
+    }
+    printf( "(costo de bus_publish y latencia hasta que cada suscriptor recibe, %u publicaciones)\n", PUBLICACIONES );
+
+    printf( "%u fallas\n", fallas );
+
+    return fallas ? 1 : 0;
+}
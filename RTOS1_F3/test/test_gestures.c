@@ -0,0 +1,229 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Prueba en la PC del reconocedor de gestos (gestures_fsm.c) con secuencias de flancos
+   guionadas. Se simula el tiempo de a 1 tick: en cada tick se aplican los flancos que
+   corresponden y luego se vencen los temporizados, como hace task_gestures.
+
+   make -C RTOS1_F3/test */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "gestures.h"
+
+#define MAX_GESTOS      16
+#define FIN_DEL_GUION   2000        // ticks que se simulan luego del ultimo flanco
+
+typedef struct
+{
+    TickType_t  t;                  // relativo al inicio del guion
+    uint32_t    tecla;
+    uint32_t    edge;               // TEC_FALL / TEC_RISE
+} t_paso;
+
+typedef struct
+{
+    const char*     nombre;
+    TickType_t      inicio;         // tick absoluto del primer paso (prueba el desborde)
+    const t_paso*   pasos;
+    uint32_t        n_pasos;
+    const t_gesture_event* esperados;
+    uint32_t        n_esperados;
+} t_guion;
+
+static const t_gesture_config config =
+{
+    .long_press  = 800,
+    .multi_click = 300,
+    .chord       = 100,
+};
+
+static t_gesture_event gestos[MAX_GESTOS];
+static uint32_t n_gestos;
+static TickType_t inicio;
+
+void user_gesture( t_gesture_event* gesture )
+{
+    if( n_gestos < MAX_GESTOS )
+    {
+        gestos[n_gestos] = *gesture;
+        gestos[n_gestos].event_time -= inicio;      // se compara relativo al guion
+        n_gestos++;
+    }
+}
+
+static void aplicar( const t_paso* paso )
+{
+    t_key_isr_signal ev;
+
+    ev.tecla      = paso->tecla;
+    ev.event_time = inicio + paso->t;
+    ev.event_type = paso->edge;
+
+    gestures_process_edge( &ev );
+}
+
+static int correr( const t_guion* g )
+{
+    uint32_t p = 0;
+    TickType_t fin = g->pasos[g->n_pasos - 1].t + FIN_DEL_GUION;
+
+    inicio = g->inicio;
+    n_gestos = 0;
+    gestures_fsm_Init( &config );
+
+    for( TickType_t t = 0; t <= fin; t++ )
+    {
+        while( p < g->n_pasos && g->pasos[p].t == t )
+        {
+            aplicar( &g->pasos[p++] );
+        }
+
+        gestures_process_timeout( inicio + t );
+    }
+
+    int ok = ( n_gestos == g->n_esperados );
+
+    for( uint32_t i = 0; ok && i < n_gestos; i++ )
+    {
+        const t_gesture_event* e = &g->esperados[i];
+
+        ok = gestos[i].type == e->type && gestos[i].tecla == e->tecla && gestos[i].tecla2 == e->tecla2 &&
+             gestos[i].event_time == e->event_time && gestos[i].duration == e->duration;
+    }
+
+    printf( "%-4s %s\n", ok ? "OK" : "FALLA", g->nombre );
+
+    if( !ok )
+    {
+        for( uint32_t i = 0; i < n_gestos; i++ )
+        {
+            printf( "     obtenido: tipo %u tecla %u/%u t %u dur %u\n", gestos[i].type, gestos[i].tecla,
+                    gestos[i].tecla2, gestos[i].event_time, gestos[i].duration );
+        }
+        for( uint32_t i = 0; i < g->n_esperados; i++ )
+        {
+            const t_gesture_event* e = &g->esperados[i];
+            printf( "     esperado: tipo %u tecla %u/%u t %u dur %u\n", e->type, e->tecla, e->tecla2, e->event_time, e->duration );
+        }
+    }
+
+    return ok;
+}
+
+/* costo por flanco en la PC: solo para comparar versiones de la FSM. El costo en la placa
+   se obtiene con GESTURES_MEASURE_CYCLES 1 */
+static void medir_costo( void )
+{
+    const uint32_t n = 1000000;
+    t_key_isr_signal ev;
+    clock_t c0;
+    double s;
+
+    gestures_fsm_Init( &config );
+
+    c0 = clock();
+    for( uint32_t i = 0; i < n; i++ )
+    {
+        ev.tecla      = i & 3;
+        ev.event_time = i * 50;
+        ev.event_type = ( i >> 2 ) & 1;
+        gestures_process_edge( &ev );
+    }
+    s = ( double )( clock() - c0 ) / CLOCKS_PER_SEC;
+
+#if GESTURES_USE_TABLE==1
+    printf( "costo en la PC (tabla): %.1f ns por flanco\n", s * 1e9 / n );
+#else
+    printf( "costo en la PC (switch): %.1f ns por flanco\n", s * 1e9 / n );
+#endif
+}
+
+#define GUION( nombre, inicio, pasos, esperados ) \
+    { nombre, inicio, pasos, sizeof( pasos ) / sizeof( pasos[0] ), esperados, sizeof( esperados ) / sizeof( esperados[0] ) }
+
+static const t_paso click[]         = { {0, 0, TEC_FALL}, {100, 0, TEC_RISE} };
+static const t_gesture_event click_e[] = { {GESTURE_CLICK, 0, 0, 0, 0} };
+
+static const t_paso doble[]         = { {0, 1, TEC_FALL}, {80, 1, TEC_RISE}, {200, 1, TEC_FALL}, {280, 1, TEC_RISE} };
+static const t_gesture_event doble_e[] = { {GESTURE_DOUBLE_CLICK, 1, 1, 0, 0} };
+
+static const t_paso triple[]        = { {0, 2, TEC_FALL}, {60, 2, TEC_RISE}, {150, 2, TEC_FALL}, {210, 2, TEC_RISE},
+                                        {300, 2, TEC_FALL}, {360, 2, TEC_RISE} };
+static const t_gesture_event triple_e[] = { {GESTURE_TRIPLE_CLICK, 2, 2, 0, 0} };
+
+static const t_paso larga[]         = { {0, 0, TEC_FALL}, {1500, 0, TEC_RISE} };
+static const t_gesture_event larga_e[] = { {GESTURE_LONG_PRESS, 0, 0, 0, 800} };
+
+static const t_paso separados[]     = { {0, 0, TEC_FALL}, {50, 0, TEC_RISE}, {500, 0, TEC_FALL}, {550, 0, TEC_RISE} };
+static const t_gesture_event separados_e[] = { {GESTURE_CLICK, 0, 0, 0, 0}, {GESTURE_CLICK, 0, 0, 500, 0} };
+
+static const t_paso acorde[]        = { {0, 0, TEC_FALL}, {50, 3, TEC_FALL}, {400, 0, TEC_RISE}, {420, 3, TEC_RISE} };
+static const t_gesture_event acorde_e[] = { {GESTURE_CHORD, 0, 3, 0, 0} };
+
+static const t_paso no_acorde[]     = { {0, 0, TEC_FALL}, {200, 1, TEC_FALL}, {300, 0, TEC_RISE}, {350, 1, TEC_RISE} };
+static const t_gesture_event no_acorde_e[] = { {GESTURE_CLICK, 0, 0, 0, 0}, {GESTURE_CLICK, 1, 1, 200, 0} };
+
+static const t_paso repetidos[]     = { {0, 0, TEC_FALL}, {10, 0, TEC_FALL}, {90, 0, TEC_RISE}, {95, 0, TEC_RISE} };
+static const t_gesture_event repetidos_e[] = { {GESTURE_CLICK, 0, 0, 0, 0} };
+
+static const t_guion guiones[] =
+{
+    GUION( "click", 1000, click, click_e ),
+    GUION( "doble click", 1000, doble, doble_e ),
+    GUION( "triple click", 1000, triple, triple_e ),
+    GUION( "pulsacion larga", 1000, larga, larga_e ),
+    GUION( "clicks separados mas que multi_click", 1000, separados, separados_e ),
+    GUION( "acorde TEC1+TEC4", 1000, acorde, acorde_e ),
+    GUION( "pulsaciones separadas mas que chord", 1000, no_acorde, no_acorde_e ),
+    GUION( "flancos repetidos", 1000, repetidos, repetidos_e ),
+    GUION( "doble click con desborde del tick", 0xFFFFFF80UL, doble, doble_e ),
+    GUION( "pulsacion larga con desborde del tick", 0xFFFFFE00UL, larga, larga_e ),
+};
+
+int main( void )
+{
+    uint32_t fallas = 0;
+
+    for( uint32_t i = 0; i < sizeof( guiones ) / sizeof( guiones[0] ); i++ )
+    {
+        fallas += !correr( &guiones[i] );
+    }
+
+    medir_costo();
+
+    printf( "%u fallas\n", fallas );
+
+    return fallas ? 1 : 0;
+}
@@ -0,0 +1,240 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Prueba en la PC del calendario de la repeticion automatica de RTOS1_D4 (keys_repeat.c).
+
+   Se reproduce lo que hace keys.c con su unico timer one-shot: al pulsar se arranca la
+   repeticion y se programa el timer con keys_repeat_left; en cada vencimiento el callback
+   emite lo que keys_repeat_fire indique y vuelve a programar. Se comparan los instantes
+   emitidos con el calendario esperado (retardo, arranque, aceleracion y piso), tambien con
+   la tarea de timers demorada, con el contador de ticks desbordando y con dos teclas
+   sostenidas compartiendo el timer.
+
+   make -C RTOS1_F3/test */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "keys_repeat.h"
+
+#define MAX_EMITIDAS    128
+#define N_TECLAS        2
+
+/* instantes esperados desde la pulsacion: 500 ms de retardo, 300 ms de intervalo inicial
+   que se reduce 1/4 en cada repeticion hasta el piso de 40 ms */
+static const TickType_t calendario[] = { 500, 800, 1025, 1194, 1321, 1417, 1489, 1543, 1584, 1624, 1664, 1704 };
+
+#define N_CALENDARIO    ( sizeof( calendario ) / sizeof( calendario[0] ) )
+
+typedef struct
+{
+    TickType_t  t[MAX_EMITIDAS];
+    uint32_t    n;
+} t_emitidas;
+
+/* instante k del calendario, extendido con el piso de 40 ms */
+static TickType_t esperado( uint32_t k )
+{
+    if( k < N_CALENDARIO )
+    {
+        return calendario[k];
+    }
+    return calendario[N_CALENDARIO - 1] + ( k - N_CALENDARIO + 1 ) * pdMS_TO_TICKS( KEYS_REPEAT_MIN_MS );
+}
+
+/* el timer de keys.c: vence cuando falta menos para la primera tecla sostenida, como minimo
+   1 tick despues de programarlo. La tarea de timers atiende cada vencimiento con demora
+   ticks de atraso (0 si no se pide demora, hasta max_demora si se pide) */
+static void simular( TickType_t origen, const TickType_t pulsa[], const TickType_t suelta[],
+                     TickType_t max_demora, t_emitidas emitidas[] )
+{
+    t_key_repeat rep[N_TECLAS] = { 0 };
+    TickType_t vence = portMAX_DELAY;
+    TickType_t now;
+    TickType_t fin = 0;
+    uint32_t i;
+
+    for( i = 0 ; i < N_TECLAS ; i++ )
+    {
+        emitidas[i].n = 0;
+        if( suelta[i] > fin )
+        {
+            fin = suelta[i];
+        }
+    }
+
+    for( TickType_t dt = 0 ; dt <= fin ; dt++ )
+    {
+        int reprogramar = 0;
+
+        now = origen + dt;
+
+        for( i = 0 ; i < N_TECLAS ; i++ )
+        {
+            if( pulsa[i] == dt && suelta[i] > pulsa[i] )
+            {
+                keys_repeat_start( &rep[i], now );
+                reprogramar = 1;
+            }
+            if( suelta[i] == dt )
+            {
+                keys_repeat_stop( &rep[i] );
+                reprogramar = 1;
+            }
+        }
+
+        if( vence != portMAX_DELAY && now == vence )
+        {
+            for( i = 0 ; i < N_TECLAS ; i++ )
+            {
+                if( keys_repeat_fire( &rep[i], now ) && emitidas[i].n < MAX_EMITIDAS )
+                {
+                    emitidas[i].t[emitidas[i].n++] = now - origen - pulsa[i];
+                }
+            }
+            reprogramar = 1;
+        }
+
+        if( reprogramar )
+        {
+            TickType_t wait = portMAX_DELAY;
+
+            for( i = 0 ; i < N_TECLAS ; i++ )
+            {
+                TickType_t left = keys_repeat_left( &rep[i], now );
+                if( left < wait )
+                {
+                    wait = left;
+                }
+            }
+
+            vence = portMAX_DELAY;
+            if( wait != portMAX_DELAY )
+            {
+                vence = now + ( wait ? wait : 1 ) + ( max_demora ? ( TickType_t )( rand() % ( max_demora + 1 ) ) : 0 );
+            }
+        }
+    }
+}
+
+/* sostenida: cuanto dura la pulsacion. Cada emision cae en su instante del calendario, o
+   hasta max_demora despues si la tarea de timers se atrasa, sin acumular el atraso */
+static int verificar( const t_emitidas* e, TickType_t sostenida, TickType_t max_demora, const char* caso )
+{
+    uint32_t n = 0;
+
+    while( esperado( n ) < sostenida )
+    {
+        n++;
+    }
+
+    for( uint32_t k = 0 ; k < e->n ; k++ )
+    {
+        if( e->t[k] < esperado( k ) || e->t[k] > esperado( k ) + max_demora )
+        {
+            printf( "     %s: repeticion %u en %u ms, se esperaba en %u\n", caso, k + 1, e->t[k], esperado( k ) );
+            return 0;
+        }
+    }
+
+    /* con demora, la ultima puede quedar del otro lado de la liberacion */
+    if( e->n != n && !( max_demora && e->n + 1 == n ) )
+    {
+        printf( "     %s: %u repeticiones, se esperaban %u\n", caso, e->n, n );
+        return 0;
+    }
+
+    return 1;
+}
+
+static int caso_una_tecla( TickType_t origen, TickType_t sostenida, TickType_t max_demora, const char* caso )
+{
+    const TickType_t pulsa[N_TECLAS]  = { 10, 0 };
+    const TickType_t suelta[N_TECLAS] = { 10 + sostenida, 0 };
+    t_emitidas e[N_TECLAS];
+
+    simular( origen, pulsa, suelta, max_demora, e );
+    return verificar( &e[0], sostenida, max_demora, caso ) && e[1].n == 0;
+}
+
+int main( void )
+{
+    uint32_t fallas = 0;
+    int ok;
+
+    srand( 1 );
+
+    ok = caso_una_tecla( 0, 3000, 0, "sostenida 3 s" );
+    printf( "%-4s sostenida 3 s: retardo, arranque, aceleracion y piso\n", ok ? "OK" : "FALLA" );
+    fallas += !ok;
+
+    ok = caso_una_tecla( 0, 499, 0, "corta" ) && caso_una_tecla( 0, 501, 0, "justa" );
+    printf( "%-4s soltada antes del retardo no repite; 1 ms despues repite una vez\n", ok ? "OK" : "FALLA" );
+    fallas += !ok;
+
+    ok = caso_una_tecla( 0xFFFFFC00UL, 3000, 0, "desborde" );
+    printf( "%-4s el contador de ticks desborda durante la repeticion\n", ok ? "OK" : "FALLA" );
+    fallas += !ok;
+
+    ok = 1;
+    for( uint32_t r = 0 ; r < 200 && ok ; r++ )
+    {
+        ok = caso_una_tecla( ( TickType_t ) rand(), 500 + rand() % 4000, 5, "tarea de timers demorada" );
+    }
+    printf( "%-4s tarea de timers demorada hasta 5 ms: el atraso no se acumula (200 pulsaciones)\n", ok ? "OK" : "FALLA" );
+    fallas += !ok;
+
+    {
+        const TickType_t pulsa[N_TECLAS]  = { 0, 733 };
+        const TickType_t suelta[N_TECLAS] = { 2500, 2100 };
+        t_emitidas e[N_TECLAS];
+
+        simular( 0, pulsa, suelta, 0, e );
+        ok = verificar( &e[0], 2500, 0, "TEC1" ) && verificar( &e[1], 2100 - 733, 0, "TEC2" );
+        printf( "%-4s dos teclas sostenidas con un solo timer: cada una sigue su calendario\n", ok ? "OK" : "FALLA" );
+        fallas += !ok;
+    }
+
+    {
+        t_key_repeat rep = { 0 };
+
+        keys_repeat_start( &rep, 100 );
+        keys_repeat_stop( &rep );
+        ok = keys_repeat_left( &rep, 100 ) == portMAX_DELAY && !keys_repeat_fire( &rep, 100 + KEYS_REPEAT_DELAY_MS );
+        printf( "%-4s liberada: no queda vencimiento ni repeticion\n", ok ? "OK" : "FALLA" );
+        fallas += !ok;
+    }
+
+    printf( "%u fallas\n", fallas );
+
+    return fallas ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Driver de teclas de D1 (RTOS1_D1/src/keys.c) completo sobre el kernel de tiempo virtual.
+
+   task_tecla muestrea TEC1 con gpioRead cada 40 ms y confirma el cambio en la muestra
+   siguiente. El driver no avisa: los eventos se leen de keys_data cuando las tareas
+   estan bloqueadas.
+
+   make -C RTOS1_F3/test */
+
+#include <stdio.h>
+
+#include "sim_keys.h"
+#include "keys.h"
+
+extern t_key_data keys_data[];
+
+static const gpioMap_t teclas[] = { TEC1 };
+
+static TickType_t ultimo_down;
+static TickType_t ultimo_up;
+
+static void iniciar( void )
+{
+    keys_Init();
+    ultimo_down = keys_data[0].time_down;
+    ultimo_up   = keys_data[0].time_up;
+}
+
+static void observar( TickType_t now )
+{
+    if( keys_data[0].time_down != ultimo_down )
+    {
+        ultimo_down = keys_data[0].time_down;
+        sim_evento( 0, 1 );
+    }
+
+    if( keys_data[0].time_up != ultimo_up )
+    {
+        ultimo_up = keys_data[0].time_up;
+        sim_evento( 0, 0 );
+    }
+}
+
+int main( void )
+{
+    const t_sim_driver d1 = { "D1: muestreo cada 40 ms (keys.c)", teclas, 1, iniciar, observar };
+    uint32_t fallas = sim_probar( &d1 );
+
+    printf( "(%u pulsaciones por perfil; desp/p: tareas despertadas por pulsacion)\n", SIM_PULSACIONES );
+    printf( "%u fallas\n", fallas );
+
+    return fallas ? 1 : 0;
+}
@@ -0,0 +1,124 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Antirrebote de E4 completo sobre el kernel de tiempo virtual, en sus dos variantes:
+   una tarea por tecla con la FSM de fsm_debounce.c muestreando cada 1 ms (tarea_tecla), y
+   una sola tarea con los contadores verticales de vc_debounce.c, que con todas las teclas
+   estables se duerme hasta que la PININT simulada la despierta (tarea_teclas).
+
+   La pulsacion se ve en tiempo_down y la liberacion en queue_tec_pulsada, que se vacian
+   cuando las tareas estan bloqueadas.
+
+   make -C RTOS1_F3/test */
+
+#include <stdio.h>
+
+#include "sim_keys.h"
+#include "tasks.h"
+
+#define N_TECLAS    4
+
+/* los datos de auxs.c, que no se linkea */
+gpioMap_t teclas[N_TECLAS] = { TEC1, TEC2, TEC3, TEC4 };
+gpioMap_t leds[N_TECLAS]   = { LEDB, LED1, LED2, LED3 };
+tLedTecla tecla_led_config[N_TECLAS];
+const uint16_t n_teclas = N_TECLAS;
+
+static TickType_t ultimo_down[N_TECLAS];
+
+/* lo mismo que tecla_led_init de auxs.c */
+static void config_init( void )
+{
+    uint32_t i;
+
+    for( i = 0 ; i < N_TECLAS ; i++ )
+    {
+        tecla_led_config[i].tecla             = teclas[i];
+        tecla_led_config[i].led               = leds[i];
+        tecla_led_config[i].queue_tec_pulsada = xQueueCreate( 1, sizeof( TickType_t ) );
+        tecla_led_config[i].mutex             = xSemaphoreCreateMutex();
+        tecla_led_config[i].tiempo_down       = ( TickType_t ) -1;     // todavia no hubo pulsacion
+        ultimo_down[i]                        = ( TickType_t ) -1;     // todavia no hubo pulsacion
+    }
+}
+
+static void iniciar_fsm( void )
+{
+    uint32_t i;
+
+    config_init();
+    for( i = 0 ; i < N_TECLAS ; i++ )
+    {
+        xTaskCreate( tarea_tecla, "tarea_tecla", configMINIMAL_STACK_SIZE, &tecla_led_config[i], tskIDLE_PRIORITY + 1, NULL );
+    }
+}
+
+static void iniciar_vc( void )
+{
+    config_init();
+    xTaskCreate( tarea_teclas, "tarea_teclas", configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL );
+}
+
+static void observar( TickType_t now )
+{
+    TickType_t medido;
+    uint32_t i;
+
+    for( i = 0 ; i < N_TECLAS ; i++ )
+    {
+        if( tecla_led_config[i].tiempo_down != ultimo_down[i] )
+        {
+            ultimo_down[i] = tecla_led_config[i].tiempo_down;
+            sim_evento( i, 1 );
+        }
+
+        while( xQueueReceive( tecla_led_config[i].queue_tec_pulsada, &medido, 0 ) == pdPASS )
+        {
+            sim_evento( i, 0 );
+        }
+    }
+}
+
+int main( void )
+{
+    const t_sim_driver fsm = { "E4: una tarea por tecla, FSM cada 1 ms (fsm_debounce.c)", teclas, N_TECLAS, iniciar_fsm, observar };
+    const t_sim_driver vc  = { "E4: contadores verticales + despertar por PININT (vc_debounce.c)", teclas, N_TECLAS, iniciar_vc, observar };
+    uint32_t fallas = 0;
+
+    fallas += sim_probar( &fsm );
+    fallas += sim_probar( &vc );
+
+    printf( "(%u pulsaciones por perfil repartidas en 4 teclas; desp/p: tareas despertadas por pulsacion)\n", SIM_PULSACIONES );
+    printf( "%u fallas\n", fallas );
+
+    return fallas ? 1 : 0;
+}
@@ -0,0 +1,67 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Driver de teclas de F3 (keys.c + keys_debounce.c) completo sobre el kernel de tiempo virtual.
+
+   Los flancos del guion entran por la PININT simulada a los GPIOn_IRQHandler de keys.c, pasan
+   por el prefiltro de la ISR y la cola, y task_tecla espera el rebote con vTaskDelay.
+   Se informa cada evento de user_buttonPressed/user_buttonReleased.
+
+   make -C RTOS1_F3/test */
+
+#include <stdio.h>
+
+#include "sim_keys.h"
+#include "keys.h"
+
+static const gpioMap_t teclas[] = { TEC1, TEC2, TEC3, TEC4 };
+
+void user_buttonPressed( t_key_isr_signal* event_data )
+{
+    sim_evento( event_data->tecla, 1 );
+}
+
+void user_buttonReleased( t_key_isr_signal* event_data )
+{
+    sim_evento( event_data->tecla, 0 );
+}
+
+int main( void )
+{
+    const t_sim_driver f3 = { "F3: PININT + cola + antirrebote adaptivo (keys.c)", teclas, 4, keys_Init, NULL };
+    uint32_t fallas = sim_probar( &f3 );
+
+    printf( "(%u pulsaciones por perfil repartidas en 4 teclas; desp/p: tareas despertadas por pulsacion)\n", SIM_PULSACIONES );
+    printf( "%u fallas\n", fallas );
+
+    return fallas ? 1 : 0;
+}
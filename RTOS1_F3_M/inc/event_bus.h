@@ -0,0 +1,82 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef EVENT_BUS_H_
+#define EVENT_BUS_H_
+
+#include "FreeRTOS.h"
+#include "queue.h"
+
+/* public macros ================================================================= */
+#define BUS_MAX_ITEM_SIZE   32      /* tamaño maximo del dato de un topico (buffer de descarte) */
+
+/* declara un suscriptor con su cola de "length" elementos y su politica de desborde */
+#define BUS_SUBSCRIBER( length_, policy_, block_time_ ) \
+    { .queue = NULL, .length = ( length_ ), .policy = ( policy_ ), .block_time = ( block_time_ ), .item_size = 0, .dropped = 0 }
+
+/* declara un topico que transporta datos de tipo type_ hacia la lista constante subs_ */
+#define BUS_TOPIC( type_, subs_ ) \
+    { .subs = ( subs_ ), .count = sizeof( subs_ ) / sizeof( ( subs_ )[0] ), .item_size = sizeof( type_ ) }
+
+/* types ================================================================= */
+typedef enum
+{
+    BUS_DROP_OLDEST,    //cola llena: se descarta el elemento mas viejo
+    BUS_DROP_NEWEST,    //cola llena: se descarta el elemento que se publica
+    BUS_BLOCK           //cola llena: el productor espera hasta block_time (desde ISR equivale a DROP_NEWEST)
+} t_bus_policy;
+
+typedef struct
+{
+    QueueHandle_t   queue;
+    UBaseType_t     length;
+    t_bus_policy    policy;
+    TickType_t      block_time;
+    size_t          item_size;  //tamaño del dato de sus topicos (lo fija bus_topic_Init)
+    uint32_t        dropped;    //publicaciones perdidas por este suscriptor
+} t_bus_subscriber;
+
+typedef struct
+{
+    t_bus_subscriber* const*    subs;
+    uint32_t                    count;
+    size_t                      item_size;
+} t_bus_topic;
+
+/* methods ================================================================= */
+void bus_topic_Init( const t_bus_topic* topic );
+void bus_publish( const t_bus_topic* topic, const void* item, size_t size );
+void bus_publish_from_isr( const t_bus_topic* topic, const void* item, size_t size, BaseType_t* xHigherPriorityTaskWoken );
+BaseType_t bus_receive( t_bus_subscriber* sub, void* item, size_t size, TickType_t timeout );
+
+#endif /* EVENT_BUS_H_ */
@@ -62,12 +62,21 @@ typedef struct
     gpioMap_t tecla;			//config
 } t_key_config;
 
+typedef struct
+{
+    TickType_t time_down;		//timestamp of the last High to Low transition of the key
+    TickType_t time_up;		    //timestamp of the last Low to High transition of the key
+} t_key_times;
+
 typedef struct
 {
     keys_ButtonState_t state;   //variables
     TickType_t time_down;		//timestamp of the last High to Low transition of the key
     TickType_t time_up;		    //timestamp of the last Low to High transition of the key
-    TickType_t time_diff;	    //variables
+    volatile TickType_t time_diff;	//palabra alineada de 32 bits: se lee y escribe sin seccion critica
+
+    t_key_times times[2];       //copias publicadas de time_down/time_up (ver keys_get_times)
+    volatile uint32_t seq;      //la copia vigente es times[seq & 1]
 
 
     SemaphoreHandle_t pressed_signal;
@@ -85,6 +94,7 @@ typedef struct
 void keys_Init( void );
 TickType_t get_diff( uint32_t index );
 void clear_diff();
+void keys_get_times( uint32_t index, t_key_times* times );
 
 
 #endif /* PDM_ANTIRREBOTE_MEF_INC_DEBOUNCE_H_ */
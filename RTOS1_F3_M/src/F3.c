@@ -37,6 +37,7 @@
 
 #include "sapi.h"
 #include "keys.h"
+#include "event_bus.h"
 
 /*=====[Definition & macros of public constants]==============================*/
 
@@ -49,11 +50,32 @@ void task_tecla( void* taskParmPtr );
 typedef struct
 {
     gpioMap_t led;
-    xQueueHandle queue; //almacenara el evento en una cola
+    t_bus_subscriber sub;   //suscripcion al topico de su tecla
 } t_tecla_led;
 
 
-t_tecla_led leds_data[] = { {.led= LEDR}, {.led= LED1}, {.led= LED2}, {.led= LED3}};
+/* cada led se queda con la ultima liberacion: si no llego a leerla, se descarta la vieja */
+t_tecla_led leds_data[] = { {.led= LEDR, .sub= BUS_SUBSCRIBER( 2, BUS_DROP_OLDEST, 0 )},
+                            {.led= LED1, .sub= BUS_SUBSCRIBER( 2, BUS_DROP_OLDEST, 0 )},
+                            {.led= LED2, .sub= BUS_SUBSCRIBER( 2, BUS_DROP_OLDEST, 0 )},
+                            {.led= LED3, .sub= BUS_SUBSCRIBER( 2, BUS_DROP_OLDEST, 0 )}
+                          };
+
+/* topicos: liberacion de cada tecla. Un consumidor nuevo se agrega a la lista, sin tocar al productor */
+static t_bus_subscriber* const tec1_subs[] = { &leds_data[0].sub };
+static t_bus_subscriber* const tec2_subs[] = { &leds_data[1].sub };
+static t_bus_subscriber* const tec3_subs[] = { &leds_data[2].sub };
+static t_bus_subscriber* const tec4_subs[] = { &leds_data[3].sub };
+
+const t_bus_topic key_released_topics[] =
+{
+    [TEC1_INDEX] = BUS_TOPIC( t_key_isr_signal, tec1_subs ),
+    [TEC2_INDEX] = BUS_TOPIC( t_key_isr_signal, tec2_subs ),
+    [TEC3_INDEX] = BUS_TOPIC( t_key_isr_signal, tec3_subs ),
+    [TEC4_INDEX] = BUS_TOPIC( t_key_isr_signal, tec4_subs ),
+};
+
+#define topic_count     sizeof(key_released_topics)/sizeof(key_released_topics[TEC1_INDEX])
 
 /*=====[Definitions of public global variables]==============================*/
 
@@ -68,6 +90,12 @@ int main( void )
 
     printf( "Ejercicio F3\n" );
 
+    /* las colas de los suscriptores se crean antes de que alguien publique */
+    for( int i = 0; i < topic_count; i++ )
+    {
+        bus_topic_Init( &key_released_topics[i] );
+    }
+
     for( int i = 0; i < 4; i++ )
     {
         // Crear tareas en freeRTOS
@@ -103,25 +131,10 @@ void user_buttonPressed( t_key_isr_signal* event_data )
 
 void user_buttonReleased( t_key_isr_signal* event_data )
 {
-    /* asociacion tecla - led */
-    if( event_data->tecla == TEC1_INDEX )
+    /* asociacion tecla - led: la resuelven las listas de suscriptores de cada topico */
+    if( event_data->tecla < topic_count )
     {
-        xQueueSend( leds_data[0].queue, event_data, portMAX_DELAY );
-    }
-
-    if( event_data->tecla == TEC2_INDEX )
-    {
-        xQueueSend( leds_data[1].queue, event_data, portMAX_DELAY );
-    }
-
-    if( event_data->tecla == TEC3_INDEX )
-    {
-        xQueueSend( leds_data[2].queue, event_data, portMAX_DELAY );
-    }
-
-    if( event_data->tecla == TEC4_INDEX )
-    {
-        xQueueSend( leds_data[3].queue, event_data, portMAX_DELAY );
+        bus_publish( &key_released_topics[event_data->tecla], event_data, sizeof( *event_data ) );
     }
 }
 
@@ -131,8 +144,6 @@ void task_led( void* taskParmPtr )
     t_key_isr_signal evnt;
     t_tecla_led* led_data = taskParmPtr;
 
-    led_data->queue = xQueueCreate( 2, sizeof(   t_key_isr_signal )  );
-
     TickType_t dif =   pdMS_TO_TICKS( 500 );
     int tecla_presionada;
     TickType_t xPeriodicity = pdMS_TO_TICKS( 1000 ); // Tarea periodica cada 1000 ms
@@ -141,7 +152,7 @@ void task_led( void* taskParmPtr )
 
     while( 1 )
     {
-        if( xQueueReceive( led_data->queue, &evnt, 0 ) == pdPASS  )
+        if( bus_receive( &led_data->sub, &evnt, sizeof( evnt ), 0 ) == pdPASS  )
         {
             dif = get_diff( evnt.tecla );
         }
@@ -0,0 +1,151 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[ Inclusions ]============================================*/
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#include "event_bus.h"
+
+/*=====[Definition macros of private constants]==============================*/
+/* el contador se incrementa desde tareas y desde ISRs de distinta prioridad: LDREX/STREX */
+#define BUS_COUNT_DROP( sub )   __atomic_fetch_add( &( sub )->dropped, 1, __ATOMIC_RELAXED )
+
+/*=====[Implementations of public functions]=================================*/
+
+/**
+   @brief crea las colas de los suscriptores de un topico.
+          Se llama una sola vez, antes de iniciar el scheduler: publicar no reserva memoria.
+
+   @param topic
+ */
+void bus_topic_Init( const t_bus_topic* topic )
+{
+    configASSERT( topic->item_size <= BUS_MAX_ITEM_SIZE );
+
+    for( uint32_t i = 0; i < topic->count; i++ )
+    {
+        t_bus_subscriber* sub = topic->subs[i];
+
+        if( sub->queue == NULL )
+        {
+            sub->queue = xQueueCreate( sub->length, topic->item_size );
+            sub->item_size = topic->item_size;
+        }
+
+        /* un suscriptor puede estar en varios topicos, pero todos del mismo tipo */
+        configASSERT( sub->queue != NULL );
+        configASSERT( sub->item_size == topic->item_size );
+    }
+}
+
+/**
+   @brief entrega una copia del dato a cada suscriptor del topico, segun su politica.
+
+   @param topic
+   @param item
+   @param size  sizeof del dato: tiene que coincidir con el tipo del topico
+ */
+void bus_publish( const t_bus_topic* topic, const void* item, size_t size )
+{
+    uint8_t discard[BUS_MAX_ITEM_SIZE];
+
+    configASSERT( size == topic->item_size );
+
+    for( uint32_t i = 0; i < topic->count; i++ )
+    {
+        t_bus_subscriber* sub = topic->subs[i];
+        TickType_t wait = ( sub->policy == BUS_BLOCK ) ? sub->block_time : 0;
+
+        if( xQueueSend( sub->queue, item, wait ) == pdPASS )
+        {
+            continue;
+        }
+
+        if( sub->policy == BUS_DROP_OLDEST )
+        {
+            /* libero el lugar del mas viejo. Si el consumidor lo tomo primero, hay lugar
+               sin haber descartado nada */
+            if( xQueueReceive( sub->queue, discard, 0 ) == pdPASS )
+            {
+                BUS_COUNT_DROP( sub );
+            }
+
+            if( xQueueSend( sub->queue, item, 0 ) == pdPASS )
+            {
+                continue;
+            }
+        }
+
+        BUS_COUNT_DROP( sub );
+    }
+}
+
+/**
+   @brief version de bus_publish para usar desde una ISR. Nunca bloquea.
+
+   @param topic
+   @param item
+   @param size  sizeof del dato: tiene que coincidir con el tipo del topico
+   @param xHigherPriorityTaskWoken
+ */
+void bus_publish_from_isr( const t_bus_topic* topic, const void* item, size_t size, BaseType_t* xHigherPriorityTaskWoken )
+{
+    uint8_t discard[BUS_MAX_ITEM_SIZE];
+
+    configASSERT( size == topic->item_size );
+
+    for( uint32_t i = 0; i < topic->count; i++ )
+    {
+        t_bus_subscriber* sub = topic->subs[i];
+
+        if( sub->policy == BUS_DROP_OLDEST && xQueueIsQueueFullFromISR( sub->queue ) &&
+                xQueueReceiveFromISR( sub->queue, discard, xHigherPriorityTaskWoken ) == pdPASS )
+        {
+            BUS_COUNT_DROP( sub );
+        }
+
+        if( xQueueSendFromISR( sub->queue, item, xHigherPriorityTaskWoken ) != pdPASS )
+        {
+            BUS_COUNT_DROP( sub );
+        }
+    }
+}
+
+BaseType_t bus_receive( t_bus_subscriber* sub, void* item, size_t size, TickType_t timeout )
+{
+    configASSERT( size == sub->item_size );
+
+    return xQueueReceive( sub->queue, item, timeout );
+}
@@ -43,6 +43,9 @@
 //#define BUTTON_RATE     1
 #define DEBOUNCE_TIME   40
 
+/* barrera de compilador: evita que se reordenen los accesos a keys_data alrededor de seq */
+#define KEYS_BARRIER()  __asm volatile( "" ::: "memory" )
+
 #define TEC_FALL        0
 #define TEC_RISE        1
 
@@ -51,6 +54,7 @@ static void keys_isr_config( void );
 
 static void buttonPressed( t_key_isr_signal* event_data );
 static void buttonReleased( t_key_isr_signal* event_data );
+static void keys_publish_times( uint32_t index );
 void user_buttonPressed( t_key_isr_signal* event_data );
 void user_buttonReleased( t_key_isr_signal* event_data );
 
@@ -74,20 +78,35 @@ void task_tecla( void* taskParmPtr );
 /*=====[Implementations of public functions]=================================*/
 TickType_t get_diff( uint32_t index )
 {
-    TickType_t tiempo;
-
-    taskENTER_CRITICAL();
-    tiempo = keys_data[index].time_diff;
-    taskEXIT_CRITICAL();
-
-    return tiempo;
+    return keys_data[index].time_diff;
 }
 
 void clear_diff()
 {
-    taskENTER_CRITICAL();
     keys_data[TEC1_INDEX].time_diff = 0;
-    taskEXIT_CRITICAL();
+}
+
+/**
+   @brief obtiene una copia consistente de los timestamps de una tecla, sin secciones criticas.
+          Se copia el buffer publicado (seq & 1); si durante la copia task_tecla publico una
+          nueva version, seq cambia y se vuelve a copiar. La tarea lectora nunca espera a que
+          termine una escritura, porque task_tecla escribe siempre en el otro buffer.
+
+   @param index
+   @param times
+ */
+void keys_get_times( uint32_t index, t_key_times* times )
+{
+    uint32_t seq;
+
+    do
+    {
+        seq = keys_data[index].seq;
+        KEYS_BARRIER();
+        *times = keys_data[index].times[seq & 1];
+        KEYS_BARRIER();
+    }
+    while( seq != keys_data[index].seq );
 }
 
 
@@ -106,6 +125,9 @@ void keys_Init( void )
         keys_data[i].time_down      = KEYS_INVALID_TIME;
         keys_data[i].time_up        = KEYS_INVALID_TIME;
         keys_data[i].time_diff      = KEYS_INVALID_TIME;
+        keys_data[i].seq            = 0;
+        keys_data[i].times[0].time_down = KEYS_INVALID_TIME;
+        keys_data[i].times[0].time_up   = KEYS_INVALID_TIME;
 
         //keys_data[i].pressed_signal = xSemaphoreCreateBinary();
 
@@ -183,9 +205,8 @@ static void buttonPressed( t_key_isr_signal* event_data )
     uint32_t index = event_data->tecla;
 
     //internal event
-    taskENTER_CRITICAL();
     keys_data[index].time_down = event_data->event_time;
-    taskEXIT_CRITICAL();
+    keys_publish_times( index );
 
     //user event
     user_buttonPressed( event_data );
@@ -196,15 +217,31 @@ static void buttonReleased( t_key_isr_signal* event_data )
 {
     uint32_t index = event_data->tecla;
     //internal event
-    taskENTER_CRITICAL();
     keys_data[index].time_up    = event_data->event_time;
     keys_data[index].time_diff  = keys_data[index].time_up - keys_data[index].time_down;
-    taskEXIT_CRITICAL();
+    keys_publish_times( index );
 
     //user event
     user_buttonReleased( event_data );
 }
 
+/**
+   @brief publica time_down/time_up para los lectores de keys_get_times.
+          Solo task_tecla escribe: completa el buffer que no esta publicado y recien
+          despues incrementa seq, que lo convierte en el buffer vigente.
+
+   @param index
+ */
+static void keys_publish_times( uint32_t index )
+{
+    uint32_t seq = keys_data[index].seq + 1;
+
+    keys_data[index].times[seq & 1].time_down   = keys_data[index].time_down;
+    keys_data[index].times[seq & 1].time_up     = keys_data[index].time_up;
+    KEYS_BARRIER();
+    keys_data[index].seq = seq;
+}
+
 /*=====[Implementations of private functions]=================================*/
 void task_tecla( void* taskParmPtr )
 {
@@ -54,6 +54,11 @@ extern uint32_t SystemCoreClock;
 extern int DbgConsole_Printf( const char *fmt_s, ... );
 #endif
 
+/* lo usa portCONFIGURE_TIMER_FOR_RUN_TIME_STATS con cualquier compilador, incluido GCC */
+#if defined( __ICCARM__ ) || defined( __CC_ARM ) || defined( __GNUC__ )
+void cpu_stats_timer_init( void );
+#endif
+
 
 #define configSUPPORT_STATIC_ALLOCATION              1
 
@@ -78,10 +83,14 @@ extern int DbgConsole_Printf( const char *fmt_s, ... );
 #define configUSE_MALLOC_FAILED_HOOK                 1
 #define configUSE_APPLICATION_TASK_TAG               0
 #define configUSE_COUNTING_SEMAPHORES                1
-#define configGENERATE_RUN_TIME_STATS                0
+#define configGENERATE_RUN_TIME_STATS                1
 #define configOVERRIDE_DEFAULT_TICK_CONFIGURATION    1
 #define configRECORD_STACK_HIGH_ADDRESS              1
 
+/* Run time stats: se cuentan ciclos del CPU con el DWT (ver cpu_stats.c) */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()     cpu_stats_timer_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()             ( DWT->CYCCNT )
+
 // Add old API compatibility
 #define configENABLE_BACKWARD_COMPATIBILITY          1
 
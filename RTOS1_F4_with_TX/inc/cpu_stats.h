@@ -0,0 +1,68 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CPU_STATS_H_
+#define CPU_STATS_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "sapi.h"
+
+/* public macros ================================================================= */
+#define CPU_STATS_MAX_TASKS     8       //tareas que se siguen (las demas se ignoran)
+#define CPU_STATS_WINDOW_MS     1000    //cada ventana; menor a 2^32 ciclos (21 s a 204 MHz)
+#define CPU_STATS_WINDOWS       10      //ventanas que promedia el valor "largo"
+#define CPU_STATS_REPORT_SIZE   320
+
+/* tiempo de interrupciones: se encierra el cuerpo de cada ISR que se quiera medir.
+   No admite anidamiento: sirve para ISRs de la misma prioridad. El tiempo tambien
+   queda imputado a la tarea interrumpida (FreeRTOS no lo separa). */
+extern volatile uint32_t cpu_stats_isr_cycles;
+
+#define CPU_STATS_ISR_ENTER()   uint32_t cpu_stats_isr_t0 = DWT->CYCCNT
+#define CPU_STATS_ISR_EXIT()    cpu_stats_isr_cycles += DWT->CYCCNT - cpu_stats_isr_t0
+
+/* types ================================================================= */
+typedef struct
+{
+    const char* name;
+    uint16_t    last;           //% de CPU en la ultima ventana, en decimas
+    uint16_t    avg;            //% de CPU en las ultimas CPU_STATS_WINDOWS ventanas, en decimas
+} t_cpu_stats_task;
+
+/* methods ================================================================= */
+void cpu_stats_timer_init( void );
+void cpu_stats_Init( void );
+uint16_t cpu_stats_report( char* buffer, uint16_t size );
+
+#endif /* CPU_STATS_H_ */
@@ -37,5 +37,6 @@ void procotol_x_init( uartMap_t uart, uint32_t baudRate );
 void protocol_wait_frame();
 void protocol_get_frame_ref( char** data, uint16_t* size );
 void protocol_discard_frame();
+void protocol_transmit_frame( char* data, uint16_t size );
 
 #endif
\ No newline at end of file
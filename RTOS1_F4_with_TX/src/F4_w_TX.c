@@ -35,6 +35,8 @@
 #include "sapi.h"
 
 #include "semphr.h"
+#include "protocol.h"
+#include "cpu_stats.h"
 
 
 
@@ -51,10 +53,20 @@ void wait_frame( void* pvParameters )
 
         protocol_get_frame_ref( &data, &size );
 
-        int a = sprintf( &data[size], " %u\n", frame_counter );
+        if( size == 3 && data[1] == 'S' )
+        {
+            /* ">S<": consulta de uso de CPU por tarea */
+            static char report[CPU_STATS_REPORT_SIZE];
 
-        /* envio respuesta */
-        protocol_transmit_frame( data, size + a );
+            protocol_transmit_frame( report, cpu_stats_report( report, sizeof( report ) ) );
+        }
+        else
+        {
+            int a = sprintf( &data[size], " %u\n", frame_counter );
+
+            /* envio respuesta */
+            protocol_transmit_frame( data, size + a );
+        }
 
         protocol_discard_frame();
 
@@ -84,6 +96,9 @@ int main( void )
         0                             // Puntero a la tarea creada en el sistema
     );
 
+    /* uso de CPU por ventanas; se consulta con el frame ">S<" */
+    cpu_stats_Init();
+
     vTaskStartScheduler();
 
     return 0;
@@ -0,0 +1,219 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ * This file is part of sAPI Library.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[ Inclusions ]============================================*/
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sapi.h"
+#include "cpu_stats.h"
+
+/*=====[Definition macros of private constants]==============================*/
+#define CPU_STATS_ISR_SLOT      CPU_STATS_MAX_TASKS      //ultima fila de la historia: interrupciones
+
+/*=====[Definitions of private global variables]=============================*/
+static TaskStatus_t     status[CPU_STATS_MAX_TASKS];
+
+/* ciclos por ventana de cada tarea (por xTaskNumber, de 1 a CPU_STATS_MAX_TASKS) y de las ISRs */
+static uint32_t         history[CPU_STATS_MAX_TASKS + 1][CPU_STATS_WINDOWS];
+static uint32_t         history_total[CPU_STATS_WINDOWS];
+static uint32_t         previous[CPU_STATS_MAX_TASKS + 1];
+static uint32_t         previous_total;
+static uint32_t         window;     //ventana en curso dentro de la historia
+
+static t_cpu_stats_task results[CPU_STATS_MAX_TASKS + 1];
+static uint32_t         cost_cycles;        //ciclos de la ultima actualizacion
+static uint32_t         isr_overhead;       //ciclos de un par ENTER/EXIT vacio
+
+/*=====[Definitions of public global variables]==============================*/
+volatile uint32_t cpu_stats_isr_cycles;
+
+/*=====[prototype of private functions]=================================*/
+static void cpu_stats_update( void );
+static void task_cpu_stats( void* taskParmPtr );
+
+/*=====[Implementations of public functions]=================================*/
+
+/* portCONFIGURE_TIMER_FOR_RUN_TIME_STATS: el reloj de las estadisticas es el contador de
+   ciclos del DWT, que no genera interrupciones y se lee con un solo acceso */
+void cpu_stats_timer_init( void )
+{
+    cyclesCounterInit( SystemCoreClock );
+}
+
+void cpu_stats_Init( void )
+{
+    BaseType_t res;
+
+    /* costo propio de la instrumentacion de ISRs: un par ENTER/EXIT vacio.
+       Se mide antes de arrancar el scheduler, sin otras ISRs instrumentadas corriendo */
+    cyclesCounterInit( SystemCoreClock );
+    {
+        CPU_STATS_ISR_ENTER();
+        CPU_STATS_ISR_EXIT();
+        isr_overhead = cpu_stats_isr_cycles;
+        cpu_stats_isr_cycles = 0;
+    }
+
+    res = xTaskCreate (
+              task_cpu_stats,				// Funcion de la tarea a ejecutar
+              ( const char * )"cpu_stats",	// Nombre de la tarea como String amigable para el usuario
+              configMINIMAL_STACK_SIZE*2,	// Cantidad de stack de la tarea
+              0,							// Parametros de tarea
+              configMAX_PRIORITIES-1,		// Prioridad de la tarea: la ventana se cierra a tiempo
+              0							// Puntero a la tarea creada en el sistema
+          );
+
+    // Gestión de errores
+    configASSERT( res == pdPASS );
+}
+
+/**
+   @brief arma un reporte de texto con el uso de CPU de cada tarea, de las interrupciones
+          y el costo de la instrumentacion. Solo lee la ultima ventana calculada.
+
+   @param buffer
+   @param size
+   @return cantidad de caracteres escritos
+ */
+uint16_t cpu_stats_report( char* buffer, uint16_t size )
+{
+    int n = 0;
+
+    n += snprintf( &buffer[n], size - n, "tarea %u ms(%%) %u ms(%%)\n", CPU_STATS_WINDOW_MS, CPU_STATS_WINDOW_MS * CPU_STATS_WINDOWS );
+
+    vTaskSuspendAll();
+
+    for( int i = 0; i <= CPU_STATS_MAX_TASKS && n < size; i++ )
+    {
+        if( results[i].name != NULL )
+        {
+            n += snprintf( &buffer[n], size - n, "%s %u.%u %u.%u\n", results[i].name,
+                           results[i].last / 10, results[i].last % 10,
+                           results[i].avg / 10, results[i].avg % 10 );
+        }
+    }
+
+    if( n < size )
+    {
+        n += snprintf( &buffer[n], size - n, "costo %u ciclos/ventana, %u ciclos/isr\n", cost_cycles, isr_overhead );
+    }
+
+    xTaskResumeAll();
+
+    return ( n < size ) ? n : size - 1;
+}
+
+/*=====[Implementations of private functions]================================*/
+
+/* decimas de porcentaje de part sobre total, sin desbordar 32 bits */
+static uint16_t cpu_stats_permille( uint64_t part, uint64_t total )
+{
+    return total ? ( uint16_t )( ( part * 1000 ) / total ) : 0;
+}
+
+/**
+   @brief cierra una ventana: toma los contadores de FreeRTOS, guarda la diferencia con
+          la ventana anterior y recalcula los porcentajes de la ultima ventana y de las
+          ultimas CPU_STATS_WINDOWS. Las diferencias son modulo 2^32, por lo que el
+          desborde del contador de ciclos no afecta mientras la ventana dure menos que
+          una vuelta completa.
+ */
+static void cpu_stats_update( void )
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t total;
+    uint64_t sum;
+    uint64_t sum_total;
+    uint32_t isr;
+    UBaseType_t n;
+    UBaseType_t slot;
+
+    n = uxTaskGetSystemState( status, CPU_STATS_MAX_TASKS, &total );
+
+    history_total[window] = total - previous_total;
+    previous_total = total;
+
+    for( UBaseType_t i = 0; i < n; i++ )
+    {
+        slot = status[i].xTaskNumber - 1;
+        if( slot >= CPU_STATS_MAX_TASKS )
+        {
+            continue;
+        }
+
+        history[slot][window] = status[i].ulRunTimeCounter - previous[slot];
+        previous[slot] = status[i].ulRunTimeCounter;
+        results[slot].name = status[i].pcTaskName;
+    }
+
+    isr = cpu_stats_isr_cycles;
+    history[CPU_STATS_ISR_SLOT][window] = isr - previous[CPU_STATS_ISR_SLOT];
+    previous[CPU_STATS_ISR_SLOT] = isr;
+    results[CPU_STATS_ISR_SLOT].name = "ISR";
+
+    sum_total = 0;
+    for( int w = 0; w < CPU_STATS_WINDOWS; w++ )
+    {
+        sum_total += history_total[w];
+    }
+
+    for( int s = 0; s <= CPU_STATS_MAX_TASKS; s++ )
+    {
+        sum = 0;
+        for( int w = 0; w < CPU_STATS_WINDOWS; w++ )
+        {
+            sum += history[s][w];
+        }
+
+        results[s].last = cpu_stats_permille( history[s][window], history_total[window] );
+        results[s].avg  = cpu_stats_permille( sum, sum_total );
+    }
+
+    window = ( window + 1 ) % CPU_STATS_WINDOWS;
+
+    cost_cycles = DWT->CYCCNT - start;
+}
+
+static void task_cpu_stats( void* taskParmPtr )
+{
+    TickType_t xLastWakeTime = xTaskGetTickCount();
+
+    while( 1 )
+    {
+        vTaskDelayUntil( &xLastWakeTime, pdMS_TO_TICKS( CPU_STATS_WINDOW_MS ) );
+        cpu_stats_update();
+    }
+}
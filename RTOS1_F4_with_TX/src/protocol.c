@@ -34,6 +34,7 @@
 #include "FreeRTOSConfig.h"
 #include "protocol.h"
 #include "semphr.h"
+#include "cpu_stats.h"
 
 #define FRAME_MAX_SIZE  200
 
@@ -52,6 +53,7 @@ uint16_t counter_tx;
 
 void protocol_tx_event( void *noUsado )
 {
+    CPU_STATS_ISR_ENTER();
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
     uartTxWrite( uart_used, buffer_tx[counter_tx] );
 
@@ -65,11 +67,13 @@ void protocol_tx_event( void *noUsado )
         xSemaphoreGiveFromISR( sem_tx, &xHigherPriorityTaskWoken );
     }
 
+    CPU_STATS_ISR_EXIT();
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
 void protocol_rx_event( void *noUsado )
 {
+    CPU_STATS_ISR_ENTER();
     ( void* ) noUsado;
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
@@ -145,6 +149,7 @@ void protocol_rx_event( void *noUsado )
         xSemaphoreGiveFromISR( mutex, &xHigherPriorityTaskWoken );
     }
 
+    CPU_STATS_ISR_EXIT();
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
@@ -0,0 +1,13 @@
+# Compile options
+VERBOSE=n
+OPT=g
+USE_NANO=y
+SEMIHOST=n
+USE_FPU=y
+
+# Libraries
+USE_LPCOPEN=y
+USE_SAPI=y
+USE_FREERTOS=y
+FREERTOS_HEAP_TYPE=1
+LOAD_INRAM=n
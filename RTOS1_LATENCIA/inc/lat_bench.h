@@ -0,0 +1,111 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef LAT_BENCH_H_
+#define LAT_BENCH_H_
+
+/*==================[inlcusiones]============================================*/
+#include <stdint.h>
+#include "sapi.h"
+
+/*==================[definiciones y macros]==================================*/
+/* Banco de medicion de la latencia flanco -> ISR -> tarea, el mismo camino que recorre una
+   tecla en keys.c (GPIO0_IRQHandler -> xSemaphoreGiveFromISR -> task_tecla).
+
+   El TIMER1 genera un evento cada LAT_PERIODO_US. Su ISR dispara la interrupcion de PININT0
+   (GPIO0_IRQHandler), que despierta a una tarea con el mecanismo de señalizacion bajo prueba.
+   Todo se mide con el contador de ciclos del DWT:
+
+       evento      instante del match del TIMER1 (reconstruido con su contador, que cuenta
+                   ciclos de CPU desde el match)
+       isr         primera instruccion de GPIO0_IRQHandler
+       senal       luego de la llamada FromISR (costo de la señalizacion dentro de la ISR)
+       tarea       primera instruccion de la tarea luego de desbloquearse
+
+   El periodo no es multiplo del tick, asi que los eventos barren todas las fases del tick
+   y de la carga de fondo. */
+
+#define LAT_LOOPBACK        0       // 0: la ISR del timer pone pendiente PIN_INT0 por software
+                                    // 1: la ISR del timer conmuta LAT_PIN_OUT, que vuelve por un
+                                    //    cable a LAT_PIN_IN (PININT0, ambos flancos)
+#define LAT_PIN_OUT         GPIO0   // P6_1 en la EDU-CIAA
+#define LAT_PIN_IN          GPIO1   // P6_4 en la EDU-CIAA
+
+#define LAT_PERIODO_US      997     // primo: no queda enganchado con el tick de 1 ms
+#define LAT_MUESTRAS        2000    // muestras por corrida
+
+#define LAT_HIST_BIN        64      // ancho de cada barra del histograma, en ciclos
+#define LAT_HIST_BINS       32      // barras; la ultima acumula todo lo que no entra
+
+/*==================[tipos de datos]=========================================*/
+typedef enum
+{
+    LAT_SEMAFORO,                   // semaforo binario, como keys.c
+    LAT_NOTIFICACION,               // notificacion directa a la tarea
+    LAT_COLA,                       // cola de 1 elemento que transporta el timestamp de la ISR
+    LAT_MECANISMOS
+} t_lat_mecanismo;
+
+typedef enum
+{
+    LAT_EVENTO_ISR,                 // evento -> isr
+    LAT_COSTO_SENAL,                // isr -> senal
+    LAT_ISR_TAREA,                  // isr -> tarea
+    LAT_TOTAL,                      // evento -> tarea
+    LAT_TRAMOS
+} t_lat_tramo;
+
+typedef struct
+{
+    uint32_t min;
+    uint32_t max;
+    uint64_t suma;
+    uint32_t hist[LAT_HIST_BINS];
+} t_lat_stat;
+
+typedef struct
+{
+    t_lat_mecanismo mecanismo;
+    uint32_t        muestras;
+    uint32_t        perdidas;       // eventos descartados porque la tarea no termino con el anterior
+    t_lat_stat      tramo[LAT_TRAMOS];
+} t_lat_corrida;
+
+/*==================[prototipos de funciones]================================*/
+void     lat_bench_Init( void );
+void     lat_bench_run( t_lat_mecanismo mecanismo, t_lat_corrida* corrida );
+void     lat_bench_report( const t_lat_corrida* corrida, const char* escenario );
+uint32_t lat_bench_percentil( const t_lat_stat* stat, uint32_t n, uint32_t por_mil );
+const char* lat_bench_nombre( t_lat_mecanismo mecanismo );
+uint32_t lat_ns( uint32_t ciclos );
+
+#endif /* LAT_BENCH_H_ */
@@ -0,0 +1,439 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[inlcusiones]============================================*/
+#include <stdio.h>
+#include <string.h>
+#include "sapi.h"
+#include "FreeRTOS.h"
+#include "FreeRTOSConfig.h"
+#include "task.h"
+#include "semphr.h"
+#include "queue.h"
+
+#include "lat_bench.h"
+
+/*==================[definiciones y macros]==================================*/
+#define LAT_TIMER           LPC_TIMER1
+#define LAT_TIMER_CLOCK     CLK_MX_TIMER1
+#define LAT_TIMER_IRQ       TIMER1_IRQn
+
+#define LAT_BARRA_MAX       40      // caracteres de la barra mas larga del histograma
+
+/*==================[definiciones de datos internos]=========================*/
+static SemaphoreHandle_t lat_semaforo;
+static QueueHandle_t     lat_cola;
+static TaskHandle_t      lat_esperas[LAT_MECANISMOS];
+static TaskHandle_t      lat_control;               // tarea bloqueada en lat_bench_run
+
+static volatile t_lat_mecanismo lat_activo;         // LAT_MECANISMOS: ninguno, la ISR no señaliza
+static volatile bool_t   lat_pendiente;             // hay un evento en vuelo
+static volatile uint32_t lat_t_evento;
+static volatile uint32_t lat_t_isr;
+static volatile uint32_t lat_t_senal;
+
+static t_lat_corrida*    lat_corrida;
+
+#if LAT_LOOPBACK==1
+extern pinInitGpioLpc4337_t gpioPinsInit[];
+
+static uint8_t lat_out_port;
+static uint8_t lat_out_pin;
+#endif
+
+static const char* const lat_nombres[LAT_MECANISMOS] = { "semaforo", "notificacion", "cola" };
+static const char* const lat_tramos[LAT_TRAMOS] = { "evento->isr", "isr->senal", "isr->tarea", "evento->tarea" };
+
+/*==================[declaraciones de funciones internas]====================*/
+static void lat_tarea_espera( void* taskParmPtr );
+static void lat_muestra( uint32_t t_isr, uint32_t t_tarea );
+static void lat_acumular( t_lat_stat* stat, uint32_t ciclos );
+
+/*==================[definiciones de funciones internas]=====================*/
+
+/* Una tarea por mecanismo, todas a la maxima prioridad: solo la del mecanismo activo recibe
+   señales, las otras quedan bloqueadas. El timestamp se toma apenas vuelve la llamada
+   bloqueante, antes de cualquier otra cosa. */
+static void lat_tarea_espera( void* taskParmPtr )
+{
+    t_lat_mecanismo mecanismo = ( t_lat_mecanismo )( uint32_t ) taskParmPtr;
+    uint32_t t_isr;
+    uint32_t t_tarea;
+
+    while( 1 )
+    {
+        switch( mecanismo )
+        {
+            case LAT_SEMAFORO:
+                xSemaphoreTake( lat_semaforo, portMAX_DELAY );
+                t_tarea = DWT->CYCCNT;
+                t_isr = lat_t_isr;
+                break;
+
+            case LAT_NOTIFICACION:
+                ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+                t_tarea = DWT->CYCCNT;
+                t_isr = lat_t_isr;
+                break;
+
+            default:
+                /* la cola transporta el timestamp, como transportaria el dato de un driver */
+                xQueueReceive( lat_cola, &t_isr, portMAX_DELAY );
+                t_tarea = DWT->CYCCNT;
+                break;
+        }
+
+        lat_muestra( t_isr, t_tarea );
+    }
+}
+
+static void lat_muestra( uint32_t t_isr, uint32_t t_tarea )
+{
+    t_lat_corrida* corrida = lat_corrida;
+
+    lat_acumular( &corrida->tramo[LAT_EVENTO_ISR],  t_isr - lat_t_evento );
+    lat_acumular( &corrida->tramo[LAT_COSTO_SENAL], lat_t_senal - t_isr );
+    lat_acumular( &corrida->tramo[LAT_ISR_TAREA],   t_tarea - t_isr );
+    lat_acumular( &corrida->tramo[LAT_TOTAL],       t_tarea - lat_t_evento );
+
+    if( ++corrida->muestras == LAT_MUESTRAS )
+    {
+        /* se detiene el timer antes de liberar el evento: no entra ninguno mas */
+        Chip_TIMER_Disable( LAT_TIMER );
+        lat_activo = LAT_MECANISMOS;
+        xTaskNotifyGive( lat_control );
+    }
+
+    lat_pendiente = FALSE;
+}
+
+static void lat_acumular( t_lat_stat* stat, uint32_t ciclos )
+{
+    uint32_t bin = ciclos / LAT_HIST_BIN;
+
+    if( bin >= LAT_HIST_BINS )
+    {
+        bin = LAT_HIST_BINS - 1;
+    }
+
+    stat->hist[bin]++;
+    stat->suma += ciclos;
+
+    if( ciclos < stat->min )
+    {
+        stat->min = ciclos;
+    }
+    if( ciclos > stat->max )
+    {
+        stat->max = ciclos;
+    }
+}
+
+/*==================[definiciones de funciones externas]=====================*/
+
+/**
+   @brief   Crea las primitivas de señalizacion y las tareas que esperan, y configura el TIMER1
+            y la PININT0. Llamar desde main, luego de cpu_load_Init (que arranca el contador
+            de ciclos) y antes de vTaskStartScheduler.
+ */
+void lat_bench_Init( void )
+{
+    BaseType_t res;
+
+    lat_semaforo = xSemaphoreCreateBinary();
+    lat_cola = xQueueCreate( 1, sizeof( uint32_t ) );
+
+    configASSERT( lat_semaforo != NULL );
+    configASSERT( lat_cola != NULL );
+
+    lat_activo = LAT_MECANISMOS;
+
+    for( uint32_t m = 0; m < LAT_MECANISMOS; m++ )
+    {
+        res = xTaskCreate(
+                  lat_tarea_espera,                 // Funcion de la tarea a ejecutar
+                  lat_nombres[m],                   // Nombre de la tarea como String amigable para el usuario
+                  configMINIMAL_STACK_SIZE*2,       // Cantidad de stack de la tarea
+                  ( void* ) m,                      // Parametros de tarea
+                  configMAX_PRIORITIES-1,           // Prioridad de la tarea: la maxima del sistema
+                  &lat_esperas[m]                   // Puntero a la tarea creada en el sistema
+              );
+
+        configASSERT( res == pdPASS );
+    }
+
+    /* el TIMER1 cuenta ciclos de CPU y se reinicia en el match: en su ISR, el contador dice
+       cuantos ciclos pasaron desde el evento */
+    configASSERT( Chip_Clock_GetRate( LAT_TIMER_CLOCK ) == SystemCoreClock );
+
+    Chip_TIMER_Init( LAT_TIMER );
+    Chip_TIMER_Disable( LAT_TIMER );
+    Chip_TIMER_Reset( LAT_TIMER );
+    Chip_TIMER_PrescaleSet( LAT_TIMER, 0 );
+    Chip_TIMER_SetMatch( LAT_TIMER, 0, LAT_PERIODO_US * ( SystemCoreClock / 1000000 ) - 1 );
+    Chip_TIMER_ResetOnMatchEnable( LAT_TIMER, 0 );
+    Chip_TIMER_MatchEnableInt( LAT_TIMER, 0 );
+
+    /* un nivel por debajo de la PININT: la ISR del timer queda enmascarada por las secciones
+       criticas como cualquier otra, y la PININT la interrumpe apenas se dispara */
+    NVIC_SetPriority( LAT_TIMER_IRQ, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1 );
+    NVIC_ClearPendingIRQ( LAT_TIMER_IRQ );
+    NVIC_EnableIRQ( LAT_TIMER_IRQ );
+
+#if LAT_LOOPBACK==1
+    gpioInit( LAT_PIN_OUT, GPIO_OUTPUT );
+    gpioInit( LAT_PIN_IN, GPIO_INPUT );
+
+    lat_out_port = gpioPinsInit[LAT_PIN_OUT].gpio.port;
+    lat_out_pin  = gpioPinsInit[LAT_PIN_OUT].gpio.pin;
+
+    Chip_PININT_Init( LPC_GPIO_PIN_INT );
+    Chip_SCU_GPIOIntPinSel( 0, gpioPinsInit[LAT_PIN_IN].gpio.port, gpioPinsInit[LAT_PIN_IN].gpio.pin );
+    Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH0 );
+    Chip_PININT_SetPinModeEdge( LPC_GPIO_PIN_INT, PININTCH0 );
+    Chip_PININT_EnableIntLow( LPC_GPIO_PIN_INT, PININTCH0 );
+    Chip_PININT_EnableIntHigh( LPC_GPIO_PIN_INT, PININTCH0 );
+#endif
+
+    /* la misma prioridad que las teclas en keys.c */
+    NVIC_SetPriority( PIN_INT0_IRQn, configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY );
+    NVIC_ClearPendingIRQ( PIN_INT0_IRQn );
+    NVIC_EnableIRQ( PIN_INT0_IRQn );
+}
+
+/**
+   @brief   Mide LAT_MUESTRAS eventos con el mecanismo indicado y bloquea a la tarea que
+            llama hasta terminar. Mientras tanto corre todo lo que tenga menor prioridad que
+            las tareas de espera, que es la carga del escenario.
+
+   @param mecanismo
+   @param corrida   donde se dejan los resultados
+ */
+void lat_bench_run( t_lat_mecanismo mecanismo, t_lat_corrida* corrida )
+{
+    memset( corrida, 0, sizeof( *corrida ) );
+    corrida->mecanismo = mecanismo;
+
+    for( uint32_t t = 0; t < LAT_TRAMOS; t++ )
+    {
+        corrida->tramo[t].min = UINT32_MAX;
+    }
+
+    lat_corrida   = corrida;
+    lat_control   = xTaskGetCurrentTaskHandle();
+    lat_pendiente = FALSE;
+    lat_activo    = mecanismo;
+
+    Chip_TIMER_Reset( LAT_TIMER );
+    Chip_TIMER_Enable( LAT_TIMER );
+
+    ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+}
+
+/**
+   @brief   Percentil de un tramo, redondeado hacia arriba al borde de su barra del histograma.
+            Si cae en la ultima barra (la que acumula el resto) devuelve el maximo.
+
+   @param stat
+   @param n         cantidad de muestras
+   @param por_mil   500 para la mediana, 990 para el p99, 999 para el p99.9
+   @return          ciclos
+ */
+uint32_t lat_bench_percentil( const t_lat_stat* stat, uint32_t n, uint32_t por_mil )
+{
+    uint32_t objetivo = ( n * por_mil + 999 ) / 1000;
+    uint32_t acumulado = 0;
+
+    for( uint32_t bin = 0; bin < LAT_HIST_BINS - 1; bin++ )
+    {
+        acumulado += stat->hist[bin];
+
+        if( acumulado >= objetivo )
+        {
+            uint32_t borde = ( bin + 1 ) * LAT_HIST_BIN - 1;
+            return ( borde < stat->max ) ? borde : stat->max;
+        }
+    }
+
+    return stat->max;
+}
+
+const char* lat_bench_nombre( t_lat_mecanismo mecanismo )
+{
+    return ( mecanismo < LAT_MECANISMOS ) ? lat_nombres[mecanismo] : "?";
+}
+
+/* ciclos del DWT a ns, en 64 bits: ciclos * 1000 en 32 bits desborda pasados los 21 ms a 204 MHz */
+uint32_t lat_ns( uint32_t ciclos )
+{
+    return ( uint32_t )( ( uint64_t ) ciclos * 1000000000ULL / SystemCoreClock );
+}
+
+/**
+   @brief   Imprime los resultados de una corrida: cada tramo en ciclos, el total tambien en
+            ns, y el histograma del total.
+ */
+void lat_bench_report( const t_lat_corrida* corrida, const char* escenario )
+{
+    const t_lat_stat* total = &corrida->tramo[LAT_TOTAL];
+    uint32_t n = corrida->muestras;
+    uint32_t pico = 0;
+    uint32_t primero = LAT_HIST_BINS;
+    uint32_t ultimo = 0;
+
+    printf( "\r\n== %s, %s: %u muestras, %u perdidas, %s\r\n", lat_bench_nombre( corrida->mecanismo ), escenario,
+            n, corrida->perdidas, ( LAT_LOOPBACK == 1 ) ? "loopback" : "pendiente por software" );
+
+    if( n == 0 )
+    {
+        return;
+    }
+
+    printf( "%-14s %7s %7s %7s %7s %7s %7s\r\n", "tramo (ciclos)", "min", "prom", "p50", "p99", "p99.9", "max" );
+
+    for( uint32_t t = 0; t < LAT_TRAMOS; t++ )
+    {
+        const t_lat_stat* s = &corrida->tramo[t];
+
+        printf( "%-14s %7u %7u %7u %7u %7u %7u\r\n", lat_tramos[t], s->min, ( uint32_t )( s->suma / n ),
+                lat_bench_percentil( s, n, 500 ), lat_bench_percentil( s, n, 990 ),
+                lat_bench_percentil( s, n, 999 ), s->max );
+    }
+
+    printf( "%-14s %7u %7u %7u %7u %7u %7u\r\n", "total (ns)", lat_ns( total->min ),
+            lat_ns( ( uint32_t )( total->suma / n ) ), lat_ns( lat_bench_percentil( total, n, 500 ) ),
+            lat_ns( lat_bench_percentil( total, n, 990 ) ), lat_ns( lat_bench_percentil( total, n, 999 ) ),
+            lat_ns( total->max ) );
+
+    for( uint32_t bin = 0; bin < LAT_HIST_BINS; bin++ )
+    {
+        if( total->hist[bin] != 0 )
+        {
+            if( bin < primero )
+            {
+                primero = bin;
+            }
+            ultimo = bin;
+        }
+        if( total->hist[bin] > pico )
+        {
+            pico = total->hist[bin];
+        }
+    }
+
+    printf( "histograma %s (ciclos):\r\n", lat_tramos[LAT_TOTAL] );
+
+    for( uint32_t bin = primero; bin <= ultimo; bin++ )
+    {
+        uint32_t largo = ( total->hist[bin] * LAT_BARRA_MAX + pico - 1 ) / pico;
+
+        if( bin == LAT_HIST_BINS - 1 )
+        {
+            printf( "%5u-     ", bin * LAT_HIST_BIN );
+        }
+        else
+        {
+            printf( "%5u-%-5u", bin * LAT_HIST_BIN, ( bin + 1 ) * LAT_HIST_BIN - 1 );
+        }
+
+        printf( "|" );
+        for( uint32_t i = 0; i < largo; i++ )
+        {
+            printf( "#" );
+        }
+        printf( " %u\r\n", total->hist[bin] );
+    }
+}
+
+/*==================[handlers de interrupcion]===============================*/
+
+/* Evento: se reconstruye el instante del match y se dispara la PININT0. Si la tarea todavia
+   no termino con el evento anterior, este se descarta (no se pueden encimar timestamps). */
+void TIMER1_IRQHandler( void )
+{
+    uint32_t desde_match = Chip_TIMER_ReadCount( LAT_TIMER );
+    uint32_t ahora = DWT->CYCCNT;
+
+    Chip_TIMER_ClearMatch( LAT_TIMER, 0 );
+
+    if( lat_pendiente )
+    {
+        lat_corrida->perdidas++;
+        return;
+    }
+
+    lat_t_evento  = ahora - desde_match;
+    lat_pendiente = TRUE;
+
+#if LAT_LOOPBACK==1
+    Chip_GPIO_SetPinToggle( LPC_GPIO_PORT, lat_out_port, lat_out_pin );
+#else
+    NVIC_SetPendingIRQ( PIN_INT0_IRQn );
+#endif
+}
+
+/* El mismo camino que keys.c: timestamp, señal FromISR y cambio de contexto a la salida */
+void GPIO0_IRQHandler( void )
+{
+    uint32_t t_isr = DWT->CYCCNT;
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+#if LAT_LOOPBACK==1
+    Chip_PININT_ClearIntStatus( LPC_GPIO_PIN_INT, PININTCH0 );
+#endif
+
+    lat_t_isr = t_isr;
+
+    switch( lat_activo )
+    {
+        case LAT_SEMAFORO:
+            xSemaphoreGiveFromISR( lat_semaforo, &xHigherPriorityTaskWoken );
+            break;
+
+        case LAT_NOTIFICACION:
+            vTaskNotifyGiveFromISR( lat_esperas[LAT_NOTIFICACION], &xHigherPriorityTaskWoken );
+            break;
+
+        case LAT_COLA:
+            xQueueSendFromISR( lat_cola, &t_isr, &xHigherPriorityTaskWoken );
+            break;
+
+        default:
+            break;
+    }
+
+    lat_t_senal = DWT->CYCCNT;
+
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+/*==================[fin del archivo]========================================*/
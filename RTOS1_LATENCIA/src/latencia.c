@@ -0,0 +1,252 @@
+/* Copyright 2020, Franco Bucafusco
+ * All rights reserved.
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*==================[inlcusiones]============================================*/
+
+// Includes de FreeRTOS
+#include <stdio.h>
+#include "sapi.h"
+#include "FreeRTOS.h"
+#include "FreeRTOSConfig.h"
+
+#include "task.h"
+#include "cpu_load.h"
+#include "lat_bench.h"
+
+/*==================[definiciones y macros]==================================*/
+
+/* carga de fondo del escenario "con carga": una tarea por perfil de cpu_load, que juntas
+   ocupan el 100% de la CPU libre, y una que cada tanto enmascara interrupciones como lo
+   haria un driver con una seccion critica larga */
+#define CARGA_TAREAS            CPU_LOAD_PROFILES
+#define CARGA_RAFAGA_US         1000
+#define CARGA_CRITICA_US        20      // 0: sin secciones criticas
+#define CARGA_CRITICA_PERIODO   7       // ms
+
+#define PAUSA_ENTRE_CICLOS_MS   5000
+
+/*==================[definiciones de datos internos]=========================*/
+typedef enum
+{
+    ESCENARIO_SIN_CARGA,
+    ESCENARIO_CON_CARGA,
+    ESCENARIOS
+} t_escenario;
+
+static const char* const escenarios[ESCENARIOS] = { "sin carga", "con carga" };
+
+static TaskHandle_t carga_handles[CARGA_TAREAS + 1];
+static uint32_t     carga_n;
+
+static t_lat_corrida resultados[ESCENARIOS][LAT_MECANISMOS];
+
+/*==================[definiciones de datos externos]=========================*/
+
+/*==================[declaraciones de funciones internas]====================*/
+static void carga_habilitar( bool_t habilitar );
+static void imprimir_comparacion( void );
+
+/*==================[declaraciones de funciones externas]====================*/
+
+// Prototipo de funcion de la tarea
+void tarea_control( void* taskParmPtr );
+void tarea_carga( void* taskParmPtr );
+void tarea_carga_critica( void* taskParmPtr );
+
+/*==================[funcion principal]======================================*/
+
+// FUNCION PRINCIPAL, PUNTO DE ENTRADA AL PROGRAMA LUEGO DE ENCENDIDO O RESET.
+int main( void )
+{
+    BaseType_t res;
+
+    // ---------- CONFIGURACIONES ------------------------------
+    boardConfig();
+
+    printf( "Latencia flanco -> ISR -> tarea\r\n" );
+
+    cpu_load_Init();                    // calibra la carga y arranca el contador de ciclos
+    lat_bench_Init();
+
+    for( uint32_t i = 0; i < CARGA_TAREAS; i++ )
+    {
+        res = xTaskCreate(
+                  tarea_carga,                      // Funcion de la tarea a ejecutar
+                  ( const char * )"carga",          // Nombre de la tarea como String amigable para el usuario
+                  configMINIMAL_STACK_SIZE*2,       // Cantidad de stack de la tarea
+                  ( void* ) i,                      // Parametros de tarea: perfil de cpu_load
+                  tskIDLE_PRIORITY+1,               // Prioridad de la tarea
+                  &carga_handles[carga_n++]         // Puntero a la tarea creada en el sistema
+              );
+
+        configASSERT( res == pdPASS );
+    }
+
+#if CARGA_CRITICA_US>0
+    res = xTaskCreate(
+              tarea_carga_critica,
+              ( const char * )"carga_critica",
+              configMINIMAL_STACK_SIZE*2,
+              NULL,
+              tskIDLE_PRIORITY+2,
+              &carga_handles[carga_n++]
+          );
+
+    configASSERT( res == pdPASS );
+#endif
+
+    res = xTaskCreate(
+              tarea_control,
+              ( const char * )"control",
+              configMINIMAL_STACK_SIZE*4,
+              NULL,
+              tskIDLE_PRIORITY+3,               /* por encima de la carga, por debajo de las tareas medidas */
+              NULL
+          );
+
+    configASSERT( res == pdPASS );
+
+    // Iniciar scheduler
+    vTaskStartScheduler();
+
+    // ---------- REPETIR POR SIEMPRE --------------------------
+    while( 1 )
+    {
+        // Si cae en este while 1 significa que no pudo iniciar el scheduler
+    }
+
+    // NO DEBE LLEGAR NUNCA AQUI, debido a que a este programa se ejecuta
+    // directamenteno sobre un microcontroladore y no es llamado por ningun
+    // Sistema Operativo, como en el caso de un programa para PC.
+    return 0;
+}
+
+/*==================[definiciones de funciones internas]=====================*/
+
+static void carga_habilitar( bool_t habilitar )
+{
+    for( uint32_t i = 0; i < carga_n; i++ )
+    {
+        if( habilitar )
+        {
+            vTaskResume( carga_handles[i] );
+        }
+        else
+        {
+            vTaskSuspend( carga_handles[i] );
+        }
+    }
+}
+
+/* tabla final: la latencia total de cada mecanismo en cada escenario, en ns */
+static void imprimir_comparacion( void )
+{
+    printf( "\r\n%-14s %-10s %7s %7s %7s %7s %8s\r\n", "mecanismo", "escenario", "min", "p50", "p99", "max", "perdidas" );
+
+    for( uint32_t m = 0; m < LAT_MECANISMOS; m++ )
+    {
+        for( uint32_t e = 0; e < ESCENARIOS; e++ )
+        {
+            const t_lat_corrida* c = &resultados[e][m];
+            const t_lat_stat* total = &c->tramo[LAT_TOTAL];
+
+            printf( "%-14s %-10s %7u %7u %7u %7u %8u\r\n", lat_bench_nombre( m ), escenarios[e],
+                    lat_ns( total->min ),
+                    lat_ns( lat_bench_percentil( total, c->muestras, 500 ) ),
+                    lat_ns( lat_bench_percentil( total, c->muestras, 990 ) ),
+                    lat_ns( total->max ), c->perdidas );
+        }
+    }
+
+    printf( "(latencia evento->tarea en ns)\r\n" );
+}
+
+/*==================[definiciones de funciones externas]=====================*/
+
+/* Corre cada mecanismo en cada escenario, imprime los resultados y vuelve a empezar */
+void tarea_control( void* taskParmPtr )
+{
+    while( 1 )
+    {
+        for( uint32_t e = 0; e < ESCENARIOS; e++ )
+        {
+            carga_habilitar( e == ESCENARIO_CON_CARGA );
+
+            for( uint32_t m = 0; m < LAT_MECANISMOS; m++ )
+            {
+                gpioWrite( LEDB, ON );
+                lat_bench_run( m, &resultados[e][m] );
+                gpioWrite( LEDB, OFF );
+
+                /* la UART imprime con la carga corriendo: no afecta a la medicion, que ya termino */
+                lat_bench_report( &resultados[e][m], escenarios[e] );
+            }
+        }
+
+        carga_habilitar( FALSE );
+        imprimir_comparacion();
+
+        vTaskDelay( PAUSA_ENTRE_CICLOS_MS / portTICK_RATE_MS );
+    }
+}
+
+/* Ocupa la CPU sin bloquearse nunca; las del mismo perfil se reparten por time slicing */
+void tarea_carga( void* taskParmPtr )
+{
+    t_cpu_load_profile perfil = ( t_cpu_load_profile )( uint32_t ) taskParmPtr;
+
+    while( 1 )
+    {
+        cpu_load_run( perfil, CARGA_RAFAGA_US );
+    }
+}
+
+#if CARGA_CRITICA_US>0
+/* Enmascara las interrupciones del kernel durante CARGA_CRITICA_US: lo que dure aparece como
+   cola en el tramo evento->isr */
+void tarea_carga_critica( void* taskParmPtr )
+{
+    while( 1 )
+    {
+        taskENTER_CRITICAL();
+        cpu_load_busy_us( CARGA_CRITICA_US );
+        taskEXIT_CRITICAL();
+
+        /* vTaskDelay y no vTaskDelayUntil: carga_habilitar la suspende durante el escenario sin
+           carga, y al reanudarla un xLastWakeTime viejo la haria correr varias veces seguidas,
+           sesgando las primeras muestras con carga */
+        vTaskDelay( CARGA_CRITICA_PERIODO / portTICK_RATE_MS );
+    }
+}
+#endif
+
+/*==================[fin del archivo]========================================*/
@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+# Copyright 2020, Franco Bucafusco
+# All rights reserved.
+#
+# Analisis de tiempo de respuesta (RTA) para planificacion con prioridades fijas y
+# desalojo, como la de FreeRTOS con configUSE_PREEMPTION = 1.
+#
+#   R = C + B + suma_{j de prioridad >= i} ceil( (R + J_j) / T_j ) * C_j
+#
+# El conjunto de tareas se describe en un JSON (ver tasksets/):
+#
+#   {
+#     "overhead_us": 10,                          costo de cambio de contexto, se suma a cada C
+#     "resources": { "mutex": { "inheritance": true } },
+#     "tasks": [
+#       { "name": "task_led1", "priority": 1, "period_ms": 1000, "wcet_ms": 0.05,
+#         "deadline_ms": 1000, "jitter_ms": 0, "critical_sections": { "mutex": 0.02 } }
+#     ]
+#   }
+#
+# deadline_ms por defecto es el periodo; para tareas esporadicas el periodo es el minimo
+# tiempo entre activaciones. Las tareas de igual prioridad se consideran interferencias
+# mutuas (time slicing de FreeRTOS), lo que es pesimista pero seguro.
+#
+# Bloqueo: los mutex de FreeRTOS usan herencia de prioridad, por lo que una tarea puede
+# quedar bloqueada a lo sumo una seccion critica por recurso (o por tarea de menor
+# prioridad, lo que sea menor). Un semaforo binario usado como mutex no hereda: el
+# bloqueo no esta acotado (inversion de prioridades, ver D5) y la tarea se informa
+# como no planificable.
+#
+# Los WCET pueden reemplazarse por tiempos medidos:
+#   --wcet archivo.txt    lineas "nombre us"
+#   --trace captura.txt   volcado de trace_rec_dump() (RTOS1_D5): se toma el maximo tiempo
+#                         de ejecucion de cada tarea entre dos bloqueos consecutivos
+#
+# uso: rta.py tasksets/ej_ex.json [--wcet archivo] [--trace captura] [--margin 1.2]
+
+import argparse
+import json
+import math
+import sys
+
+# tipos de registro de trace_rec.h que terminan un trabajo (la tarea se bloquea)
+TRACE_EV_SWITCH_IN = 1
+TRACE_EV_BLOCKING = {3, 4, 10, 11}  # TASK_DELETE, DELAY, QUEUE_BLOCK_SEND, QUEUE_BLOCK_RECEIVE
+
+
+class Task:
+    def __init__(self, d):
+        self.name = d["name"]
+        self.priority = int(d["priority"])
+        self.period = float(d["period_ms"])
+        self.wcet = float(d["wcet_ms"])
+        self.deadline = float(d.get("deadline_ms", self.period))
+        self.jitter = float(d.get("jitter_ms", 0))
+        self.cs = {r: float(t) for r, t in d.get("critical_sections", {}).items()}
+        self.measured = False
+
+
+def load_wcet_file(path):
+    wcet = {}
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) == 2 and not line.startswith("#"):
+                wcet[fields[0]] = float(fields[1]) / 1000.0
+    return wcet
+
+
+def load_wcet_trace(path):
+    """maximo tiempo de CPU de cada tarea entre dos bloqueos, a partir del volcado de trace_rec"""
+    hz = None
+    names = {}
+    records = []
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("TRACE "):
+                hz = int(line.split()[1])
+            elif line.startswith("T "):
+                _, num, name = line.split(" ", 2)
+                names[int(num)] = name
+            elif line == "END":
+                break
+            elif hz is not None and len(line) == 16:
+                records.append((int(line[0:8], 16), int(line[8:10], 16), int(line[10:12], 16)))
+
+    if hz is None:
+        sys.exit("%s: no se encontro la linea TRACE" % path)
+
+    running = None
+    since = 0
+    job = {}        # tiempo acumulado del trabajo en curso de cada tarea, en ciclos
+    worst = {}
+
+    for time, kind, a in records:
+        if kind == TRACE_EV_SWITCH_IN:
+            if running is not None:
+                job[running] = job.get(running, 0) + ((time - since) & 0xFFFFFFFF)
+            running = a
+            since = time
+        elif kind in TRACE_EV_BLOCKING and running is not None:
+            total = job.get(running, 0) + ((time - since) & 0xFFFFFFFF)
+            worst[running] = max(worst.get(running, 0), total)
+            job[running] = 0
+            since = time
+
+    return {names.get(num, str(num)): cycles * 1000.0 / hz for num, cycles in worst.items()}
+
+
+def blocking(task, tasks, resources):
+    """termino de bloqueo B por herencia de prioridad; None si no esta acotado"""
+    lower = [t for t in tasks if t.priority < task.priority]
+
+    # recursos que puede pedir una tarea de prioridad >= la analizada (techo >= prioridad)
+    shared = set()
+    for r in resources:
+        if any(t.priority >= task.priority and r in t.cs for t in tasks):
+            shared.add(r)
+
+    # sin herencia solo espera quien pide el recurso, y sin cota (inversion de prioridad);
+    # las demas tareas desalojan a la de menor prioridad que lo tiene tomado
+    for r in list(shared):
+        if not resources[r].get("inheritance", True):
+            if r in task.cs and any(r in t.cs for t in lower):
+                return None
+            shared.discard(r)
+
+    per_resource = 0.0
+    for r in shared:
+        per_resource += max([t.cs[r] for t in lower if r in t.cs], default=0.0)
+
+    per_task = 0.0
+    for t in lower:
+        per_task += max([t.cs[r] for r in shared if r in t.cs], default=0.0)
+
+    return min(per_resource, per_task)
+
+
+def response_time(task, tasks, resources, overhead, scale=1.0):
+    b = blocking(task, tasks, resources)
+    if b is None:
+        return None, None
+
+    hp = [t for t in tasks if t is not task and t.priority >= task.priority]
+    c = task.wcet * scale + overhead
+    r = c + b
+
+    while True:
+        nxt = c + b + sum(math.ceil((r + t.jitter) / t.period) * (t.wcet * scale + overhead) for t in hp)
+        if nxt == r or nxt + task.jitter > task.deadline:
+            return nxt + task.jitter, b
+        r = nxt
+
+
+def schedulable(tasks, resources, overhead, scale=1.0):
+    for t in tasks:
+        r, _ = response_time(t, tasks, resources, overhead, scale)
+        if r is None or r > t.deadline:
+            return False
+    return True
+
+
+def breakdown(tasks, resources, overhead):
+    """mayor factor por el que se pueden multiplicar todos los WCET sin perder plazos"""
+    if not schedulable(tasks, resources, overhead):
+        return None
+    lo, hi = 1.0, 2.0
+    while schedulable(tasks, resources, overhead, hi) and hi < 1e6:
+        lo, hi = hi, hi * 2
+    for _ in range(40):
+        mid = (lo + hi) / 2
+        if schedulable(tasks, resources, overhead, mid):
+            lo = mid
+        else:
+            hi = mid
+    return lo
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Analisis de tiempo de respuesta para prioridades fijas")
+    parser.add_argument("taskset")
+    parser.add_argument("--wcet", help="archivo con lineas 'nombre us' que reemplazan wcet_ms")
+    parser.add_argument("--trace", help="volcado de trace_rec_dump() del que se miden los WCET")
+    parser.add_argument("--margin", type=float, default=1.0, help="factor aplicado a los WCET medidos")
+    args = parser.parse_args()
+
+    with open(args.taskset) as f:
+        spec = json.load(f)
+
+    tasks = [Task(d) for d in spec["tasks"]]
+    resources = spec.get("resources", {})
+    overhead = float(spec.get("overhead_us", 0)) / 1000.0
+
+    for t in tasks:
+        for r in t.cs:
+            if r not in resources:
+                sys.exit("%s: recurso '%s' no declarado en resources" % (t.name, r))
+
+    measured = {}
+    if args.trace:
+        measured.update(load_wcet_trace(args.trace))
+    if args.wcet:
+        measured.update(load_wcet_file(args.wcet))
+    for t in tasks:
+        if t.name in measured:
+            t.wcet = measured[t.name] * args.margin
+            t.measured = True
+
+    tasks.sort(key=lambda t: -t.priority)
+
+    print("%-16s %4s %9s %9s  %9s %9s %9s" % ("tarea", "prio", "T(ms)", "C(ms)", "D(ms)", "B(ms)", "R(ms)"))
+    ok = True
+    for t in tasks:
+        r, b = response_time(t, tasks, resources, overhead)
+        if r is None:
+            verdict = "BLOQUEO NO ACOTADO (semaforo sin herencia)"
+            ok = False
+            print("%-16s %4d %9.3f %9.3f%s %9.3f %9s %9s  %s" % (
+                t.name, t.priority, t.period, t.wcet, "*" if t.measured else " ", t.deadline, "-", "-", verdict))
+            continue
+        verdict = "ok" if r <= t.deadline else "PIERDE PLAZO"
+        ok = ok and r <= t.deadline
+        print("%-16s %4d %9.3f %9.3f%s %9.3f %9.3f %9.3f  %s" % (
+            t.name, t.priority, t.period, t.wcet, "*" if t.measured else " ", t.deadline, b, r, verdict))
+
+    u = sum(t.wcet / t.period for t in tasks)
+    n = len(tasks)
+    print()
+    print("utilizacion %.2f %% (cota de Liu-Layland para %d tareas: %.2f %%)" % (100 * u, n, 100 * n * (2 ** (1.0 / n) - 1)))
+    if any(t.measured for t in tasks):
+        print("* WCET medido (x%.2f)" % args.margin)
+
+    factor = breakdown(tasks, resources, overhead)
+    if factor is None:
+        print("NO planificable")
+    else:
+        print("planificable: los WCET pueden crecer x%.2f (utilizacion hasta %.2f %%)" % (factor, 100 * u * factor))
+
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()